@@ -1,3 +1,4 @@
 find_package(OpenGL REQUIRED)
+find_package(Threads REQUIRED)
 include(SFML)
 include(LibVLC)
\ No newline at end of file
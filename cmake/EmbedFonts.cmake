@@ -0,0 +1,37 @@
+# Script mode: cmake -DFONT_DIR=<dir> -DOUTPUT=<file> -P EmbedFonts.cmake
+# Generates a C++ source that compiles every font in FONT_DIR into the library, see src/font_atlas.hpp.
+
+file(GLOB FONT_FILES ${FONT_DIR}/*.ttf)
+list(SORT FONT_FILES)
+
+string(REPEAT "0x..," 32 FONT_LINE_PATTERN)
+
+set(FONT_ARRAYS "")
+set(FONT_ENTRIES "")
+set(FONT_INDEX 0)
+
+foreach (FONT_FILE ${FONT_FILES})
+    get_filename_component(FONT_NAME ${FONT_FILE} NAME)
+    file(READ ${FONT_FILE} FONT_HEX HEX)
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," FONT_BYTES "${FONT_HEX}")
+    string(REGEX REPLACE "(${FONT_LINE_PATTERN})" "\\1\n" FONT_BYTES "${FONT_BYTES}")
+    string(APPEND FONT_ARRAYS "const unsigned char font_${FONT_INDEX}[] = {\n${FONT_BYTES}\n};\n\n")
+    string(APPEND FONT_ENTRIES "    uxx::detail::embedded_font { \"${FONT_NAME}\", font_${FONT_INDEX} },\n")
+    math(EXPR FONT_INDEX "${FONT_INDEX} + 1")
+endforeach ()
+
+file(WRITE ${OUTPUT}.tmp
+        "// Generated by cmake/EmbedFonts.cmake, do not edit\n"
+        "#include \"font_atlas.hpp\"\n\n"
+        "#include <array>\n\n"
+        "namespace {\n\n"
+        "${FONT_ARRAYS}"
+        "const std::array<uxx::detail::embedded_font, ${FONT_INDEX}> EMBEDDED_FONTS {\n"
+        "${FONT_ENTRIES}"
+        "};\n\n"
+        "}\n\n"
+        "std::span<const uxx::detail::embedded_font> uxx::detail::get_embedded_fonts() noexcept\n"
+        "{\n"
+        "    return EMBEDDED_FONTS;\n"
+        "}\n")
+file(RENAME ${OUTPUT}.tmp ${OUTPUT})
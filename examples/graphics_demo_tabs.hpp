@@ -0,0 +1,21 @@
+#ifndef _UXX_GRAPHICS_DEMO_TABS_HPP
+#define _UXX_GRAPHICS_DEMO_TABS_HPP
+
+#include <uxx/uxx.hpp>
+
+#include <span>
+
+struct graphics_demo_tab {
+    const char* label;
+    void (*show)(uxx::pane&);
+    // Draws OpenGL textures, which the software renderer doesn't sample
+    bool uses_textures;
+};
+
+/// \return Tabs of the demo window, in the order they are shown.
+std::span<const graphics_demo_tab> get_graphics_demo_tabs() noexcept;
+
+/// Show the demo window with all of its tabs.
+void show_draw_primitives_window(uxx::screen& screen);
+
+#endif
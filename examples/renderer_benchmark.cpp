@@ -0,0 +1,145 @@
+#include <uxx/uxx.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <math.h>
+#include <string>
+#include <vector>
+
+// Enough lines to stay below the 64k vertices a window may have with 16-bit indices and the legacy renderer
+static constexpr int LINES_PER_CANVAS = 5000;
+static constexpr int CANVAS_COUNT = 6;
+static constexpr uxx::vec2d CANVAS_SIZE { 300.0f, 200.0f };
+// Needs 32-bit indices (UXX_32BIT_INDICES) to be drawn with a single command
+static constexpr std::size_t POLYLINE_POINTS = 300000;
+static constexpr uxx::vec2d PLOT_SIZE { 1200.0f, 600.0f };
+
+static void draw_waves(uxx::canvas& canvas, uxx::pencil& pencil, const float time)
+{
+    const auto p0 = canvas.get_position();
+    pencil.set_color(uxx::rgba_color::from_integers(0, 200, 255, 128));
+    pencil.set_thickness(1.5f);
+
+    for (int i = 0; i < LINES_PER_CANVAS; ++i) {
+        const float t = static_cast<float>(i) / static_cast<float>(LINES_PER_CANVAS);
+        const float x = p0.x + t * CANVAS_SIZE.x;
+        const float y = p0.y + CANVAS_SIZE.y * 0.5f * (1.0f + sinf(time + t * 40.0f));
+        pencil.draw_line({ x, y }, { x + 2.0f, p0.y + CANVAS_SIZE.y - y + p0.y });
+    }
+}
+
+static const std::vector<uxx::vec2d>& update_plot_points(const uxx::vec2d& p0, const float time)
+{
+    static std::vector<uxx::vec2d> points(POLYLINE_POINTS);
+
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        const float t = static_cast<float>(i) / static_cast<float>(points.size());
+        points[i] = { p0.x + t * PLOT_SIZE.x, p0.y + PLOT_SIZE.y * 0.5f * (1.0f + sinf(time + t * 400.0f)) };
+    }
+    return points;
+}
+
+static void draw_plot(uxx::canvas& canvas, uxx::pencil& pencil, const float time)
+{
+    const auto& points = update_plot_points(canvas.get_position(), time);
+    pencil.set_color(uxx::rgba_color::from_integers(255, 200, 0, 255));
+    pencil.draw_polyline(points, false);
+}
+
+// The same wave as update_plot_points(), as samples of a time series that starts at 1.7e9 seconds
+static const std::vector<uxx::plot_sample>& update_plot_samples(const float time)
+{
+    static std::vector<uxx::plot_sample> samples(POLYLINE_POINTS);
+
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        const float t = static_cast<float>(i) / static_cast<float>(samples.size());
+        samples[i] = { 1.7e9 + static_cast<double>(i) * 0.01, sinf(time + t * 400.0f) };
+    }
+    return samples;
+}
+
+static void draw_plot_lod(uxx::canvas& canvas, uxx::pencil& pencil, const float time)
+{
+    const auto p0 = canvas.get_position();
+    const auto& samples = update_plot_samples(time);
+    const uxx::plot_view view { samples.front().x, samples.back().x, -1.0f, 1.0f, { p0, { p0.x + PLOT_SIZE.x, p0.y + PLOT_SIZE.y } } };
+    pencil.set_color(uxx::rgba_color::from_integers(255, 200, 0, 255));
+    pencil.draw_polyline_lod(samples, view);
+}
+
+static void show_waves(uxx::screen& screen, const float time)
+{
+    for (int n = 0; n < CANVAS_COUNT; ++n) {
+        const auto title = "Canvas " + std::to_string(n);
+        screen.window(title, [time](uxx::pane& pane) {
+            pane.canvas(uxx::id("waves"), CANVAS_SIZE, draw_waves, time);
+        });
+    }
+}
+
+static void show_plot(uxx::screen& screen, const float time)
+{
+    screen.window("Plot", [time](uxx::pane& pane) {
+        pane.canvas(uxx::id("plot"), PLOT_SIZE, draw_plot, time);
+    });
+}
+
+static void show_plot_lod(uxx::screen& screen, const float time)
+{
+    screen.window("Plot", [time](uxx::pane& pane) {
+        pane.canvas(uxx::id("plot"), PLOT_SIZE, draw_plot_lod, time);
+    });
+}
+
+static double to_milliseconds(const std::chrono::nanoseconds duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+static int run_benchmark(const char* name, const uxx::app::renderer renderer, const std::uint64_t frame_count, void (*show)(uxx::screen&, float))
+{
+    uxx::app app { renderer };
+    app.set_width(1280);
+    app.set_height(720);
+    std::uint64_t frame = 0;
+
+    const auto exit_code = app.run_headless(uxx::app::headless::frames(frame_count), [&frame, show](uxx::screen& screen) {
+        show(screen, static_cast<float>(frame++) * 0.01f);
+    });
+    const auto& stats = app.get_frame_stats();
+    const auto frame_summary = stats.get_frame_summary();
+    const auto render_summary = stats.get_summary(uxx::app::frame_phase::render);
+    const auto counters = app.get_last_frame_report().counters;
+
+    std::printf("%-14s frame avg %.3f ms, p99 %.3f ms | render avg %.3f ms, p99 %.3f ms | %zu vertices, %zu draw commands\n",
+        name,
+        to_milliseconds(frame_summary.avg), to_milliseconds(frame_summary.p99),
+        to_milliseconds(render_summary.avg), to_milliseconds(render_summary.p99),
+        counters.vertices, counters.draw_commands);
+    return exit_code;
+}
+
+// Usage: uxx_renderer_benchmark [frames]
+// Renders vertex-heavy canvases offscreen with every renderer and compares their frame times.
+// The plot compares draw command counts, run it from builds with and without -DUXX_32BIT_INDICES=ON.
+int main(int argc, char** argv)
+{
+    const std::vector<std::string> args(argv + 1, argv + argc);
+    const std::uint64_t frame_count = args.empty() ? 1000 : std::stoull(args[0]);
+
+    if (const auto exit_code = run_benchmark("waves legacy", uxx::app::renderer::legacy, frame_count, show_waves); exit_code != 0) {
+        return exit_code;
+    }
+    if (const auto exit_code = run_benchmark("waves gl3", uxx::app::renderer::gl3, frame_count, show_waves); exit_code != 0) {
+        return exit_code;
+    }
+    if (const auto exit_code = run_benchmark("waves software", uxx::app::renderer::software, frame_count, show_waves); exit_code != 0) {
+        return exit_code;
+    }
+    // Only the gl3 renderer can draw more than 64k vertices per window with 16-bit indices
+    if (const auto exit_code = run_benchmark("plot gl3", uxx::app::renderer::gl3, frame_count, show_plot); exit_code != 0) {
+        return exit_code;
+    }
+    // The same plot reduced to a few points per pixel column
+    return run_benchmark("plot lod gl3", uxx::app::renderer::gl3, frame_count, show_plot_lod);
+}
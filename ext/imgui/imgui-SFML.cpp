@@ -17,6 +17,7 @@
 #include <cassert>
 #include <cmath>    // abs
 #include <cstddef>  // offsetof, NULL
+#include <climits>  // UINT_MAX
 #include <cstring>  // memcpy
 
 #ifdef ANDROID
@@ -116,11 +117,30 @@ static_assert(sizeof(GLuint) <= sizeof(ImTextureID),
 
 namespace {
 // data
-static bool s_windowHasFocus = false;
-static bool s_mousePressed[3] = {false, false, false};
-static bool s_touchDown[3] = {false, false, false};
-static bool s_mouseMoved = false;
-static sf::Vector2i s_touchPos;
+// input state of one window, owned by its ImGui context through
+// io.BackendPlatformUserData so that several windows can be driven at once
+struct WindowState {
+    bool windowHasFocus;
+    bool mousePressed[3];
+    bool mouseHeld[3];  // from events only
+    bool readInputDevices;
+    bool touchDown[3];
+    bool mouseMoved;
+    sf::Vector2i touchPos;
+
+    WindowState()
+        : windowHasFocus(false), readInputDevices(true), mouseMoved(false) {
+        for (unsigned int i = 0; i < 3; i++) {
+            mousePressed[i] = mouseHeld[i] = touchDown[i] = false;
+        }
+    }
+};
+
+WindowState& getWindowState() {
+    return *static_cast<WindowState*>(ImGui::GetIO().BackendPlatformUserData);
+}
+
+static unsigned int s_contextCount = 0;  // contexts sharing the resources below
 static sf::Texture* s_fontTexture =
     NULL;  // owning pointer to internal font atlas which is used if user
            // doesn't set custom sf::Texture.
@@ -179,10 +199,14 @@ std::string s_clipboardText;
 // mouse cursors
 void loadMouseCursor(ImGuiMouseCursor imguiCursorType,
                      sf::Cursor::Type sfmlCursorType);
+void loadMouseCursors();
 void updateMouseCursor(sf::Window& window);
 
 sf::Cursor* s_mouseCursors[ImGuiMouseCursor_COUNT];
 bool s_mouseCursorLoaded[ImGuiMouseCursor_COUNT];
+// cursors are loaded when a window first needs them, windowless contexts
+// never touch the display
+bool s_mouseCursorsLoaded = false;
 
 }  // namespace
 
@@ -198,6 +222,13 @@ void Init(sf::Window& window, sf::RenderTarget& target, bool loadDefaultFont) {
 }
 
 void Init(sf::Window& window, const sf::Vector2f& displaySize, bool loadDefaultFont) {
+    Init(displaySize, loadDefaultFont);
+    getWindowState().windowHasFocus = window.hasFocus();
+}
+
+namespace {
+void initContext(const sf::Vector2f& displaySize,
+                 ImFontAtlas* sharedFontAtlas) {
 #if __cplusplus < 201103L  // runtime assert when using earlier than C++11 as no
                            // static_assert support
     assert(
@@ -205,13 +236,16 @@ void Init(sf::Window& window, const sf::Vector2f& displaySize, bool loadDefaultF
         sizeof(ImTextureID));  // ImTextureID is not large enough to fit GLuint.
 #endif
 
-    ImGui::CreateContext();
+    ImGui::SetCurrentContext(ImGui::CreateContext(sharedFontAtlas));
     ImGuiIO& io = ImGui::GetIO();
+    io.BackendPlatformUserData = new WindowState();
 
     // tell ImGui which features we support
     io.BackendFlags |= ImGuiBackendFlags_HasGamepad;
     io.BackendFlags |= ImGuiBackendFlags_HasMouseCursors;
     io.BackendFlags |= ImGuiBackendFlags_HasSetMousePos;
+    // draw lists of more than 64k vertices are split at vertex offsets
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
     io.BackendPlatformName = "imgui_impl_sfml";
 
     // init keyboard mapping
@@ -256,59 +290,60 @@ void Init(sf::Window& window, const sf::Vector2f& displaySize, bool loadDefaultF
     io.SetClipboardTextFn = setClipboardText;
     io.GetClipboardTextFn = getClipboadText;
 
-    // load mouse cursors
-    for (int i = 0; i < ImGuiMouseCursor_COUNT; ++i) {
-        s_mouseCursorLoaded[i] = false;
-    }
+    ++s_contextCount;  // cursors and the font texture are shared
+}
+}  // namespace
 
-    loadMouseCursor(ImGuiMouseCursor_Arrow, sf::Cursor::Arrow);
-    loadMouseCursor(ImGuiMouseCursor_TextInput, sf::Cursor::Text);
-    loadMouseCursor(ImGuiMouseCursor_ResizeAll, sf::Cursor::SizeAll);
-    loadMouseCursor(ImGuiMouseCursor_ResizeNS, sf::Cursor::SizeVertical);
-    loadMouseCursor(ImGuiMouseCursor_ResizeEW, sf::Cursor::SizeHorizontal);
-    loadMouseCursor(ImGuiMouseCursor_ResizeNESW,
-                    sf::Cursor::SizeBottomLeftTopRight);
-    loadMouseCursor(ImGuiMouseCursor_ResizeNWSE,
-                    sf::Cursor::SizeTopLeftBottomRight);
-    loadMouseCursor(ImGuiMouseCursor_Hand, sf::Cursor::Hand);
+void Init(const sf::Vector2f& displaySize, bool loadDefaultFont) {
+    initContext(displaySize, NULL);
 
     if (s_fontTexture) {  // delete previously created texture
         delete s_fontTexture;
+        s_fontTexture = NULL;
     }
-    s_fontTexture = new sf::Texture;
 
     if (loadDefaultFont) {
         // this will load default font automatically
         // No need to call AddDefaultFont
         UpdateFontTexture();
     }
+}
 
-    s_windowHasFocus = window.hasFocus();
+void Init(sf::RenderWindow& window, ImFontAtlas* sharedFontAtlas) {
+    initContext(static_cast<sf::Vector2f>(window.getSize()), sharedFontAtlas);
+    getWindowState().windowHasFocus = window.hasFocus();
+}
+
+void SetInputDevicesEnabled(bool enabled) {
+    getWindowState().readInputDevices = enabled;
 }
 
 void ProcessEvent(const sf::Event& event) {
-    if (s_windowHasFocus) {
+    WindowState& state = getWindowState();
+    if (state.windowHasFocus) {
         ImGuiIO& io = ImGui::GetIO();
 
         switch (event.type) {
             case sf::Event::MouseMoved:
-                s_mouseMoved = true;
+                state.mouseMoved = true;
                 break;
             case sf::Event::MouseButtonPressed:  // fall-through
             case sf::Event::MouseButtonReleased: {
                 int button = event.mouseButton.button;
-                if (event.type == sf::Event::MouseButtonPressed &&
-                    button >= 0 && button < 3) {
-                    s_mousePressed[event.mouseButton.button] = true;
+                if (button >= 0 && button < 3) {
+                    const bool pressed =
+                        event.type == sf::Event::MouseButtonPressed;
+                    state.mousePressed[button] |= pressed;
+                    state.mouseHeld[button] = pressed;
                 }
             } break;
             case sf::Event::TouchBegan:  // fall-through
             case sf::Event::TouchEnded: {
-                s_mouseMoved = false;
+                state.mouseMoved = false;
                 int button = event.touch.finger;
                 if (event.type == sf::Event::TouchBegan && button >= 0 &&
                     button < 3) {
-                    s_touchDown[event.touch.finger] = true;
+                    state.touchDown[event.touch.finger] = true;
                 }
             } break;
             case sf::Event::MouseWheelScrolled:
@@ -351,10 +386,10 @@ void ProcessEvent(const sf::Event& event) {
 
     switch (event.type) {
         case sf::Event::LostFocus:
-            s_windowHasFocus = false;
+            state.windowHasFocus = false;
             break;
         case sf::Event::GainedFocus:
-            s_windowHasFocus = true;
+            state.windowHasFocus = true;
             break;
         default:
             break;
@@ -366,14 +401,16 @@ void Update(sf::RenderWindow& window, sf::Time dt) {
 }
 
 void Update(sf::Window& window, sf::RenderTarget& target, sf::Time dt) {
+    WindowState& state = getWindowState();
     // Update OS/hardware mouse cursor if imgui isn't drawing a software cursor
     updateMouseCursor(window);
 
-    if (!s_mouseMoved) {
+    if (!state.mouseMoved) {
         if (sf::Touch::isDown(0))
-            s_touchPos = sf::Touch::getPosition(0, window);
+            state.touchPos = sf::Touch::getPosition(0, window);
 
-        Update(s_touchPos, static_cast<sf::Vector2f>(target.getSize()), dt);
+        Update(state.touchPos, static_cast<sf::Vector2f>(target.getSize()),
+               dt);
     } else {
         Update(sf::Mouse::getPosition(window),
                static_cast<sf::Vector2f>(target.getSize()), dt);
@@ -387,13 +424,14 @@ void Update(sf::Window& window, sf::RenderTarget& target, sf::Time dt) {
 
 void Update(const sf::Vector2i& mousePos, const sf::Vector2f& displaySize,
             sf::Time dt) {
+    WindowState& state = getWindowState();
     ImGuiIO& io = ImGui::GetIO();
     io.DisplaySize = ImVec2(displaySize.x, displaySize.y);
     
     io.DeltaTime = dt.asSeconds();
 
-    if (s_windowHasFocus) {
-        if (io.WantSetMousePos) {
+    if (state.windowHasFocus) {
+        if (io.WantSetMousePos && state.readInputDevices) {
             sf::Vector2i mousePos(static_cast<int>(io.MousePos.x),
                                   static_cast<int>(io.MousePos.y));
             sf::Mouse::setPosition(mousePos);
@@ -401,11 +439,15 @@ void Update(const sf::Vector2i& mousePos, const sf::Vector2f& displaySize,
             io.MousePos = ImVec2(mousePos.x, mousePos.y);
         }
         for (unsigned int i = 0; i < 3; i++) {
-            io.MouseDown[i] = s_touchDown[i] || sf::Touch::isDown(i) ||
-                              s_mousePressed[i] ||
-                              sf::Mouse::isButtonPressed((sf::Mouse::Button)i);
-            s_mousePressed[i] = false;
-            s_touchDown[i] = false;
+            const bool deviceDown =
+                state.readInputDevices
+                    ? sf::Touch::isDown(i) ||
+                          sf::Mouse::isButtonPressed((sf::Mouse::Button)i)
+                    : state.mouseHeld[i];
+            io.MouseDown[i] =
+                state.touchDown[i] || state.mousePressed[i] || deviceDown;
+            state.mousePressed[i] = false;
+            state.touchDown[i] = false;
         }
     }
 
@@ -468,8 +510,23 @@ void Render() {
     RenderDrawLists(ImGui::GetDrawData());
 }
 
+void RenderDrawData(sf::RenderTarget& target, ImDrawData* drawData) {
+    target.resetGLStates();
+    RenderDrawLists(drawData);
+}
+
 void Shutdown() {
-    ImGui::GetIO().Fonts->TexID = (ImTextureID)NULL;
+    ImGuiIO& io = ImGui::GetIO();
+    delete static_cast<WindowState*>(io.BackendPlatformUserData);
+    io.BackendPlatformUserData = NULL;
+
+    if (s_contextCount > 0 && --s_contextCount > 0) {
+        // the font texture and cursors are still used by another context
+        ImGui::DestroyContext();
+        return;
+    }
+
+    io.Fonts->TexID = (ImTextureID)NULL;
 
     if (s_fontTexture) {  // if internal texture was created, we delete it
         delete s_fontTexture;
@@ -484,6 +541,7 @@ void Shutdown() {
             s_mouseCursorLoaded[i] = false;
         }
     }
+    s_mouseCursorsLoaded = false;
 
     ImGui::DestroyContext();
 }
@@ -495,6 +553,9 @@ void UpdateFontTexture() {
 
     io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
 
+    if (!s_fontTexture) {  // created on first use, a texture needs an OpenGL context
+        s_fontTexture = new sf::Texture;
+    }
     sf::Texture& texture = *s_fontTexture;
     texture.create(width, height);
     texture.update(pixels);
@@ -699,25 +760,23 @@ GLuint convertImTextureIDToGLTextureHandle(ImTextureID textureID) {
 }
 
 // Rendering callback
+// Only reads the draw data, never the ImGui context, so that a copy of the
+// draw data can be drawn on another thread while the context builds the next
+// frame
 void RenderDrawLists(ImDrawData* draw_data) {
-    ImGui::GetDrawData();
     if (draw_data->CmdListsCount == 0) {
         return;
     }
 
-    ImGuiIO& io = ImGui::GetIO();
-    assert(io.Fonts->TexID !=
-           (ImTextureID)NULL);  // You forgot to create and set font texture
-
     // scale stuff (needed for proper handling of window resize)
-    int fb_width =
-        static_cast<int>(io.DisplaySize.x * io.DisplayFramebufferScale.x);
-    int fb_height =
-        static_cast<int>(io.DisplaySize.y * io.DisplayFramebufferScale.y);
+    const ImVec2 display_pos = draw_data->DisplayPos;
+    const ImVec2 display_size = draw_data->DisplaySize;
+    const ImVec2 scale = draw_data->FramebufferScale;
+    int fb_width = static_cast<int>(display_size.x * scale.x);
+    int fb_height = static_cast<int>(display_size.y * scale.y);
     if (fb_width == 0 || fb_height == 0) {
         return;
     }
-    draw_data->ScaleClipRects(io.DisplayFramebufferScale);
 
 #ifdef GL_VERSION_ES_CL_1_1
     GLint last_program, last_texture, last_array_buffer,
@@ -749,9 +808,11 @@ void RenderDrawLists(ImDrawData* draw_data) {
     glLoadIdentity();
 
 #ifdef GL_VERSION_ES_CL_1_1
-    glOrthof(0.0f, io.DisplaySize.x, io.DisplaySize.y, 0.0f, -1.0f, +1.0f);
+    glOrthof(display_pos.x, display_pos.x + display_size.x,
+             display_pos.y + display_size.y, display_pos.y, -1.0f, +1.0f);
 #else
-    glOrtho(0.0f, io.DisplaySize.x, io.DisplaySize.y, 0.0f, -1.0f, +1.0f);
+    glOrtho(display_pos.x, display_pos.x + display_size.x,
+            display_pos.y + display_size.y, display_pos.y, -1.0f, +1.0f);
 #endif
 
     glMatrixMode(GL_MODELVIEW);
@@ -762,30 +823,43 @@ void RenderDrawLists(ImDrawData* draw_data) {
         const unsigned char* vtx_buffer =
             (const unsigned char*)&cmd_list->VtxBuffer.front();
         const ImDrawIdx* idx_buffer = &cmd_list->IdxBuffer.front();
-
-        glVertexPointer(2, GL_FLOAT, sizeof(ImDrawVert),
-                        (void*)(vtx_buffer + offsetof(ImDrawVert, pos)));
-        glTexCoordPointer(2, GL_FLOAT, sizeof(ImDrawVert),
-                          (void*)(vtx_buffer + offsetof(ImDrawVert, uv)));
-        glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(ImDrawVert),
-                       (void*)(vtx_buffer + offsetof(ImDrawVert, col)));
+        unsigned int bound_vtx_offset = UINT_MAX;
 
         for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.size(); ++cmd_i) {
             const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
             if (pcmd->UserCallback) {
                 pcmd->UserCallback(cmd_list, pcmd);
-            } else {
+            } else if (pcmd->ClipRect.z > pcmd->ClipRect.x &&
+                       pcmd->ClipRect.w > pcmd->ClipRect.y) {
+                // indices count from the vertex offset of their command
+                if (pcmd->VtxOffset != bound_vtx_offset) {
+                    const unsigned char* vtx =
+                        vtx_buffer + pcmd->VtxOffset * sizeof(ImDrawVert);
+                    glVertexPointer(2, GL_FLOAT, sizeof(ImDrawVert),
+                                    (void*)(vtx + offsetof(ImDrawVert, pos)));
+                    glTexCoordPointer(2, GL_FLOAT, sizeof(ImDrawVert),
+                                      (void*)(vtx + offsetof(ImDrawVert, uv)));
+                    glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(ImDrawVert),
+                                   (void*)(vtx + offsetof(ImDrawVert, col)));
+                    bound_vtx_offset = pcmd->VtxOffset;
+                }
                 GLuint textureHandle =
                     convertImTextureIDToGLTextureHandle(pcmd->TextureId);
                 glBindTexture(GL_TEXTURE_2D, textureHandle);
-                glScissor((int)pcmd->ClipRect.x,
-                          (int)(fb_height - pcmd->ClipRect.w),
-                          (int)(pcmd->ClipRect.z - pcmd->ClipRect.x),
-                          (int)(pcmd->ClipRect.w - pcmd->ClipRect.y));
+                // clip rectangles are in display space, the scissor box in
+                // framebuffer pixels from the bottom left
+                ImVec4 clip_rect((pcmd->ClipRect.x - display_pos.x) * scale.x,
+                                 (pcmd->ClipRect.y - display_pos.y) * scale.y,
+                                 (pcmd->ClipRect.z - display_pos.x) * scale.x,
+                                 (pcmd->ClipRect.w - display_pos.y) * scale.y);
+                glScissor((int)clip_rect.x, (int)(fb_height - clip_rect.w),
+                          (int)(clip_rect.z - clip_rect.x),
+                          (int)(clip_rect.w - clip_rect.y));
                 glDrawElements(GL_TRIANGLES, (GLsizei)pcmd->ElemCount,
-                               GL_UNSIGNED_SHORT, idx_buffer);
+                               sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT
+                                                      : GL_UNSIGNED_INT,
+                               idx_buffer + pcmd->IdxOffset);
             }
-            idx_buffer += pcmd->ElemCount;
         }
     }
 #ifdef GL_VERSION_ES_CL_1_1
@@ -917,7 +991,28 @@ void loadMouseCursor(ImGuiMouseCursor imguiCursorType,
         s_mouseCursors[imguiCursorType]->loadFromSystem(sfmlCursorType);
 }
 
+void loadMouseCursors() {
+    for (int i = 0; i < ImGuiMouseCursor_COUNT; ++i) {
+        s_mouseCursorLoaded[i] = false;
+    }
+    s_mouseCursorsLoaded = true;
+
+    loadMouseCursor(ImGuiMouseCursor_Arrow, sf::Cursor::Arrow);
+    loadMouseCursor(ImGuiMouseCursor_TextInput, sf::Cursor::Text);
+    loadMouseCursor(ImGuiMouseCursor_ResizeAll, sf::Cursor::SizeAll);
+    loadMouseCursor(ImGuiMouseCursor_ResizeNS, sf::Cursor::SizeVertical);
+    loadMouseCursor(ImGuiMouseCursor_ResizeEW, sf::Cursor::SizeHorizontal);
+    loadMouseCursor(ImGuiMouseCursor_ResizeNESW,
+                    sf::Cursor::SizeBottomLeftTopRight);
+    loadMouseCursor(ImGuiMouseCursor_ResizeNWSE,
+                    sf::Cursor::SizeTopLeftBottomRight);
+    loadMouseCursor(ImGuiMouseCursor_Hand, sf::Cursor::Hand);
+}
+
 void updateMouseCursor(sf::Window& window) {
+    if (!s_mouseCursorsLoaded) {
+        loadMouseCursors();
+    }
     ImGuiIO& io = ImGui::GetIO();
     if ((io.ConfigFlags & ImGuiConfigFlags_NoMouseCursorChange) == 0) {
         ImGuiMouseCursor cursor = ImGui::GetMouseCursor();
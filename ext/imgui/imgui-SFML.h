@@ -9,6 +9,9 @@
 
 #include "imgui-SFML_export.h"
 
+struct ImDrawData;
+struct ImFontAtlas;
+
 namespace sf
 {
     class Event;
@@ -26,8 +29,16 @@ namespace ImGui
         IMGUI_SFML_API void Init(sf::RenderWindow& window, bool loadDefaultFont = true);
         IMGUI_SFML_API void Init(sf::Window& window, sf::RenderTarget& target, bool loadDefaultFont = true);
         IMGUI_SFML_API void Init(sf::Window& window, const sf::Vector2f& displaySize, bool loadDefaultFont = true);
+        // windowless init for offscreen rendering, no input device is read until focus is gained
+        IMGUI_SFML_API void Init(const sf::Vector2f& displaySize, bool loadDefaultFont = true);
+        // creates another context for a second window that reuses the font texture of a
+        // context created earlier, which must be shut down last
+        IMGUI_SFML_API void Init(sf::RenderWindow& window, ImFontAtlas* sharedFontAtlas);
 
         IMGUI_SFML_API void ProcessEvent(const sf::Event& event);
+        // when disabled, mouse buttons are only tracked from events and the
+        // OS cursor is never moved, e.g. when replaying recorded input
+        IMGUI_SFML_API void SetInputDevicesEnabled(bool enabled);
 
         IMGUI_SFML_API void Update(sf::RenderWindow& window, sf::Time dt);
         IMGUI_SFML_API void Update(sf::Window& window, sf::RenderTarget& target, sf::Time dt);
@@ -35,6 +46,8 @@ namespace ImGui
 
         IMGUI_SFML_API void Render(sf::RenderTarget& target);
         IMGUI_SFML_API void Render();
+        // draws data that ImGui::Render() has already produced, e.g. to inspect it before drawing
+        IMGUI_SFML_API void RenderDrawData(sf::RenderTarget& target, ImDrawData* drawData);
 
         IMGUI_SFML_API void Shutdown();
 
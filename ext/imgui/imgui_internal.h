@@ -554,6 +554,9 @@ struct IMGUI_API ImDrawListSharedData
     ImU8            CircleSegmentCounts[64];    // Precomputed segment count for given radius (array index + 1) before we calculate it dynamically (to avoid calculation overhead)
     const ImVec4*   TexUvLines;                 // UV of anti-aliased lines in the atlas
 
+    // [Internal] Scratch space for AddPolyline() and AddConvexPolyFilled(), replaces alloca()
+    mutable ImVector<ImVec2> TempBuffer;
+
     ImDrawListSharedData();
     void SetCircleSegmentMaxError(float max_error);
 };
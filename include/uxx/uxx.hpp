@@ -2,11 +2,15 @@
 #define _UXX_HPP
 
 #include <any>
+#include <array>
+#include <chrono>
 #include <concepts>
+#include <cstdint>
 #include <filesystem>
 #include <functional>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
 #include <type_traits>
 #include <vector>
@@ -188,6 +192,51 @@ struct color_rect {
     rgba_color bottom_left;
 };
 
+/// Line segment, see uxx::pencil::draw_lines()
+struct segment {
+    vec2d from;
+    vec2d to;
+};
+
+/// Axis aligned rectangle, see uxx::pencil::draw_rects_filled()
+struct rect {
+    vec2d min;
+    vec2d max;
+};
+
+/// Sample of a time series, see uxx::pencil::draw_polyline_lod(). The x-coordinate, e.g. a timestamp in seconds,
+/// is a double so that it keeps its resolution far from zero.
+struct plot_sample {
+    double x;
+    float y;
+};
+
+/// Where a plot shows its samples: x from min_x to max_x across the screen rectangle from left to right,
+/// y from min_y to max_y from the bottom of the rectangle to the top.
+struct plot_view {
+    double min_x;
+    double max_x;
+    float min_y;
+    float max_y;
+    rect screen;
+};
+
+/// Points whose coordinates are spread over memory, e.g. members of an array of structs or two separate arrays.
+/// The coordinates of point i are the floats at byte offset i * stride from x and from y.
+struct strided_points {
+    const float* x;
+    const float* y;
+    std::size_t count;
+    std::size_t stride;
+};
+
+/// See uxx::pencil::draw_triangles_filled()
+struct triangle {
+    vec2d p1;
+    vec2d p2;
+    vec2d p3;
+};
+
 namespace tags {
     struct radius {
     };
@@ -229,6 +278,32 @@ using width = explicit_arg<float, tags::width>;
 /// Explicit height type
 using height = explicit_arg<float, tags::width>;
 
+/// Measures the lifetime of a scope and records it as a trace event while a trace is running.
+/// When no trace is running the cost is a single flag check.
+class UXX_EXPORT trace_scope {
+public:
+    explicit trace_scope(string_ref name) noexcept;
+    ~trace_scope() noexcept;
+
+    trace_scope(const trace_scope&) = delete;
+    trace_scope(trace_scope&&) = delete;
+    trace_scope& operator=(const trace_scope&) = delete;
+    trace_scope& operator=(trace_scope&&) = delete;
+
+    /// Start recording trace events, discarding events of an unfinished trace.
+    /// \param file Destination of the trace written by stop()
+    static void start(const std::filesystem::path& file);
+    /// Stop recording and write the events as Chrome trace JSON (viewable in chrome://tracing or Perfetto).
+    /// Does nothing when no trace is running.
+    static void stop();
+    /// \return True while a trace is running.
+    [[nodiscard]] static bool is_enabled() noexcept;
+
+private:
+    string_ref _name;
+    std::int64_t _start;
+};
+
 class image {
     friend class pane;
 
@@ -287,8 +362,14 @@ private:
     std::pair<uxx::width, uxx::height> get_resolution() const;
 };
 
+class drawing;
+
+/// Draws shapes into a window, a canvas or the background and foreground of the application.
+/// Shapes that lie entirely outside the current clip rectangle are left out before they are tessellated,
+/// see app::frame_counters::culled_primitives.
 class pencil {
     friend class pane;
+    friend class drawing;
 
 public:
     enum type {
@@ -342,11 +423,38 @@ public:
     UXX_EXPORT void draw_circle_filled(const vec2d& center, uxx::radius radius, int num_segments) const;
     UXX_EXPORT void draw_ngon(const vec2d& center, uxx::radius radius, int num_segments) const;
     UXX_EXPORT void draw_ngon_filled(const vec2d& center, uxx::radius radius, int num_segments) const;
-    UXX_EXPORT void draw_polyline(const std::vector<vec2d>& points, bool closed) const;
-    UXX_EXPORT void draw_convex_poly_filled(const std::vector<vec2d>& points) const;
+    /// The points are passed on to ImGui as they are, without a copy.
+    UXX_EXPORT void draw_polyline(std::span<const vec2d> points, bool closed) const;
+    /// Draw as many points as the shorter of the coordinate spans holds.
+    UXX_EXPORT void draw_polyline(std::span<const float> x, std::span<const float> y, bool closed) const;
+    UXX_EXPORT void draw_polyline(const strided_points& points, bool closed) const;
+    /// Draw a time series too dense to draw point by point, e.g. a day of samples across a plot.
+    /// The samples must be sorted by x. Only those in the x-range of the view are looked at, and they are reduced to
+    /// the first, lowest, highest and last one of every pixel column before they are mapped to the screen, which draws
+    /// the same pixels with at most four points per column.
+    UXX_EXPORT void draw_polyline_lod(std::span<const plot_sample> samples, const plot_view& view) const;
+    /// The points are passed on to ImGui as they are, without a copy.
+    UXX_EXPORT void draw_convex_poly_filled(std::span<const vec2d> points) const;
+    /// Draw as many points as the shorter of the coordinate spans holds.
+    UXX_EXPORT void draw_convex_poly_filled(std::span<const float> x, std::span<const float> y) const;
+    UXX_EXPORT void draw_convex_poly_filled(const strided_points& points) const;
     UXX_EXPORT void draw_bezier_curve(const vec2d& p1, const vec2d& p2, const vec2d& p3, const vec2d& p4) const;
     UXX_EXPORT void draw_bezier_curve(const vec2d& p1, const vec2d& p2, const vec2d& p3, const vec2d& p4, int num_segments) const;
 
+    /// Draw many lines at once, like draw_line() for every segment but with the geometry of all of them reserved up front.
+    UXX_EXPORT void draw_lines(std::span<const segment> segments) const;
+    /// Draw many filled rectangles at once, like draw_rect_filled() for every rectangle.
+    UXX_EXPORT void draw_rects_filled(std::span<const rect> rects) const;
+    /// Draw many filled triangles at once, like draw_triangle_filled() for every triangle.
+    UXX_EXPORT void draw_triangles_filled(std::span<const triangle> triangles) const;
+
+    /// Draw what was recorded into a drawing, without tessellating it again.
+    /// Parts outside the clip rectangle are left out in chunks of up to 64k vertices.
+    UXX_EXPORT void draw(const drawing& d) const;
+    /// Draw what was recorded into a drawing with every point scaled and then translated.
+    /// Lines and anti-aliased edges are scaled along with the points.
+    UXX_EXPORT void draw(const drawing& d, const vec2d& translation, float scale = 1.0f) const;
+
     // TODO: Draw text, images...
 
     template <typename F, typename... Args>
@@ -366,11 +474,50 @@ private:
 
     explicit pencil() noexcept;
     explicit pencil(type pencil_type) noexcept;
+    explicit pencil(std::any draw_list) noexcept;
 
     UXX_EXPORT void push_clip_rect(const vec2d& min, const vec2d& max, const bool intersect_with_current_clip_rect) const;
     UXX_EXPORT void pop_clip_rect() const;
 };
 
+/// Pencil commands recorded once and drawn every frame with uxx::pencil::draw(), without tessellating them again.
+/// Meant for content that rarely changes, such as schematics or axis frames, recorded again when it does.
+class drawing {
+    friend class pencil;
+
+public:
+    UXX_EXPORT drawing();
+    UXX_EXPORT ~drawing() noexcept;
+
+    drawing(const drawing&) = delete;
+    UXX_EXPORT drawing(drawing&&) noexcept;
+    drawing& operator=(const drawing&) = delete;
+    UXX_EXPORT drawing& operator=(drawing&&) noexcept;
+
+    /// Record what f draws with the pencil it's given, replacing the previous recording.
+    /// Call it while the application runs, like any drawing. Clip rectangles aren't recorded,
+    /// a drawing is clipped like everything else where it is drawn.
+    template <typename F, typename... Args>
+    void record(F&& f, Args&&... args) requires function<F, uxx::pencil&, Args...>
+    {
+        auto p = begin_recording();
+        f(p, std::forward<Args>(args)...);
+        end_recording();
+    }
+
+    UXX_EXPORT void clear() noexcept;
+    [[nodiscard]] UXX_EXPORT bool is_empty() const noexcept;
+
+private:
+    struct state;
+
+    std::unique_ptr<state> _state;
+
+    UXX_EXPORT pencil begin_recording();
+    UXX_EXPORT void end_recording();
+    std::size_t replay(const std::any& draw_list, const vec2d& translation, float scale) const;
+};
+
 class UXX_EXPORT tab_bar {
     friend class pane;
 
@@ -386,6 +533,7 @@ public:
     void item(string_ref label, F&& f, Args&&... args) const requires function<F, uxx::pane&, Args...>
     {
         if (begin_tab_item(label)) {
+            const trace_scope scope { label };
             f(_window, std::forward<Args>(args)...);
             end_tab_item();
         }
@@ -649,6 +797,7 @@ public:
     template <typename F, typename... Args>
     void canvas(uxx::id id, const vec2d& size, F&& f, Args&&... args) requires function<F, uxx::canvas&, uxx::pencil&, Args...>
     {
+        const trace_scope scope { id.get() };
         const auto position = get_cursor_screen_position();
         invisible_button(id, size);
         uxx::canvas c(position, size);
@@ -772,6 +921,7 @@ private:
     void window_impl(string_ref title, result<bool>& open, const pane::properties properties, F&& f, Args&&... args) const requires function<F, uxx::pane&, Args...>
     {
         if (open.get()) {
+            const trace_scope scope { title };
             const auto collapsed = begin_window(title, open, properties);
             {
                 uxx::pane w { collapsed };
@@ -784,6 +934,7 @@ private:
     template <typename F, typename... Args>
     void window_impl(string_ref title, F&& f, Args&&... args) const requires function<F, uxx::pane&, Args...>
     {
+        const trace_scope scope { title };
         const auto collapsed = begin_window(title);
         {
             uxx::pane w { collapsed };
@@ -800,22 +951,278 @@ private:
     void end_main_menu_bar() const;
 };
 
-class UXX_EXPORT app {
+class app {
 public:
     static constexpr unsigned int DEFAULT_WIDTH { 800 };
     static constexpr unsigned int DEFAULT_HEIGHT { 600 };
+    static constexpr std::chrono::milliseconds DEFAULT_IDLE_TIMEOUT { 1000 };
     enum class exit_code : int { success = 0 };
 
-    explicit app() noexcept = default;
-    ~app() noexcept = default;
+    enum class update_mode {
+        continuous, // Default
+        on_demand
+    };
+
+    enum class renderer {
+        legacy, // Default, fixed-function OpenGL with client-side vertex arrays
+        gl3, // Vertex array and buffer objects streamed every frame, requires OpenGL 3
+        software // Rasterized on the CPU by all hardware threads without OpenGL, only for run_headless()
+    };
+
+    enum class overlay_mode {
+        hidden, // Default, F12 shows it
+        visible, // F12 hides it
+        disabled
+    };
+
+    /// Decides how the main loop paces its frames.
+    class frame_policy {
+    public:
+        enum class mode {
+            vsync, // Default
+            fixed_rate,
+            uncapped
+        };
+
+        static constexpr unsigned int DEFAULT_REFRESH_RATE { 60 };
+        static constexpr std::chrono::microseconds DEFAULT_SPIN_THRESHOLD { 2000 };
+
+        /// Let the display's vertical sync pace the frames.
+        /// \param refresh_rate Expected monitor refresh rate, only used to compute deadline misses.
+        [[nodiscard]] UXX_EXPORT static frame_policy vsync(unsigned int refresh_rate = DEFAULT_REFRESH_RATE) noexcept;
+        /// Render at a fixed rate with vsync disabled. Zero frames per second means uncapped.
+        [[nodiscard]] UXX_EXPORT static frame_policy fixed_rate(unsigned int frames_per_second) noexcept;
+        /// Render as fast as possible, useful for benchmarking.
+        [[nodiscard]] UXX_EXPORT static frame_policy uncapped() noexcept;
+
+        ~frame_policy() noexcept = default;
+
+        frame_policy(const frame_policy&) = default;
+        frame_policy(frame_policy&&) noexcept = default;
+        frame_policy& operator=(const frame_policy&) = default;
+        frame_policy& operator=(frame_policy&&) noexcept = default;
+
+        /// The fixed rate mode sleeps until this close to the frame deadline and spins for the remainder.
+        UXX_EXPORT frame_policy set_spin_threshold(std::chrono::microseconds threshold) noexcept;
+
+        [[nodiscard]] UXX_EXPORT mode get_mode() const noexcept;
+        /// \return Time available for each frame, zero when uncapped.
+        [[nodiscard]] UXX_EXPORT std::chrono::nanoseconds get_frame_budget() const noexcept;
+        [[nodiscard]] UXX_EXPORT std::chrono::microseconds get_spin_threshold() const noexcept;
+
+    private:
+        mode _mode;
+        unsigned int _rate;
+        std::chrono::microseconds _spin_threshold;
+
+        explicit frame_policy(mode m, unsigned int rate) noexcept;
+    };
+
+    /// Describes an application run without a visible window, rendering into an offscreen target.
+    class headless {
+    public:
+        static constexpr std::chrono::microseconds DEFAULT_DELTA_TIME { 16667 };
+
+        /// Render a fixed number of frames.
+        [[nodiscard]] UXX_EXPORT static headless frames(std::uint64_t frame_count);
+        /// Render until the predicate returns true. The predicate is given the index of the next frame.
+        [[nodiscard]] UXX_EXPORT static headless until(std::function<bool(std::uint64_t)> predicate);
+
+        ~headless() noexcept = default;
+
+        headless(const headless&) = default;
+        headless(headless&&) noexcept = default;
+        headless& operator=(const headless&) = default;
+        headless& operator=(headless&&) noexcept = default;
+
+        /// Fixed time step reported to the UI for every frame, making runs reproducible.
+        UXX_EXPORT headless set_delta_time(std::chrono::microseconds delta_time) noexcept;
+        /// Feed the input of a recording (see app::set_input_recording) to the UI, frame by frame.
+        UXX_EXPORT headless set_input_replay(const std::filesystem::path& file);
+        /// Save the last rendered frame to an image file when the run is done, the extension selects the format.
+        UXX_EXPORT headless set_output_image(const std::filesystem::path& file);
+
+        [[nodiscard]] UXX_EXPORT bool is_done(std::uint64_t frame_index) const;
+        [[nodiscard]] UXX_EXPORT std::chrono::microseconds get_delta_time() const noexcept;
+        /// \return Input recording to replay, empty if none.
+        [[nodiscard]] UXX_EXPORT const std::filesystem::path& get_input_replay() const noexcept;
+        /// \return Image file the last frame is saved to, empty if none.
+        [[nodiscard]] UXX_EXPORT const std::filesystem::path& get_output_image() const noexcept;
+
+    private:
+        std::function<bool(std::uint64_t)> _done;
+        std::chrono::microseconds _delta_time;
+        std::filesystem::path _input_replay;
+        std::filesystem::path _output_image;
+
+        explicit headless(std::function<bool(std::uint64_t)> done) noexcept;
+    };
+
+    /// File formats start_capture() records frames in.
+    enum class capture_format {
+        png_sequence, // One PNG image per frame, numbered in a directory
+        y4m, // Uncompressed YUV 4:2:0 video that players and ffmpeg read
+        raw_rgba // RGBA pixels of every frame back to back, without a header
+    };
+
+    /// The steps of a frame, in the order the main loop runs them.
+    enum class frame_phase {
+        events, // Polling and dispatching window events
+        update, // Starting a new UI frame
+        callback, // Running the user provided callback
+        render, // Tessellating and submitting draw data
+        display // Presenting the frame
+    };
+
+    /// Counts the phases up to display, which must stay the last one
+    static constexpr std::size_t FRAME_PHASE_COUNT { static_cast<std::size_t>(frame_phase::display) + 1 };
+
+    struct frame_sample {
+        std::array<std::chrono::nanoseconds, FRAME_PHASE_COUNT> phases;
+        /// True if the frame looked like the previous one and was neither rendered nor presented.
+        bool skipped;
+
+        [[nodiscard]] std::chrono::nanoseconds get(const frame_phase phase) const noexcept
+        {
+            return phases[static_cast<std::size_t>(phase)];
+        }
+
+        [[nodiscard]] std::chrono::nanoseconds get_total() const noexcept
+        {
+            std::chrono::nanoseconds total { 0 };
+            for (const auto duration : phases) {
+                total += duration;
+            }
+            return total;
+        }
+    };
+
+    /// Ring buffer with timings of the most recent frames.
+    class frame_stats {
+    public:
+        static constexpr std::size_t CAPACITY { 256 };
+
+        struct summary {
+            std::chrono::nanoseconds min;
+            std::chrono::nanoseconds avg;
+            std::chrono::nanoseconds p95;
+            std::chrono::nanoseconds p99;
+        };
+
+        UXX_EXPORT void add(const frame_sample& sample) noexcept;
+        UXX_EXPORT void clear() noexcept;
+
+        /// \return Statistics for a single phase over the recorded frames.
+        [[nodiscard]] UXX_EXPORT summary get_summary(frame_phase phase) const;
+        /// \return Statistics for whole frames over the recorded frames.
+        [[nodiscard]] UXX_EXPORT summary get_frame_summary() const;
+        [[nodiscard]] UXX_EXPORT std::size_t get_sample_count() const noexcept;
+        /// \return Number of recorded frames that were skipped because nothing changed.
+        [[nodiscard]] UXX_EXPORT std::size_t get_skipped_count() const noexcept;
+        /// \param age Zero is the most recent frame, get_sample_count() - 1 the oldest.
+        [[nodiscard]] UXX_EXPORT const frame_sample& get_sample(std::size_t age) const noexcept;
+
+    private:
+        std::array<frame_sample, CAPACITY> _samples {};
+        std::size_t _next { 0 };
+        std::size_t _count { 0 };
+    };
+
+    struct frame_counters {
+        /// Vertices submitted for rendering.
+        std::size_t vertices;
+        /// Indices submitted for rendering.
+        std::size_t indices;
+        /// Draw commands submitted for rendering.
+        std::size_t draw_commands;
+        /// Draw commands built before compatible ones were merged, see set_merge_draw_commands().
+        std::size_t unmerged_draw_commands;
+        /// Bytes uploaded to textures, e.g. video frames or the font atlas.
+        std::size_t texture_upload_bytes;
+        /// Pixels drawn again, less than the size of the window when partial redraw limited them to what changed.
+        std::size_t redrawn_pixels;
+        /// Pencil shapes left out because they were outside the clip rectangle, e.g. the scrolled away part of a
+        /// canvas. Every segment of a polyline and every item of the bulk functions counts on its own.
+        std::size_t culled_primitives;
+    };
+
+    struct frame_report {
+        /// Sequence number of the frame.
+        std::uint64_t index;
+        /// Time since the previous frame started.
+        std::chrono::nanoseconds frame_time;
+        /// How late the frame was compared to its deadline, zero when on time.
+        std::chrono::nanoseconds deadline_miss;
+        /// Amount of work the frame submitted to the GPU.
+        frame_counters counters;
+        /// True if the draw data was unchanged and the frame was neither rendered nor presented.
+        bool skipped;
+    };
+
+    UXX_EXPORT explicit app() noexcept;
+    /// \param r Renderer used by every window of the application, see renderer.
+    UXX_EXPORT explicit app(renderer r) noexcept;
+    UXX_EXPORT ~app() noexcept;
 
     app(const app&) = delete;
     app(app&&) noexcept = default;
     app& operator=(const app&) = delete;
     app& operator=(app&&) noexcept = default;
 
-    void set_width(unsigned int width) noexcept;
-    void set_height(unsigned int height) noexcept;
+    UXX_EXPORT void set_width(unsigned int width) noexcept;
+    UXX_EXPORT void set_height(unsigned int height) noexcept;
+    /// Select when the screen is redrawn.
+    /// In on-demand mode a frame is only rendered after input, after a redraw request or when the idle timeout
+    /// expires. Nothing is rendered while the window is minimized or unfocused.
+    UXX_EXPORT void set_update_mode(update_mode mode) noexcept;
+    /// Longest time the on-demand mode waits before rendering a frame anyway.
+    UXX_EXPORT void set_idle_timeout(std::chrono::milliseconds timeout) noexcept;
+    /// Select how frames are paced (vsync, fixed rate or uncapped).
+    UXX_EXPORT void set_frame_policy(const frame_policy& policy) noexcept;
+    /// Select whether the performance overlay is shown, and whether F12 may toggle it.
+    UXX_EXPORT void set_overlay_mode(overlay_mode mode) noexcept;
+    /// Record the window events of run() with their frame index, for replay with headless::set_input_replay().
+    UXX_EXPORT void set_input_recording(const std::filesystem::path& file);
+    /// Directory where the baked font atlas is cached between runs. An empty path disables the cache.
+    /// Defaults to the per-user cache directory of the platform.
+    UXX_EXPORT void set_font_cache_directory(const std::filesystem::path& directory);
+    /// Skip rendering and presenting frames whose draw data is identical to the frame on screen. Enabled by default.
+    /// Disable it to make every frame reach the GPU, e.g. when measuring rendering throughput.
+    UXX_EXPORT void set_skip_unchanged_frames(bool enabled) noexcept;
+    /// Keep every window's previous frame in an offscreen back buffer and only redraw the area that changed since,
+    /// e.g. a blinking status light or a clock. The back buffer is copied to the window every frame, which pays off
+    /// for large windows with overlapping content. Disabled by default.
+    UXX_EXPORT void set_partial_redraw(bool enabled) noexcept;
+    /// Render and present the main window on a thread of its own. The draw data of a finished frame is copied and
+    /// handed to the render thread, which waits for vsync while the callback already builds the next frame.
+    /// Pays off when both building the UI and submitting it take a noticeable part of the frame. Disabled by default.
+    UXX_EXPORT void set_render_thread(bool enabled) noexcept;
+    /// Merge draw commands that share a texture and clip rectangle before they are rendered, moving a command ahead
+    /// of earlier ones it doesn't overlap. Images and videos between widgets otherwise split the frame into many small
+    /// draw calls. The frame looks the same either way. Enabled by default.
+    UXX_EXPORT void set_merge_draw_commands(bool enabled) noexcept;
+    /// Record every frame of the main window, or of a headless run, until stop_capture() is called or the window closes.
+    /// Frames are read back from the GPU asynchronously and encoded on a thread of their own, so the main loop doesn't
+    /// wait for either. Frames are dropped when the encoder falls behind. Skipped frames repeat the previous one.
+    /// Videos keep the size of their first frame, frames of another size are dropped. Safe to call from any thread.
+    /// \param path Directory of a PNG sequence, file of a video.
+    /// \param frame_rate Frame rate written to the header of a Y4M video.
+    /// \throw std::runtime_error If the file or directory can't be created.
+    UXX_EXPORT void start_capture(const std::filesystem::path& path, capture_format format, unsigned int frame_rate = 60) const;
+    /// Finish the capture started by start_capture(). Safe to call from any thread.
+    UXX_EXPORT void stop_capture() const noexcept;
+    /// \return Frames that captures dropped because the encoder fell behind or the frame size changed, counted when
+    /// a capture finishes.
+    [[nodiscard]] UXX_EXPORT std::size_t get_dropped_capture_frames() const noexcept;
+    /// Schedule a redraw as soon as possible. Safe to call from any thread.
+    UXX_EXPORT void request_redraw() const noexcept;
+    /// Schedule the next frame right away. Call it every frame to keep an animation running in on-demand mode.
+    UXX_EXPORT void request_animation_frame() const noexcept;
+    /// \return Timing of the most recently finished frame. Safe to call from any thread.
+    [[nodiscard]] UXX_EXPORT frame_report get_last_frame_report() const noexcept;
+    /// \return Per-phase timings of the most recent frames. The running loop adds to them every frame, read them from
+    ///         the callbacks of run() or after it returns.
+    [[nodiscard]] UXX_EXPORT const frame_stats& get_frame_stats() const noexcept;
 
     template <typename F, typename... Args>
     [[nodiscard]] int run(string_ref title, F f, Args&&... args) const requires function<F, screen&, Args...>
@@ -827,12 +1234,54 @@ public:
         return static_cast<int>(_exit_code);
     }
 
+    /// Open another window next to the main window of run(), drawn by its own callback.
+    /// All windows share the font atlas, images and videos, so nothing is loaded or uploaded twice.
+    /// The window may be closed on its own, closing the main window closes all of them.
+    /// Windows added while run() is running, e.g. from its callback, open at the start of the next frame.
+    template <typename F>
+    void add_window(string_ref title, F f, unsigned int width = DEFAULT_WIDTH, unsigned int height = DEFAULT_HEIGHT) requires function<F, screen&>
+    {
+        add_window_impl(title, width, height, [f = std::move(f)]() mutable {
+            screen c;
+            f(c);
+        });
+    }
+
+    /// Run the same kind of callback as run(), but offscreen and without a visible window.
+    /// Frames are rendered back-to-back until 'mode' says the run is done.
+    template <typename F, typename... Args>
+    [[nodiscard]] int run_headless(const headless& mode, F f, Args&&... args) const requires function<F, screen&, Args...>
+    {
+        screen c;
+        mainloop_headless(mode, [&]() {
+            f(c, std::forward<Args>(args)...);
+        });
+        return static_cast<int>(_exit_code);
+    }
+
 private:
+    struct state;
+
     exit_code _exit_code { exit_code::success };
     unsigned int _width { uxx::app::DEFAULT_WIDTH };
     unsigned int _height { uxx::app::DEFAULT_HEIGHT };
-
-    void mainloop(string_ref title, const std::function<void()>& render) const;
+    update_mode _update_mode { update_mode::continuous };
+    std::chrono::milliseconds _idle_timeout { uxx::app::DEFAULT_IDLE_TIMEOUT };
+    frame_policy _frame_policy { frame_policy::vsync() };
+    overlay_mode _overlay_mode { overlay_mode::hidden };
+    renderer _renderer { renderer::legacy };
+    bool _skip_unchanged_frames { true };
+    bool _partial_redraw { false };
+    bool _render_thread { false };
+    bool _merge_draw_commands { true };
+    std::filesystem::path _input_recording;
+    std::optional<std::filesystem::path> _font_cache_directory;
+    std::unique_ptr<state> _state;
+
+    UXX_EXPORT void mainloop(string_ref title, const std::function<void()>& render) const;
+    UXX_EXPORT void mainloop_headless(const headless& mode, const std::function<void()>& render) const;
+    void draw_overlay(result<bool>& visible) const;
+    UXX_EXPORT void add_window_impl(string_ref title, unsigned int width, unsigned int height, std::function<void()> render);
 };
 }
 
@@ -1,6 +1,521 @@
 #include "common.hpp"
+#include "damage_tracker.hpp"
+#include "draw_command_merger.hpp"
+#include "draw_data_hash.hpp"
+#include "font_atlas.hpp"
+#include "frame_capture.hpp"
+#include "frame_policy.hpp"
+#include "gl3_renderer.hpp"
+#include "input_recording.hpp"
+#include "render_thread.hpp"
+#include "software_renderer.hpp"
 #include "uxx/uxx.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+struct uxx::app::state {
+    struct window_description {
+        std::string title;
+        unsigned int width;
+        unsigned int height;
+        std::function<void()> render;
+    };
+
+
+    std::mutex mutex {};
+    std::condition_variable wake_up {};
+    std::atomic<bool> frame_requested { false };
+    frame_report last_frame_report {};
+    frame_stats stats {};
+    result<bool> overlay_visible { false };
+    std::vector<window_description> windows {};
+    detail::frame_capture capture {};
+};
+
+namespace {
+
+// Frames rendered after an input event, giving ImGui time to settle hover/active states
+constexpr int SETTLE_FRAMES { 3 };
+
+// How often an idle on-demand loop looks for new window events
+constexpr auto IDLE_POLL_INTERVAL = std::chrono::milliseconds(4);
+
+constexpr std::array<const char*, uxx::app::FRAME_PHASE_COUNT> PHASE_NAMES { "events", "update", "callback", "render", "display" };
+
+std::atomic<const uxx::app*> running_app { nullptr };
+
+std::atomic<std::size_t> texture_upload_bytes { 0 };
+
+std::atomic<std::size_t> culled_primitives { 0 };
+
+constexpr std::string_view DEFAULT_FONT { "Roboto-Medium.ttf" };
+constexpr float DEFAULT_FONT_SIZE { 15.0f };
+
+const uxx::detail::embedded_font* find_embedded_font(const std::string_view name) noexcept
+{
+    const auto fonts = uxx::detail::get_embedded_fonts();
+    const auto it = std::find_if(fonts.begin(), fonts.end(), [name](const uxx::detail::embedded_font& font) { return font.name == name; });
+    return it != fonts.end() ? &*it : nullptr;
+}
+
+/// \param software Renderer that gets the font texture instead of OpenGL, nullptr when rendering with OpenGL.
+void load_fonts(const std::filesystem::path& cache_directory, uxx::detail::software_renderer* software)
+{
+    auto& atlas = *ImGui::GetIO().Fonts;
+    atlas.Clear();
+
+    if (const auto* font = find_embedded_font(DEFAULT_FONT); nullptr != font) {
+        uxx::detail::add_embedded_font(atlas, *font, DEFAULT_FONT_SIZE);
+    } else {
+        atlas.AddFontDefault();
+    }
+    uxx::detail::build_font_atlas(atlas, cache_directory);
+
+    if (nullptr != software) {
+        unsigned char* pixels = nullptr;
+        int width = 0;
+        int height = 0;
+        atlas.GetTexDataAsRGBA32(&pixels, &width, &height);
+        // There is no OpenGL texture, the atlas itself identifies the font texture
+        atlas.TexID = &atlas;
+        software->set_texture(atlas.TexID, static_cast<unsigned int>(width), static_cast<unsigned int>(height), pixels);
+    } else {
+        ImGui::SFML::UpdateFontTexture();
+    }
+    uxx::detail::count_texture_upload(static_cast<std::size_t>(atlas.TexWidth) * static_cast<std::size_t>(atlas.TexHeight) * 4);
+}
+
+// Attributes the time since the previous phase ended to the phase that just ended
+// and mirrors the phases into a running trace
+class phase_clock {
+public:
+    using clock = uxx::detail::trace_clock;
+
+    void restart() noexcept
+    {
+        _sample = {};
+        _last = clock::now();
+        _frame_start = _last;
+    }
+
+    void end_phase(const uxx::app::frame_phase phase) noexcept
+    {
+        const auto now = clock::now();
+        const auto index = static_cast<std::size_t>(phase);
+        _sample.phases[index] += now - _last;
+        uxx::detail::add_trace_event(PHASE_NAMES[index], _last, now);
+        _last = now;
+    }
+
+    /// Mark the frame as skipped, it wasn't rendered or presented.
+    void skip_frame() noexcept
+    {
+        _sample.skipped = true;
+    }
+
+    void end_frame() const noexcept
+    {
+        uxx::detail::add_trace_event("frame", _frame_start, _last);
+    }
+
+    [[nodiscard]] const uxx::app::frame_sample& get_sample() const noexcept
+    {
+        return _sample;
+    }
+
+private:
+    uxx::app::frame_sample _sample {};
+    clock::time_point _last { clock::now() };
+    clock::time_point _frame_start { _last };
+};
+
+[[nodiscard]] uxx::app::frame_counters count_draw_data(const ImDrawData* draw_data) noexcept
+{
+    uxx::app::frame_counters counters {};
+
+    if (nullptr != draw_data) {
+        counters.vertices = static_cast<std::size_t>(draw_data->TotalVtxCount);
+        counters.indices = static_cast<std::size_t>(draw_data->TotalIdxCount);
+
+        for (int i = 0; i < draw_data->CmdListsCount; ++i) {
+            counters.draw_commands += static_cast<std::size_t>(draw_data->CmdLists[i]->CmdBuffer.Size);
+        }
+        counters.unmerged_draw_commands = counters.draw_commands;
+    }
+    counters.texture_upload_bytes = texture_upload_bytes.exchange(0);
+    counters.culled_primitives = culled_primitives.exchange(0);
+    return counters;
+}
+
+void add_counters(uxx::app::frame_counters& total, const uxx::app::frame_counters& counters) noexcept
+{
+    total.vertices += counters.vertices;
+    total.indices += counters.indices;
+    total.draw_commands += counters.draw_commands;
+    total.unmerged_draw_commands += counters.unmerged_draw_commands;
+    total.texture_upload_bytes += counters.texture_upload_bytes;
+    total.redrawn_pixels += counters.redrawn_pixels;
+    total.culled_primitives += counters.culled_primitives;
+}
+
+[[nodiscard]] sf::ContextSettings get_context_settings(const uxx::app::renderer renderer) noexcept
+{
+    sf::ContextSettings settings {};
+
+    if (renderer == uxx::app::renderer::gl3) {
+        // Keep the default compatibility profile, SFML itself still draws with OpenGL 1
+        settings.majorVersion = 3;
+        settings.minorVersion = 0;
+    }
+    return settings;
+}
+
+[[nodiscard]] std::unique_ptr<uxx::detail::gl3_renderer> create_renderer(const uxx::app::renderer renderer, sf::RenderTarget& target)
+{
+    if (renderer == uxx::app::renderer::gl3) {
+        return std::make_unique<uxx::detail::gl3_renderer>(target);
+    }
+    return nullptr;
+}
+
+// Remembers the draw data of the frame on screen, so that drawing the same frame again can be skipped
+class frame_skipper {
+public:
+    explicit frame_skipper(const bool enabled) noexcept
+        : _enabled(enabled)
+    {
+    }
+
+    /// Forget the frame on screen, e.g. when the window contents may have been lost.
+    void invalidate() noexcept
+    {
+        _has_presented = false;
+    }
+
+    /// \param textures_changed Textures were uploaded this frame, the same draw data may look different.
+    /// \return True if the draw data matches the frame on screen, which then doesn't have to be drawn again.
+    [[nodiscard]] bool is_unchanged(const ImDrawData& draw_data, const bool textures_changed) noexcept
+    {
+        if (!_enabled) {
+            return false;
+        }
+        const auto hash = textures_changed ? std::nullopt : uxx::detail::hash_draw_data(draw_data);
+        const bool unchanged = hash.has_value() && _has_presented && *hash == _presented;
+        _presented = hash.value_or(0);
+        _has_presented = hash.has_value();
+        return unchanged;
+    }
+
+private:
+    bool _enabled;
+    // Hash of the draw data on screen, if it could be hashed. Not an optional, which GCC 12 warns may be used
+    // uninitialized in release builds.
+    std::uint64_t _presented {};
+    bool _has_presented { false };
+};
+
+// Keeps the previous frame in an offscreen back buffer, redraws only the area that changed since
+// and copies the back buffer to the target
+class retained_frame {
+public:
+    explicit retained_frame(const uxx::app::renderer renderer) noexcept
+        : _renderer_kind(renderer)
+    {
+    }
+
+    /// Redraw the damaged area of the back buffer and copy it to the target.
+    /// \param textures_changed Textures were uploaded this frame, the whole frame is drawn again.
+    /// \return Number of pixels drawn again.
+    std::size_t draw(sf::RenderTarget& target, ImDrawData& draw_data, const bool textures_changed)
+    {
+        const auto size = target.getSize();
+
+        if (_back_buffer.getSize() != size) {
+            // The renderer owns objects of the back buffer's context
+            _renderer.reset();
+
+            if (!_back_buffer.create(size.x, size.y, get_context_settings(_renderer_kind))) {
+                throw std::runtime_error("Unable to create the back buffer for partial redraws");
+            }
+            _renderer = create_renderer(_renderer_kind, _back_buffer);
+            _damage.reset();
+        }
+        const auto& origin = draw_data.DisplayPos;
+        auto damage = _damage.update(draw_data);
+
+        if (textures_changed) {
+            damage = { origin.x, origin.y, origin.x + draw_data.DisplaySize.x, origin.y + draw_data.DisplaySize.y };
+        }
+        std::size_t redrawn_pixels = 0;
+
+        if (!uxx::detail::is_empty(damage)) {
+            sf::RectangleShape clear_area { { damage.z - damage.x, damage.w - damage.y } };
+            clear_area.setPosition(damage.x - origin.x, damage.y - origin.y);
+            clear_area.setFillColor(sf::Color::Black);
+            _back_buffer.draw(clear_area, sf::RenderStates { sf::BlendNone });
+
+            uxx::detail::clip_draw_data(draw_data, damage);
+
+            if (nullptr != _renderer) {
+                _renderer->render(draw_data);
+            } else {
+                ImGui::SFML::RenderDrawData(_back_buffer, &draw_data);
+            }
+            const auto scale = draw_data.FramebufferScale;
+            redrawn_pixels = static_cast<std::size_t>((damage.z - damage.x) * scale.x * (damage.w - damage.y) * scale.y);
+        }
+        _back_buffer.display();
+
+        const sf::Vector2f target_size { static_cast<float>(size.x), static_cast<float>(size.y) };
+        target.setView(sf::View { sf::FloatRect { { 0.0f, 0.0f }, target_size } });
+        target.draw(sf::Sprite { _back_buffer.getTexture() }, sf::RenderStates { sf::BlendNone });
+        return redrawn_pixels;
+    }
+
+private:
+    uxx::app::renderer _renderer_kind;
+    sf::RenderTexture _back_buffer {};
+    std::unique_ptr<uxx::detail::gl3_renderer> _renderer {};
+    uxx::detail::damage_tracker _damage {};
+};
+
+struct drawn_frame {
+    uxx::app::frame_counters counters;
+    // Nothing was drawn and the target must not be presented
+    bool skipped;
+};
+
+/// \param merger Merges the draw commands of the frame before it is drawn, nullptr when merging is disabled.
+/// \param draw Draws the draw data, given whether textures changed this frame, and returns the number of pixels drawn.
+template <typename F>
+[[nodiscard]] drawn_frame draw_frame(const std::function<void()>& render, phase_clock& phases, frame_skipper& skipper, uxx::detail::draw_command_merger* merger, F&& draw)
+{
+    render();
+    phases.end_phase(uxx::app::frame_phase::callback);
+
+    ImGui::Render();
+    auto& draw_data = *ImGui::GetDrawData();
+    auto counters = count_draw_data(&draw_data);
+    const bool textures_changed = counters.texture_upload_bytes > 0;
+
+    if (skipper.is_unchanged(draw_data, textures_changed)) {
+        phases.skip_frame();
+        phases.end_phase(uxx::app::frame_phase::render);
+        return { {}, true };
+    }
+    if (nullptr != merger) {
+        // After the skip check, the hash of an unchanged frame doesn't depend on how its commands were merged
+        counters.draw_commands = merger->merge(draw_data);
+    }
+    counters.redrawn_pixels = draw(draw_data, textures_changed);
+    phases.end_phase(uxx::app::frame_phase::render);
+    return { counters, false };
+}
+
+/// \param renderer Draws the frame, or nullptr for the legacy renderer of imgui-SFML.
+/// \param retained Draws the frame instead of the renderer when partial redraw is enabled, nullptr otherwise.
+/// \return Number of pixels drawn.
+std::size_t draw_to_target(sf::RenderTarget& target, uxx::detail::gl3_renderer* renderer, retained_frame* retained, ImDrawData& draw_data, const bool textures_changed)
+{
+    if (nullptr != retained) {
+        return retained->draw(target, draw_data, textures_changed);
+    }
+    const auto size = target.getSize();
+    target.clear();
+
+    if (nullptr != renderer) {
+        renderer->render(draw_data);
+    } else {
+        ImGui::SFML::RenderDrawData(target, &draw_data);
+    }
+    return std::size_t { size.x } * size.y;
+}
+
+// How the windows of an application draw their frames
+struct drawing_options {
+    uxx::app::renderer renderer;
+    bool skip_unchanged_frames;
+    bool partial_redraw;
+    bool merge_draw_commands;
+};
+
+[[nodiscard]] bool invalidates_frame(const sf::Event& event) noexcept
+{
+    // The window contents may have been scaled or damaged by the window system
+    return event.type == sf::Event::Resized || event.type == sf::Event::GainedFocus;
+}
+
+// Makes an ImGui context current and restores the previous one when leaving the scope
+class context_scope {
+public:
+    explicit context_scope(ImGuiContext* context) noexcept
+        : _previous { ImGui::GetCurrentContext() }
+    {
+        ImGui::SetCurrentContext(context);
+    }
+
+    ~context_scope() noexcept
+    {
+        ImGui::SetCurrentContext(_previous);
+    }
+
+    context_scope(const context_scope&) = delete;
+    context_scope(context_scope&&) = delete;
+    context_scope& operator=(const context_scope&) = delete;
+    context_scope& operator=(context_scope&&) = delete;
+
+private:
+    ImGuiContext* _previous;
+};
+
+// A window next to the main window, with an ImGui context of its own that shares the font atlas
+// (and through SFML's shared OpenGL contexts every other texture) with the main window
+class secondary_window {
+public:
+    explicit secondary_window(const std::string& title, const unsigned int width, const unsigned int height, std::function<void()> render, ImFontAtlas& atlas, const drawing_options& options)
+        : _window(sf::VideoMode(width, height), title, sf::Style::Default, get_context_settings(options.renderer))
+        , _render(std::move(render))
+        , _skipper(options.skip_unchanged_frames)
+    {
+        const context_scope scope { ImGui::GetCurrentContext() };
+
+        // Only the main window waits for vsync, otherwise every window would divide the frame rate
+        _window.setVerticalSyncEnabled(false);
+        ImGui::SFML::Init(_window, &atlas);
+        _context = ImGui::GetCurrentContext();
+        // imgui.ini belongs to the main window
+        ImGui::GetIO().IniFilename = nullptr;
+        _focused = _window.hasFocus();
+
+        if (options.partial_redraw) {
+            _retained = std::make_unique<retained_frame>(options.renderer);
+        } else {
+            _renderer = create_renderer(options.renderer, _window);
+        }
+        if (options.merge_draw_commands) {
+            _merger = std::make_unique<uxx::detail::draw_command_merger>();
+        }
+    }
+
+    ~secondary_window() noexcept
+    {
+        const context_scope scope { _context };
+        _retained.reset();
+        _renderer.reset();
+        ImGui::SFML::Shutdown();
+    }
+
+    secondary_window(const secondary_window&) = delete;
+    secondary_window(secondary_window&&) = delete;
+    secondary_window& operator=(const secondary_window&) = delete;
+    secondary_window& operator=(secondary_window&&) = delete;
+
+    [[nodiscard]] bool is_open() const
+    {
+        return _window.isOpen();
+    }
+
+    [[nodiscard]] bool is_focused() const noexcept
+    {
+        return _focused;
+    }
+
+    /// \return True if there were any events.
+    bool process_events()
+    {
+        const context_scope scope { _context };
+        sf::Event event {};
+        bool processed = false;
+
+        while (_window.isOpen() && _window.pollEvent(event)) {
+            processed = true;
+
+            if (event.type == sf::Event::Closed) {
+                _window.close();
+                break;
+            }
+            if (event.type == sf::Event::LostFocus || event.type == sf::Event::GainedFocus) {
+                _focused = event.type == sf::Event::GainedFocus;
+            }
+            if (invalidates_frame(event)) {
+                _skipper.invalidate();
+            }
+            ImGui::SFML::ProcessEvent(event);
+        }
+        return processed;
+    }
+
+    [[nodiscard]] uxx::app::frame_counters draw(phase_clock& phases)
+    {
+        const context_scope scope { _context };
+        const auto size = _window.getSize();
+
+        if (size.x == 0 || size.y == 0) {
+            return {};
+        }
+        ImGui::SFML::Update(_window, _delta_clock.restart());
+        phases.end_phase(uxx::app::frame_phase::update);
+        const auto frame = draw_frame(_render, phases, _skipper, _merger.get(), [this](ImDrawData& draw_data, const bool textures_changed) {
+            return draw_to_target(_window, _renderer.get(), _retained.get(), draw_data, textures_changed);
+        });
+
+        if (!frame.skipped) {
+            _window.display();
+        }
+        phases.end_phase(uxx::app::frame_phase::display);
+        return frame.counters;
+    }
+
+private:
+    sf::RenderWindow _window;
+    std::function<void()> _render;
+    ImGuiContext* _context { nullptr };
+    std::unique_ptr<uxx::detail::gl3_renderer> _renderer {};
+    std::unique_ptr<retained_frame> _retained {};
+    std::unique_ptr<uxx::detail::draw_command_merger> _merger {};
+    sf::Clock _delta_clock {};
+    frame_skipper _skipper;
+    bool _focused { false };
+};
+
+}
+
+void uxx::detail::request_animation_frame() noexcept
+{
+    if (const auto* app = running_app.load(); nullptr != app) {
+        app->request_animation_frame();
+    }
+}
+
+void uxx::detail::count_texture_upload(const std::size_t bytes) noexcept
+{
+    texture_upload_bytes += bytes;
+}
+
+void uxx::detail::count_culled_primitives(const std::size_t count) noexcept
+{
+    culled_primitives += count;
+}
+
+uxx::app::app() noexcept
+    : _state { std::make_unique<state>() }
+{
+}
+
+uxx::app::app(const renderer r) noexcept
+    : _renderer { r }
+    , _state { std::make_unique<state>() }
+{
+}
+
+uxx::app::~app() noexcept = default;
+
 void uxx::app::set_width(unsigned int width) noexcept
 {
     _width = width;
@@ -11,36 +526,445 @@ void uxx::app::set_height(unsigned int height) noexcept
     _height = height;
 }
 
+void uxx::app::set_update_mode(const update_mode mode) noexcept
+{
+    _update_mode = mode;
+}
+
+void uxx::app::set_idle_timeout(const std::chrono::milliseconds timeout) noexcept
+{
+    _idle_timeout = timeout;
+}
+
+void uxx::app::set_frame_policy(const frame_policy& policy) noexcept
+{
+    _frame_policy = policy;
+}
+
+void uxx::app::set_overlay_mode(const overlay_mode mode) noexcept
+{
+    _overlay_mode = mode;
+}
+
+void uxx::app::set_input_recording(const std::filesystem::path& file)
+{
+    _input_recording = file;
+}
+
+void uxx::app::set_font_cache_directory(const std::filesystem::path& directory)
+{
+    _font_cache_directory = directory;
+}
+
+void uxx::app::set_skip_unchanged_frames(const bool enabled) noexcept
+{
+    _skip_unchanged_frames = enabled;
+}
+
+void uxx::app::set_partial_redraw(const bool enabled) noexcept
+{
+    _partial_redraw = enabled;
+}
+
+void uxx::app::set_render_thread(const bool enabled) noexcept
+{
+    _render_thread = enabled;
+}
+
+void uxx::app::set_merge_draw_commands(const bool enabled) noexcept
+{
+    _merge_draw_commands = enabled;
+}
+
+void uxx::app::start_capture(const std::filesystem::path& path, const capture_format format, const unsigned int frame_rate) const
+{
+    _state->capture.start(path, format, frame_rate);
+}
+
+void uxx::app::stop_capture() const noexcept
+{
+    _state->capture.stop();
+}
+
+std::size_t uxx::app::get_dropped_capture_frames() const noexcept
+{
+    return _state->capture.get_dropped_count();
+}
+
+void uxx::app::add_window_impl(string_ref title, const unsigned int width, const unsigned int height, std::function<void()> render)
+{
+    std::scoped_lock lock { _state->mutex };
+    _state->windows.push_back({ title.c_str(), width, height, std::move(render) });
+}
+
+void uxx::app::request_redraw() const noexcept
+{
+    {
+        std::scoped_lock lock { _state->mutex };
+        _state->frame_requested = true;
+    }
+    _state->wake_up.notify_one();
+}
+
+void uxx::app::request_animation_frame() const noexcept
+{
+    _state->frame_requested = true;
+}
+
+uxx::app::frame_report uxx::app::get_last_frame_report() const noexcept
+{
+    std::scoped_lock lock { _state->mutex };
+    return _state->last_frame_report;
+}
+
+const uxx::app::frame_stats& uxx::app::get_frame_stats() const noexcept
+{
+    return _state->stats;
+}
+
 void uxx::app::mainloop(string_ref title, const std::function<void()>& render) const
 {
     constexpr bool load_default_font = false;
 
-    sf::RenderWindow w(sf::VideoMode(_width, _height), title.c_str());
-    w.setVerticalSyncEnabled(true);
+    if (_renderer == renderer::software) {
+        throw std::runtime_error("The software renderer only renders headless runs");
+    }
+    sf::RenderWindow w(sf::VideoMode(_width, _height), title.c_str(), sf::Style::Default, get_context_settings(_renderer));
+    w.setVerticalSyncEnabled(_frame_policy.get_mode() == frame_policy::mode::vsync);
     ImGui::SFML::Init(w, load_default_font);
-    auto& io = ImGui::GetIO();
-    io.Fonts->Clear();
-    io.Fonts->AddFontFromFileTTF("Roboto-Medium.ttf", 15.0f);
-    ImGui::SFML::UpdateFontTexture();
+    load_fonts(_font_cache_directory.value_or(detail::get_default_cache_directory()), nullptr);
+    const drawing_options options { _renderer, _skip_unchanged_frames, _partial_redraw, _merge_draw_commands };
+    // With partial redraw the frame is drawn into a back buffer that has a renderer of its own
+    auto renderer = _partial_redraw ? nullptr : create_renderer(_renderer, w);
+    auto retained = _partial_redraw ? std::make_unique<retained_frame>(_renderer) : nullptr;
+    std::unique_ptr<detail::render_thread> presenter {};
+
+    if (_render_thread) {
+        // The render thread owns the OpenGL context of the main window from now on
+        w.setActive(false);
+        presenter = std::make_unique<detail::render_thread>(
+            [&](ImDrawData& draw_data, const bool textures_changed) {
+                const auto drawn_pixels = draw_to_target(w, renderer.get(), retained.get(), draw_data, textures_changed);
+                _state->capture.read(w);
+                w.display();
+                return drawn_pixels;
+            },
+            [&w](const bool active) { w.setActive(active); });
+    }
+
+    std::vector<std::unique_ptr<secondary_window>> windows {};
+    std::size_t added_windows = 0;
+
+    // Windows added while running open at the start of the next frame
+    const auto open_added_windows = [&]() {
+        std::vector<state::window_description> added {};
+        {
+            std::scoped_lock lock { _state->mutex };
+            added.assign(_state->windows.begin() + static_cast<std::ptrdiff_t>(added_windows), _state->windows.end());
+            added_windows = _state->windows.size();
+        }
+        for (auto& description : added) {
+            windows.push_back(std::make_unique<secondary_window>(description.title, description.width, description.height, std::move(description.render), *ImGui::GetIO().Fonts, options));
+        }
+    };
+    open_added_windows();
 
     sf::Event event {};
     sf::Clock delta_clock {};
+    detail::frame_pacer pacer { _frame_policy };
+    frame_skipper skipper { _skip_unchanged_frames };
+    auto merger = _merge_draw_commands ? std::make_unique<detail::draw_command_merger>() : nullptr;
+    bool focused = w.hasFocus();
+    int settle_frames = SETTLE_FRAMES;
+    std::uint64_t frame_index = 0;
+    std::optional<detail::input_recorder> recorder {};
+
+    if (!_input_recording.empty()) {
+        recorder.emplace(_input_recording);
+        // A replay starts out unfocused, like any headless run
+        sf::Event initial_focus {};
+        initial_focus.type = focused ? sf::Event::GainedFocus : sf::Event::LostFocus;
+        recorder->record(frame_index, initial_focus);
+    }
+
+    const auto process_event = [&](const sf::Event& e) {
+        if (recorder) {
+            recorder->record(frame_index, e);
+        }
+        if (e.type == sf::Event::Closed) {
+            // The context must not be in use on the render thread when the window goes away
+            presenter.reset();
+            // Frames of a capture that are still in flight need the context too
+            if (w.setActive(true)) {
+                _state->capture.close();
+            }
+            w.close();
+            return;
+        }
+        if (e.type == sf::Event::LostFocus || e.type == sf::Event::GainedFocus) {
+            focused = e.type == sf::Event::GainedFocus;
+        }
+        if (invalidates_frame(e)) {
+            skipper.invalidate();
+        }
+        if (e.type == sf::Event::KeyPressed && e.key.code == sf::Keyboard::F12 && _overlay_mode != overlay_mode::disabled) {
+            _state->overlay_visible = !_state->overlay_visible.get();
+        }
+        ImGui::SFML::ProcessEvent(e);
+        settle_frames = SETTLE_FRAMES;
+    };
+
+    // Returns true if any of the secondary windows had events
+    const auto process_window_events = [&]() {
+        bool processed = false;
+
+        for (auto& window : windows) {
+            processed = window->process_events() || processed;
+        }
+        std::erase_if(windows, [](const auto& window) { return !window->is_open(); });
+
+        if (processed) {
+            settle_frames = SETTLE_FRAMES;
+        }
+        return processed;
+    };
+
+    const auto is_inactive = [&]() {
+        const auto size = w.getSize();
+        const bool any_focused = focused || std::any_of(windows.begin(), windows.end(), [](const auto& window) { return window->is_focused(); });
+        return !any_focused || size.x == 0 || size.y == 0;
+    };
+
+    // Blocks until there is a reason to render: input, a redraw request or an expired idle timeout.
+    // Returns true if the loop had to wait.
+    const auto wait_for_frame = [&]() {
+        const auto idle_deadline = std::chrono::steady_clock::now() + _idle_timeout;
+        bool waited = false;
+
+        for (; w.isOpen(); waited = true) {
+            const bool inactive = is_inactive();
+
+            if (!inactive && (settle_frames > 0 || _state->frame_requested || std::chrono::steady_clock::now() >= idle_deadline)) {
+                break;
+            }
+            if (w.pollEvent(event)) {
+                process_event(event);
+            } else if (process_window_events()) {
+                continue;
+            } else if (inactive) {
+                sf::sleep(sf::milliseconds(static_cast<sf::Int32>(IDLE_POLL_INTERVAL.count())));
+            } else {
+                std::unique_lock lock { _state->mutex };
+                _state->wake_up.wait_for(lock, IDLE_POLL_INTERVAL, [this]() { return _state->frame_requested.load(); });
+            }
+        }
+        return waited;
+    };
+
+    const std::function<void()> render_frame = [&]() {
+        render();
+        draw_overlay(_state->overlay_visible);
+    };
+    phase_clock phases {};
+    _state->overlay_visible = _overlay_mode == overlay_mode::visible;
+    running_app = this;
 
     while (w.isOpen()) {
+        phases.restart();
+        open_added_windows();
+
         while (w.pollEvent(event)) {
-            if (event.type == sf::Event::Closed) {
-                w.close();
-            } else {
-                ImGui::SFML::ProcessEvent(event);
+            process_event(event);
+        }
+        process_window_events();
+
+        if (_update_mode == update_mode::on_demand && wait_for_frame()) {
+            if (!w.isOpen()) {
+                break;
             }
+            // Time spent idle is neither frame time nor a missed deadline
+            pacer.reset();
+            phases.restart();
         }
+        phases.end_phase(frame_phase::events);
+        _state->frame_requested = false;
+        settle_frames = settle_frames > 0 ? settle_frames - 1 : 0;
+
         ImGui::SFML::Update(w, delta_clock.restart());
-        w.clear();
+        phases.end_phase(frame_phase::update);
+        auto frame = draw_frame(render_frame, phases, skipper, merger.get(), [&](ImDrawData& draw_data, const bool textures_changed) {
+            if (nullptr != presenter) {
+                // Waits for the previous frame, whose drawn pixels are reported instead
+                return presenter->submit(draw_data, textures_changed);
+            }
+            const auto drawn_pixels = draw_to_target(w, renderer.get(), retained.get(), draw_data, textures_changed);
+            _state->capture.read(w);
+            return drawn_pixels;
+        });
+
+        if (frame.skipped && _state->capture.is_capturing()) {
+            if (nullptr != presenter) {
+                // The frame in flight comes before the one the skipped frame repeats
+                presenter->finish();
+            }
+            _state->capture.repeat();
+        }
+
+        for (auto& window : windows) {
+            add_counters(frame.counters, window->draw(phases));
+        }
+        // The main window is presented last, its vsync wait paces all of them
+        if (!frame.skipped && nullptr == presenter) {
+            w.display();
+        }
+        phases.end_phase(frame_phase::display);
+        phases.end_frame();
+        _state->stats.add(phases.get_sample());
+        // A skipped frame didn't wait for vsync, the pacer waits instead
+        auto report = pacer.end_frame(frame.skipped);
+        report.counters = frame.counters;
+        {
+            std::scoped_lock lock { _state->mutex };
+            _state->last_frame_report = report;
+        }
+        ++frame_index;
+    }
+    running_app = nullptr;
+    presenter.reset();
+    // The main context owns the shared font atlas and goes last
+    windows.clear();
+    retained.reset();
+    renderer.reset();
+    ImGui::SFML::Shutdown();
+}
+
+void uxx::app::mainloop_headless(const headless& mode, const std::function<void()>& render) const
+{
+    constexpr bool load_default_font = false;
+
+    // The software renderer draws into memory and never needs an OpenGL context
+    std::unique_ptr<detail::software_renderer> software {};
+    std::unique_ptr<sf::RenderTexture> target {};
+
+    if (_renderer == renderer::software) {
+        software = std::make_unique<detail::software_renderer>();
+    } else {
+        target = std::make_unique<sf::RenderTexture>();
+
+        if (!target->create(_width, _height, get_context_settings(_renderer))) {
+            throw std::runtime_error("Unable to create offscreen render target");
+        }
+    }
+    const sf::Vector2f display_size { static_cast<float>(_width), static_cast<float>(_height) };
+    const auto delta_time = sf::microseconds(static_cast<sf::Int64>(mode.get_delta_time().count()));
+    // Keep the mouse outside of the screen until a replayed event moves it
+    sf::Vector2i mouse_position { -1, -1 };
+    bool closed = false;
+    std::optional<detail::input_player> player {};
+
+    if (!mode.get_input_replay().empty()) {
+        player.emplace(mode.get_input_replay());
+    }
+
+    const auto replay_event = [&](const sf::Event& e) {
+        switch (e.type) {
+        case sf::Event::Closed:
+            closed = true;
+            break;
+        case sf::Event::MouseMoved:
+            mouse_position = { e.mouseMove.x, e.mouseMove.y };
+            break;
+        case sf::Event::MouseButtonPressed:
+        case sf::Event::MouseButtonReleased:
+            mouse_position = { e.mouseButton.x, e.mouseButton.y };
+            break;
+        case sf::Event::MouseLeft:
+            mouse_position = { -1, -1 };
+            break;
+        default:
+            break;
+        }
+        ImGui::SFML::ProcessEvent(e);
+    };
+
+    ImGui::SFML::Init(display_size, load_default_font);
+    // Headless runs never read input devices, input only comes from the replay
+    ImGui::SFML::SetInputDevicesEnabled(false);
+    // Every run starts from the default layout, not from the one a windowed run saved
+    ImGui::GetIO().IniFilename = nullptr;
+    load_fonts(_font_cache_directory.value_or(detail::get_default_cache_directory()), software.get());
+    auto renderer = nullptr != target ? create_renderer(_renderer, *target) : nullptr;
+
+    detail::frame_pacer pacer { frame_policy::uncapped() };
+    frame_skipper skipper { _skip_unchanged_frames };
+    auto merger = _merge_draw_commands ? std::make_unique<detail::draw_command_merger>() : nullptr;
+    const std::function<void()> render_frame = [&]() {
         render();
-        ImGui::SFML::Render(w);
+        draw_overlay(_state->overlay_visible);
+    };
+    phase_clock phases {};
+    _state->overlay_visible = _overlay_mode == overlay_mode::visible;
+    running_app = this;
+
+    for (std::uint64_t frame_index = 0; !mode.is_done(frame_index); ++frame_index) {
+        phases.restart();
+        _state->frame_requested = false;
 
-        w.display();
-        sf::sleep(sf::milliseconds(10));
+        if (player) {
+            player->play(frame_index, replay_event);
+        }
+        if (closed) {
+            break;
+        }
+        phases.end_phase(frame_phase::events);
+
+        ImGui::SFML::Update(mouse_position, display_size, delta_time);
+        phases.end_phase(frame_phase::update);
+        // Partial redraw only pays off in windows, an offscreen target is never copied
+        const auto frame = draw_frame(render_frame, phases, skipper, merger.get(), [&](ImDrawData& draw_data, const bool textures_changed) {
+            if (nullptr != software) {
+                software->render(draw_data);
+                _state->capture.add(software->get_pixels(), software->get_width(), software->get_height());
+                return std::size_t { software->get_width() } * software->get_height();
+            }
+            const auto drawn_pixels = draw_to_target(*target, renderer.get(), nullptr, draw_data, textures_changed);
+            _state->capture.read(*target);
+            return drawn_pixels;
+        });
+
+        if (frame.skipped) {
+            _state->capture.repeat();
+        } else if (nullptr != target) {
+            target->display();
+        }
+        phases.end_phase(frame_phase::display);
+        phases.end_frame();
+        _state->stats.add(phases.get_sample());
+        auto report = pacer.end_frame(frame.skipped);
+        report.counters = frame.counters;
+        {
+            std::scoped_lock lock { _state->mutex };
+            _state->last_frame_report = report;
+        }
+    }
+    running_app = nullptr;
+
+    if (nullptr == target || target->setActive(true)) {
+        _state->capture.close();
+    }
+
+    if (!mode.get_output_image().empty()) {
+        sf::Image image {};
+
+        if (nullptr != software) {
+            image.create(software->get_width(), software->get_height(), software->get_pixels().data());
+        } else {
+            image = target->getTexture().copyToImage();
+        }
+        if (!image.saveToFile(mode.get_output_image().string())) {
+            throw std::runtime_error("Unable to save the output image");
+        }
     }
+    renderer.reset();
     ImGui::SFML::Shutdown();
 }
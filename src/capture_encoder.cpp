@@ -0,0 +1,281 @@
+#include "common.hpp"
+#include "capture_encoder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+namespace {
+
+// Full range BT.601 like JPEG, in 8.8 fixed point
+[[nodiscard]] std::uint8_t to_luma(const int r, const int g, const int b) noexcept
+{
+    return static_cast<std::uint8_t>((77 * r + 150 * g + 29 * b + 128) >> 8);
+}
+
+[[nodiscard]] std::uint8_t to_blue_difference(const int r, const int g, const int b) noexcept
+{
+    return static_cast<std::uint8_t>(std::clamp(128 + ((-43 * r - 85 * g + 128 * b + 128) >> 8), 0, 255));
+}
+
+[[nodiscard]] std::uint8_t to_red_difference(const int r, const int g, const int b) noexcept
+{
+    return static_cast<std::uint8_t>(std::clamp(128 + ((128 * r - 107 * g - 21 * b + 128) >> 8), 0, 255));
+}
+
+}
+
+uxx::detail::capture_encoder::capture_encoder(const std::filesystem::path& path, const uxx::app::capture_format format, const unsigned int frame_rate)
+    : _path(path)
+    , _format(format)
+    , _frame_rate(std::max(frame_rate, 1U))
+{
+    if (_format == uxx::app::capture_format::png_sequence) {
+        std::error_code error {};
+        std::filesystem::create_directories(_path, error);
+
+        if (!std::filesystem::is_directory(_path)) {
+            throw std::runtime_error("Unable to create capture directory: " + _path.generic_string());
+        }
+    } else {
+        _file.open(_path, std::ios::binary | std::ios::trunc);
+
+        if (!_file) {
+            throw std::runtime_error("Unable to create capture file: " + _path.generic_string());
+        }
+    }
+    // Started last, the thread must not outlive a constructor that throws
+    _thread = std::thread([this]() { run(); });
+}
+
+uxx::detail::capture_encoder::~capture_encoder() noexcept
+{
+    try {
+        finish();
+    } catch (...) {
+        // An error of the last frames has nobody left to report it to
+    }
+}
+
+std::vector<std::uint8_t> uxx::detail::capture_encoder::take_buffer()
+{
+    std::scoped_lock lock { _mutex };
+
+    if (_free_buffers.empty()) {
+        return {};
+    }
+    auto buffer = std::move(_free_buffers.back());
+    _free_buffers.pop_back();
+    return buffer;
+}
+
+bool uxx::detail::capture_encoder::submit(std::vector<std::uint8_t> pixels, const unsigned int width, const unsigned int height, const bool bottom_up)
+{
+    std::unique_lock lock { _mutex };
+    return enqueue(lock, { std::move(pixels), width, height, bottom_up, 0 });
+}
+
+void uxx::detail::capture_encoder::repeat()
+{
+    std::unique_lock lock { _mutex };
+
+    if (_queue.empty()) {
+        enqueue(lock, { {}, 0, 0, false, 1 });
+    } else {
+        ++_queue.back().repeats;
+    }
+}
+
+void uxx::detail::capture_encoder::finish()
+{
+    {
+        std::scoped_lock lock { _mutex };
+        _stopping = true;
+    }
+    _changed.notify_all();
+
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+    if (_file.is_open()) {
+        _file.close();
+
+        if (_file.fail()) {
+            throw std::runtime_error("Unable to write capture file: " + _path.generic_string());
+        }
+    }
+    if (_error) {
+        std::rethrow_exception(std::exchange(_error, nullptr));
+    }
+}
+
+std::size_t uxx::detail::capture_encoder::get_dropped_count() const noexcept
+{
+    return _dropped;
+}
+
+bool uxx::detail::capture_encoder::enqueue(std::unique_lock<std::mutex>& lock, frame f)
+{
+    if (_error) {
+        std::rethrow_exception(std::exchange(_error, nullptr));
+    }
+    if (_stopping || _queue.size() >= MAX_QUEUED_FRAMES) {
+        ++_dropped;
+        return false;
+    }
+    _queue.push_back(std::move(f));
+    lock.unlock();
+    _changed.notify_all();
+    return true;
+}
+
+void uxx::detail::capture_encoder::run()
+{
+    std::unique_lock lock { _mutex };
+
+    while (true) {
+        _changed.wait(lock, [this]() { return !_queue.empty() || _stopping; });
+
+        if (_queue.empty()) {
+            break;
+        }
+        auto f = std::move(_queue.front());
+        _queue.pop_front();
+        lock.unlock();
+
+        std::exception_ptr error {};
+
+        try {
+            encode(f);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        lock.lock();
+
+        if (error && !_error) {
+            _error = error;
+        }
+        if (!f.pixels.empty()) {
+            _free_buffers.push_back(std::move(f.pixels));
+        }
+    }
+}
+
+void uxx::detail::capture_encoder::encode(const frame& f)
+{
+    const bool is_video = _format != uxx::app::capture_format::png_sequence;
+
+    if (is_video && _frame_index > 0 && !f.pixels.empty() && (f.width != _width || f.height != _height)) {
+        // Its repeats still repeat the previous frame
+        ++_dropped;
+    } else if (f.width > 0 && f.height > 0) {
+        _width = f.width;
+        _height = f.height;
+        const std::size_t row_size = std::size_t { _width } * 4;
+        _previous.resize(row_size * _height);
+
+        for (std::size_t y = 0; y < _height; ++y) {
+            const auto source_row = f.bottom_up ? _height - 1 - y : y;
+            std::memcpy(_previous.data() + y * row_size, f.pixels.data() + source_row * row_size, row_size);
+        }
+        // The alpha of a framebuffer means nothing once it is on screen
+        for (std::size_t i = 3; i < _previous.size(); i += 4) {
+            _previous[i] = 255;
+        }
+        write_previous();
+    }
+    if (_previous.empty()) {
+        return;
+    }
+    for (std::size_t i = 0; i < f.repeats; ++i) {
+        write_previous();
+    }
+}
+
+void uxx::detail::capture_encoder::write_previous()
+{
+    switch (_format) {
+    case uxx::app::capture_format::png_sequence:
+        write_png();
+        break;
+    case uxx::app::capture_format::y4m:
+        write_y4m();
+        break;
+    case uxx::app::capture_format::raw_rgba:
+        write_raw();
+        break;
+    }
+    ++_frame_index;
+}
+
+void uxx::detail::capture_encoder::write_png()
+{
+    std::array<char, 32> name {};
+    std::snprintf(name.data(), name.size(), "frame_%06llu.png", static_cast<unsigned long long>(_frame_index));
+    const auto file = _path / name.data();
+    sf::Image image {};
+    image.create(_width, _height, _previous.data());
+
+    if (!image.saveToFile(file.string())) {
+        throw std::runtime_error("Unable to write capture image: " + file.generic_string());
+    }
+}
+
+void uxx::detail::capture_encoder::write_y4m()
+{
+    if (_frame_index == 0) {
+        _file << "YUV4MPEG2 W" << _width << " H" << _height << " F" << _frame_rate << ":1 Ip A1:1 C420jpeg XCOLORRANGE=FULL\n";
+    }
+    const std::size_t width = _width;
+    const std::size_t height = _height;
+    const std::size_t chroma_width = (width + 1) / 2;
+    const std::size_t chroma_height = (height + 1) / 2;
+    _planes.resize(width * height + 2 * chroma_width * chroma_height);
+    auto* luma = _planes.data();
+    auto* blue = luma + width * height;
+    auto* red = blue + chroma_width * chroma_height;
+
+    for (std::size_t i = 0; i < width * height; ++i) {
+        const auto* p = _previous.data() + i * 4;
+        luma[i] = to_luma(p[0], p[1], p[2]);
+    }
+    // Every chroma sample covers 2x2 pixels, fewer at the right and bottom edges of odd sizes
+    for (std::size_t cy = 0; cy < chroma_height; ++cy) {
+        for (std::size_t cx = 0; cx < chroma_width; ++cx) {
+            std::array<int, 3> sum {};
+            int count = 0;
+
+            for (auto y = cy * 2; y < std::min(cy * 2 + 2, height); ++y) {
+                for (auto x = cx * 2; x < std::min(cx * 2 + 2, width); ++x) {
+                    const auto* p = _previous.data() + (y * width + x) * 4;
+                    sum[0] += p[0];
+                    sum[1] += p[1];
+                    sum[2] += p[2];
+                    ++count;
+                }
+            }
+            const auto i = cy * chroma_width + cx;
+            blue[i] = to_blue_difference(sum[0] / count, sum[1] / count, sum[2] / count);
+            red[i] = to_red_difference(sum[0] / count, sum[1] / count, sum[2] / count);
+        }
+    }
+    _file << "FRAME\n";
+    _file.write(reinterpret_cast<const char*>(_planes.data()), static_cast<std::streamsize>(_planes.size()));
+
+    if (!_file) {
+        throw std::runtime_error("Unable to write capture file: " + _path.generic_string());
+    }
+}
+
+void uxx::detail::capture_encoder::write_raw()
+{
+    _file.write(reinterpret_cast<const char*>(_previous.data()), static_cast<std::streamsize>(_previous.size()));
+
+    if (!_file) {
+        throw std::runtime_error("Unable to write capture file: " + _path.generic_string());
+    }
+}
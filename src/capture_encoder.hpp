@@ -0,0 +1,95 @@
+#ifndef _UXX_CAPTURE_ENCODER_HPP
+#define _UXX_CAPTURE_ENCODER_HPP
+
+#include "common.hpp"
+#include "uxx/uxx.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace uxx::detail {
+
+/// Writes captured frames to a PNG sequence, a Y4M video or a raw RGBA file on a thread of its own.
+/// Frames are dropped instead of queued without bound when encoding falls behind, so the caller never waits.
+class capture_encoder {
+public:
+    /// Frames waiting to be encoded before further frames are dropped.
+    static constexpr std::size_t MAX_QUEUED_FRAMES { 8 };
+
+    /// \throw std::runtime_error If the file or directory can't be created.
+    explicit capture_encoder(const std::filesystem::path& path, uxx::app::capture_format format, unsigned int frame_rate);
+    /// Encodes the queued frames before the thread ends.
+    ~capture_encoder() noexcept;
+
+    capture_encoder(const capture_encoder&) = delete;
+    capture_encoder(capture_encoder&&) = delete;
+    capture_encoder& operator=(const capture_encoder&) = delete;
+    capture_encoder& operator=(capture_encoder&&) = delete;
+
+    /// \return Buffer of an encoded frame to fill with the next one, empty if there is none to reuse.
+    [[nodiscard]] std::vector<std::uint8_t> take_buffer();
+    /// Queue a frame of RGBA pixels for encoding. Rethrows the exception that encoding a previous frame threw.
+    /// \param bottom_up True if the last row comes first, like the pixels of glReadPixels.
+    /// \return False if the frame was dropped because the encoder fell behind.
+    bool submit(std::vector<std::uint8_t> pixels, unsigned int width, unsigned int height, bool bottom_up);
+    /// Encode the previous frame once more, for a frame that was skipped because nothing changed.
+    /// Repeats join the last queued frame, they never fill the queue. Rethrows like submit().
+    void repeat();
+    /// Encode every queued frame and close the output. Rethrows the exception that encoding a frame threw.
+    void finish();
+
+    /// \return Frames dropped because the encoder fell behind or because their size differs from a video's.
+    [[nodiscard]] std::size_t get_dropped_count() const noexcept;
+
+private:
+    struct frame {
+        std::vector<std::uint8_t> pixels;
+        unsigned int width;
+        unsigned int height;
+        bool bottom_up;
+        // Times the frame is encoded again after it, a frame without pixels only repeats the previous one
+        std::size_t repeats;
+    };
+
+    // Used by the encoding thread only
+    std::filesystem::path _path;
+    uxx::app::capture_format _format;
+    unsigned int _frame_rate;
+    std::ofstream _file {};
+    std::uint64_t _frame_index { 0 };
+    unsigned int _width { 0 };
+    unsigned int _height { 0 };
+    // Opaque RGBA pixels of the previous frame, row by row from the top
+    std::vector<std::uint8_t> _previous {};
+    std::vector<std::uint8_t> _planes {};
+
+    std::mutex _mutex {};
+    std::condition_variable _changed {};
+    std::deque<frame> _queue {};
+    std::vector<std::vector<std::uint8_t>> _free_buffers {};
+    bool _stopping { false };
+    std::exception_ptr _error {};
+    std::atomic<std::size_t> _dropped { 0 };
+    std::thread _thread {};
+
+    // Called with the lock held, which it releases before waking up the encoding thread
+    bool enqueue(std::unique_lock<std::mutex>& lock, frame f);
+    void run();
+    void encode(const frame& f);
+    void write_previous();
+    void write_png();
+    void write_y4m();
+    void write_raw();
+};
+
+}
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef _UXX_CLIP_CULLING_HPP
+#define _UXX_CLIP_CULLING_HPP
+
+#include "common.hpp"
+
+#include <algorithm>
+#include <span>
+
+namespace uxx::detail {
+
+/// Axis aligned box around the points of a shape.
+struct bounds {
+    ImVec2 min;
+    ImVec2 max;
+};
+
+/// How far the anti-aliased fringe of a filled shape may reach beyond its points, twice the fringe of half a pixel
+/// at the sharpest corners.
+inline constexpr float FILL_CULL_MARGIN { 1.0f };
+
+/// How far a line may reach beyond its points. Half the thickness and the fringe of a pixel are both doubled at the
+/// sharpest joints, and ImGui moves the points of lines and rectangles half a pixel to the center of their pixels.
+[[nodiscard]] inline float get_stroke_cull_margin(const float thickness) noexcept
+{
+    return thickness + 2.5f;
+}
+
+[[nodiscard]] inline bounds get_bounds(const ImVec2& p1, const ImVec2& p2) noexcept
+{
+    return { ImVec2 { std::min(p1.x, p2.x), std::min(p1.y, p2.y) }, ImVec2 { std::max(p1.x, p2.x), std::max(p1.y, p2.y) } };
+}
+
+/// \return The bounds of the points, which must not be empty.
+[[nodiscard]] inline bounds get_bounds(const std::span<const ImVec2> points) noexcept
+{
+    bounds b { points.front(), points.front() };
+
+    for (const auto& p : points.subspan(1)) {
+        b.min = ImVec2 { std::min(b.min.x, p.x), std::min(b.min.y, p.y) };
+        b.max = ImVec2 { std::max(b.max.x, p.x), std::max(b.max.y, p.y) };
+    }
+    return b;
+}
+
+/// \return True if the bounds, grown by margin on every side, lie entirely outside the current clip rectangle of the
+///         draw list, so nothing drawn within them can be seen.
+[[nodiscard]] inline bool is_clipped(const ImDrawList& draw_list, const bounds& b, const float margin) noexcept
+{
+    if (draw_list._ClipRectStack.empty()) {
+        return false;
+    }
+    const auto& clip = draw_list._ClipRectStack.back();
+    return b.max.x + margin < clip.x || b.max.y + margin < clip.y || b.min.x - margin > clip.z || b.min.y - margin > clip.w;
+}
+
+/// \return True if the bounds, grown by margin on every side, lie entirely inside the current clip rectangle.
+[[nodiscard]] inline bool is_unclipped(const ImDrawList& draw_list, const bounds& b, const float margin) noexcept
+{
+    if (draw_list._ClipRectStack.empty()) {
+        return true;
+    }
+    const auto& clip = draw_list._ClipRectStack.back();
+    return b.min.x - margin >= clip.x && b.min.y - margin >= clip.y && b.max.x + margin <= clip.z && b.max.y + margin <= clip.w;
+}
+
+}
+
+#endif
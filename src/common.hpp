@@ -22,4 +22,25 @@
 #pragma GCC diagnostic pop
 #endif
 
+#include <chrono>
+#include <cstddef>
+
+namespace uxx::detail {
+
+/// Ask the running application for another frame. Does nothing when no application is running.
+void request_animation_frame() noexcept;
+
+/// Account for bytes uploaded to a texture, reported in the counters of the current frame.
+void count_texture_upload(std::size_t bytes) noexcept;
+
+/// Account for pencil shapes left out because they were outside the clip rectangle, reported like count_texture_upload().
+void count_culled_primitives(std::size_t count) noexcept;
+
+using trace_clock = std::chrono::steady_clock;
+
+/// Record a complete trace event while a trace is running (see uxx::trace_scope).
+void add_trace_event(const char* name, trace_clock::time_point start, trace_clock::time_point end) noexcept;
+
+}
+
 #endif
@@ -0,0 +1,194 @@
+#include "common.hpp"
+#include "damage_tracker.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <span>
+
+namespace {
+
+// Read-only view of a draw list, either the current one or the copy of the previous frame
+struct list_view {
+    std::span<const ImDrawVert> vertices;
+    std::span<const ImDrawIdx> indices;
+    std::span<const ImDrawCmd> commands;
+};
+
+using triangle = std::array<const ImDrawVert*, 3>;
+
+class bounds {
+public:
+    void add(const ImVec4& rect) noexcept
+    {
+        if (!uxx::detail::is_empty(rect)) {
+            _rect = { std::min(_rect.x, rect.x), std::min(_rect.y, rect.y), std::max(_rect.z, rect.z), std::max(_rect.w, rect.w) };
+        }
+    }
+
+    /// Add the bounding box of the triangle, as far as it lies inside the clip rectangle.
+    void add(const triangle& t, const ImVec4& clip_rect) noexcept
+    {
+        ImVec4 rect { t[0]->pos.x, t[0]->pos.y, t[0]->pos.x, t[0]->pos.y };
+
+        for (const auto* vertex : t) {
+            rect = { std::min(rect.x, vertex->pos.x), std::min(rect.y, vertex->pos.y), std::max(rect.z, vertex->pos.x), std::max(rect.w, vertex->pos.y) };
+        }
+        // Degenerate triangles cover no pixels
+        add(ImVec4 { std::max(rect.x, clip_rect.x), std::max(rect.y, clip_rect.y), std::min(rect.z, clip_rect.z), std::min(rect.w, clip_rect.w) });
+    }
+
+    [[nodiscard]] const ImVec4& get() const noexcept
+    {
+        return _rect;
+    }
+
+private:
+    ImVec4 _rect { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+};
+
+[[nodiscard]] list_view view(const ImDrawList& list) noexcept
+{
+    return {
+        { list.VtxBuffer.Data, static_cast<std::size_t>(list.VtxBuffer.Size) },
+        { list.IdxBuffer.Data, static_cast<std::size_t>(list.IdxBuffer.Size) },
+        { list.CmdBuffer.Data, static_cast<std::size_t>(list.CmdBuffer.Size) }
+    };
+}
+
+[[nodiscard]] triangle get_triangle(const list_view& list, const ImDrawCmd& command, const std::size_t index) noexcept
+{
+    triangle t {};
+
+    for (std::size_t k = 0; k < t.size(); ++k) {
+        const auto vertex = command.VtxOffset + list.indices[command.IdxOffset + index * 3 + k];
+        t[k] = &list.vertices[vertex];
+    }
+    return t;
+}
+
+[[nodiscard]] bool equal(const triangle& a, const triangle& b) noexcept
+{
+    // ImDrawVert has no padding
+    return std::equal(a.begin(), a.end(), b.begin(), [](const ImDrawVert* x, const ImDrawVert* y) { return 0 == std::memcmp(x, y, sizeof(ImDrawVert)); });
+}
+
+[[nodiscard]] bool equal(const ImVec4& a, const ImVec4& b) noexcept
+{
+    return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w;
+}
+
+void add_command_damage(bounds& damage, const list_view& previous_list, const ImDrawCmd& previous, const list_view& current_list, const ImDrawCmd& current)
+{
+    if (!equal(previous.ClipRect, current.ClipRect) || previous.TextureId != current.TextureId) {
+        damage.add(previous.ClipRect);
+        damage.add(current.ClipRect);
+        return;
+    }
+    const std::size_t previous_count = previous.ElemCount / 3;
+    const std::size_t current_count = current.ElemCount / 3;
+
+    for (std::size_t i = 0; i < std::max(previous_count, current_count); ++i) {
+        if (i < previous_count && i < current_count) {
+            const auto a = get_triangle(previous_list, previous, i);
+            const auto b = get_triangle(current_list, current, i);
+
+            if (!equal(a, b)) {
+                damage.add(a, previous.ClipRect);
+                damage.add(b, current.ClipRect);
+            }
+        } else if (i < previous_count) {
+            damage.add(get_triangle(previous_list, previous, i), previous.ClipRect);
+        } else {
+            damage.add(get_triangle(current_list, current, i), current.ClipRect);
+        }
+    }
+}
+
+[[nodiscard]] bool has_user_callbacks(const std::span<const ImDrawCmd> commands) noexcept
+{
+    return std::any_of(commands.begin(), commands.end(), [](const ImDrawCmd& command) { return nullptr != command.UserCallback; });
+}
+
+}
+
+ImVec4 uxx::detail::damage_tracker::update(const ImDrawData& draw_data)
+{
+    const ImVec4 display {
+        draw_data.DisplayPos.x,
+        draw_data.DisplayPos.y,
+        draw_data.DisplayPos.x + draw_data.DisplaySize.x,
+        draw_data.DisplayPos.y + draw_data.DisplaySize.y
+    };
+    const auto count = static_cast<std::size_t>(draw_data.CmdListsCount);
+    bool full = !_valid || draw_data.DisplayPos.x != _display_pos.x || draw_data.DisplayPos.y != _display_pos.y
+        || draw_data.DisplaySize.x != _display_size.x || draw_data.DisplaySize.y != _display_size.y;
+    bounds damage {};
+
+    for (std::size_t i = 0; i < std::max(count, _lists.size()) && !full; ++i) {
+        const list_view empty {};
+        const auto previous = i < _lists.size() ? list_view { _lists[i].vertices, _lists[i].indices, _lists[i].commands } : empty;
+        const auto current = i < count ? view(*draw_data.CmdLists[i]) : empty;
+        // What a callback draws can't be compared
+        full = has_user_callbacks(previous.commands) || has_user_callbacks(current.commands);
+
+        for (std::size_t j = 0; j < std::max(previous.commands.size(), current.commands.size()) && !full; ++j) {
+            if (j < previous.commands.size() && j < current.commands.size()) {
+                add_command_damage(damage, previous, previous.commands[j], current, current.commands[j]);
+            } else if (j < previous.commands.size()) {
+                damage.add(previous.commands[j].ClipRect);
+            } else {
+                damage.add(current.commands[j].ClipRect);
+            }
+        }
+    }
+
+    _lists.resize(count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto current = view(*draw_data.CmdLists[i]);
+        _lists[i].vertices.assign(current.vertices.begin(), current.vertices.end());
+        _lists[i].indices.assign(current.indices.begin(), current.indices.end());
+        _lists[i].commands.assign(current.commands.begin(), current.commands.end());
+    }
+    _display_pos = draw_data.DisplayPos;
+    _display_size = draw_data.DisplaySize;
+    _valid = true;
+
+    if (full) {
+        return display;
+    }
+    const auto& rect = damage.get();
+
+    if (is_empty(rect)) {
+        return {};
+    }
+    // Pixels that triangles only partially cover change as well
+    return {
+        std::max(std::floor(rect.x), display.x),
+        std::max(std::floor(rect.y), display.y),
+        std::min(std::ceil(rect.z), display.z),
+        std::min(std::ceil(rect.w), display.w)
+    };
+}
+
+void uxx::detail::damage_tracker::reset() noexcept
+{
+    _valid = false;
+}
+
+void uxx::detail::clip_draw_data(ImDrawData& draw_data, const ImVec4& damage) noexcept
+{
+    for (int i = 0; i < draw_data.CmdListsCount; ++i) {
+        for (auto& command : draw_data.CmdLists[i]->CmdBuffer) {
+            auto& clip = command.ClipRect;
+            clip = { std::max(clip.x, damage.x), std::max(clip.y, damage.y), std::min(clip.z, damage.z), std::min(clip.w, damage.w) };
+
+            if (is_empty(clip)) {
+                clip = { damage.x, damage.y, damage.x, damage.y };
+            }
+        }
+    }
+}
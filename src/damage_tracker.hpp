@@ -0,0 +1,47 @@
+#ifndef _UXX_DAMAGE_TRACKER_HPP
+#define _UXX_DAMAGE_TRACKER_HPP
+
+#include "common.hpp"
+
+#include <vector>
+
+namespace uxx::detail {
+
+/// \return True if the rectangle (x1, y1, x2, y2), laid out like ImDrawCmd::ClipRect, covers no area.
+[[nodiscard]] inline bool is_empty(const ImVec4& rect) noexcept
+{
+    return rect.x >= rect.z || rect.y >= rect.w;
+}
+
+/// Limit the clip rectangle of every command to the damaged area. Commands outside of it get an empty clip rectangle,
+/// which renderers skip. Their indices stay, renderers that walk the indices of a list back to back still find the
+/// indices of the commands after them.
+void clip_draw_data(ImDrawData& draw_data, const ImVec4& damage) noexcept;
+
+/// Finds the area of the display that changed between two frames by comparing their draw data.
+/// Commands are compared in draw order, triangle by triangle, so a single changed glyph only damages the glyph.
+class damage_tracker {
+public:
+    /// Compare the draw data with the draw data of the previous call and keep a copy of it for the next one.
+    /// \return Rectangle in display coordinates, rounded out to whole pixels, that covers every pixel that may look
+    ///         different. Empty if nothing changed, the whole display after reset() or when the display changed.
+    [[nodiscard]] ImVec4 update(const ImDrawData& draw_data);
+    /// Forget the previous frame, the next update() damages the whole display.
+    void reset() noexcept;
+
+private:
+    struct draw_list {
+        std::vector<ImDrawVert> vertices;
+        std::vector<ImDrawIdx> indices;
+        std::vector<ImDrawCmd> commands;
+    };
+
+    std::vector<draw_list> _lists {};
+    ImVec2 _display_pos {};
+    ImVec2 _display_size {};
+    bool _valid { false };
+};
+
+}
+
+#endif
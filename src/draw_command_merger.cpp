@@ -0,0 +1,156 @@
+#include "common.hpp"
+#include "draw_command_merger.hpp"
+#include "damage_tracker.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+constexpr std::size_t NO_COMMAND { std::numeric_limits<std::size_t>::max() };
+
+[[nodiscard]] bool is_compatible(const ImDrawCmd& a, const ImDrawCmd& b) noexcept
+{
+    return nullptr == a.UserCallback && nullptr == b.UserCallback && a.TextureId == b.TextureId && a.VtxOffset == b.VtxOffset
+        && a.ClipRect.x == b.ClipRect.x && a.ClipRect.y == b.ClipRect.y && a.ClipRect.z == b.ClipRect.z && a.ClipRect.w == b.ClipRect.w;
+}
+
+[[nodiscard]] bool intersects(const ImVec4& a, const ImVec4& b) noexcept
+{
+    return a.x < b.z && b.x < a.z && a.y < b.w && b.y < a.w;
+}
+
+[[nodiscard]] ImVec4 unite(const ImVec4& a, const ImVec4& b) noexcept
+{
+    if (uxx::detail::is_empty(a)) {
+        return b;
+    }
+    if (uxx::detail::is_empty(b)) {
+        return a;
+    }
+    return { std::min(a.x, b.x), std::min(a.y, b.y), std::max(a.z, b.z), std::max(a.w, b.w) };
+}
+
+/// \return Bounding box of the command's triangles inside its clip rectangle, empty if it draws nothing.
+[[nodiscard]] ImVec4 get_bounds(const ImDrawList& list, const ImDrawCmd& command) noexcept
+{
+    constexpr float INF { std::numeric_limits<float>::infinity() };
+    ImVec4 bounds { INF, INF, -INF, -INF };
+    const auto* indices = list.IdxBuffer.Data + command.IdxOffset;
+    const auto* vertices = list.VtxBuffer.Data + command.VtxOffset;
+
+    for (unsigned int i = 0; i < command.ElemCount; ++i) {
+        const auto& pos = vertices[indices[i]].pos;
+        bounds = { std::min(bounds.x, pos.x), std::min(bounds.y, pos.y), std::max(bounds.z, pos.x), std::max(bounds.w, pos.y) };
+    }
+    const auto& clip = command.ClipRect;
+    return { std::max(bounds.x, clip.x), std::max(bounds.y, clip.y), std::min(bounds.z, clip.z), std::min(bounds.w, clip.w) };
+}
+
+}
+
+std::size_t uxx::detail::draw_command_merger::merge(ImDrawData& draw_data)
+{
+    std::size_t commands = 0;
+    draw_data.TotalIdxCount = 0;
+
+    for (int i = 0; i < draw_data.CmdListsCount; ++i) {
+        auto& list = *draw_data.CmdLists[i];
+        commands += merge(list);
+        draw_data.TotalIdxCount += list.IdxBuffer.Size;
+    }
+    return commands;
+}
+
+bool uxx::detail::draw_command_merger::overlaps(const group& g, const ImVec4& bounds) const noexcept
+{
+    if (!intersects(g.bounds, bounds)) {
+        return false;
+    }
+    if (g.size > MAX_MEMBER_TESTS) {
+        return true;
+    }
+    // The bounding box of a group spread over the screen, e.g. the captions of image tiles, overlaps a lot
+    for (auto c = g.first; c != NO_COMMAND; c = _next[c]) {
+        if (intersects(_bounds[c], bounds)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::size_t uxx::detail::draw_command_merger::merge(ImDrawList& list)
+{
+    const auto command_count = static_cast<std::size_t>(list.CmdBuffer.Size);
+    _groups.clear();
+    _next.assign(command_count, NO_COMMAND);
+    _bounds.resize(command_count);
+    // Groups before the last user callback stay where they are
+    std::size_t barrier = 0;
+
+    for (std::size_t c = 0; c < command_count; ++c) {
+        const auto& command = list.CmdBuffer[static_cast<int>(c)];
+
+        if (nullptr != command.UserCallback) {
+            _groups.push_back({ command, {}, c, c, 1 });
+            barrier = _groups.size();
+            continue;
+        }
+        if (command.ElemCount == 0) {
+            continue;
+        }
+        const auto bounds = get_bounds(list, command);
+        _bounds[c] = bounds;
+        auto target = _groups.size();
+
+        for (auto g = _groups.size(); g > barrier && _groups.size() - g < MAX_LOOKBACK; --g) {
+            const auto& candidate = _groups[g - 1];
+
+            if (is_compatible(candidate.command, command)) {
+                target = g - 1;
+                break;
+            }
+            if (overlaps(candidate, bounds)) {
+                break;
+            }
+        }
+        if (target == _groups.size()) {
+            _groups.push_back({ command, bounds, c, c, 1 });
+        } else {
+            auto& group = _groups[target];
+            group.bounds = unite(group.bounds, bounds);
+            _next[group.last] = c;
+            group.last = c;
+            ++group.size;
+        }
+    }
+    if (_groups.size() == command_count) {
+        // Nothing merged or dropped, the list is already in its final order
+        return command_count;
+    }
+    _indices.clear();
+    _commands.clear();
+
+    for (const auto& group : _groups) {
+        auto command = group.command;
+        command.IdxOffset = static_cast<unsigned int>(_indices.size());
+
+        if (nullptr == command.UserCallback) {
+            command.ElemCount = 0;
+
+            for (auto c = group.first; c != NO_COMMAND; c = _next[c]) {
+                const auto& member = list.CmdBuffer[static_cast<int>(c)];
+                const auto* first = list.IdxBuffer.Data + member.IdxOffset;
+                _indices.insert(_indices.end(), first, first + member.ElemCount);
+                command.ElemCount += member.ElemCount;
+            }
+        }
+        _commands.push_back(command);
+    }
+    // Empty commands were dropped, their indices aren't drawn anyway
+    list.IdxBuffer.resize(static_cast<int>(_indices.size()));
+    std::copy(_indices.begin(), _indices.end(), list.IdxBuffer.begin());
+    list.CmdBuffer.resize(static_cast<int>(_commands.size()));
+    std::copy(_commands.begin(), _commands.end(), list.CmdBuffer.begin());
+    return _commands.size();
+}
@@ -0,0 +1,50 @@
+#ifndef _UXX_DRAW_COMMAND_MERGER_HPP
+#define _UXX_DRAW_COMMAND_MERGER_HPP
+
+#include "common.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace uxx::detail {
+
+/// Merges draw commands that use the same texture and clip rectangle, so that fewer texture binds, scissor changes
+/// and draw calls reach the renderer. A command moves ahead of earlier commands to join a compatible one, but only
+/// past commands whose triangles it doesn't overlap, so the image stays the same. Nothing moves past user callbacks.
+class draw_command_merger {
+public:
+    /// Earlier groups of commands a command may move past, bounds the cost of a draw list with many commands.
+    static constexpr std::size_t MAX_LOOKBACK { 32 };
+    /// Commands of a group that are tested one by one for overlap, larger groups only test their bounding box.
+    static constexpr std::size_t MAX_MEMBER_TESTS { 16 };
+
+    /// Merge the commands of every draw list in place, rewriting the index buffers in the new draw order.
+    /// \return Number of draw commands left.
+    std::size_t merge(ImDrawData& draw_data);
+
+private:
+    struct group {
+        ImDrawCmd command;
+        // Area the triangles of the group's commands cover, (x1, y1, x2, y2) like ImDrawCmd::ClipRect
+        ImVec4 bounds;
+        std::size_t first;
+        std::size_t last;
+        std::size_t size;
+    };
+
+    // Buffers reused by every merge
+    std::vector<group> _groups {};
+    std::vector<std::size_t> _next {};
+    std::vector<ImVec4> _bounds {};
+    std::vector<ImDrawIdx> _indices {};
+    std::vector<ImDrawCmd> _commands {};
+
+    // \return Number of commands left in the list.
+    std::size_t merge(ImDrawList& list);
+    // \return True if any command of the group may cover a pixel inside the bounds.
+    [[nodiscard]] bool overlaps(const group& g, const ImVec4& bounds) const noexcept;
+};
+
+}
+
+#endif
@@ -0,0 +1,102 @@
+#include "common.hpp"
+#include "draw_data_hash.hpp"
+
+#include <array>
+#include <cstring>
+#include <type_traits>
+
+namespace {
+
+constexpr std::uint64_t SEED { 0x9E3779B97F4A7C15 };
+constexpr std::uint64_t MULTIPLIER { 0xFF51AFD7ED558CCD };
+
+[[nodiscard]] constexpr std::uint64_t mix(const std::uint64_t state, const std::uint64_t word) noexcept
+{
+    const auto x = (state ^ word) * MULTIPLIER;
+    return x ^ (x >> 32);
+}
+
+// Multiply-xor hash over 64-bit words. Large buffers are split across four independent lanes so that
+// the multiplications don't wait on each other, which keeps hashing close to memory bandwidth.
+class hasher {
+public:
+    void add_bytes(const void* data, const std::size_t size) noexcept
+    {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        std::size_t offset = 0;
+
+        for (; offset + sizeof(std::uint64_t) * LANES <= size; offset += sizeof(std::uint64_t) * LANES) {
+            for (std::size_t lane = 0; lane < LANES; ++lane) {
+                _lanes[lane] = mix(_lanes[lane], load(bytes + offset + lane * sizeof(std::uint64_t)));
+            }
+        }
+        for (; offset + sizeof(std::uint64_t) <= size; offset += sizeof(std::uint64_t)) {
+            _lanes[0] = mix(_lanes[0], load(bytes + offset));
+        }
+        if (offset < size) {
+            std::uint64_t tail { 0 };
+            std::memcpy(&tail, bytes + offset, size - offset);
+            _lanes[0] = mix(_lanes[0], tail);
+        }
+        // Buffers of different lengths must not hash alike when one is a prefix of the other
+        _lanes[1] = mix(_lanes[1], size);
+    }
+
+    template <typename T>
+    void add(const T& value) noexcept requires std::is_trivially_copyable_v<T>
+    {
+        add_bytes(&value, sizeof(T));
+    }
+
+    [[nodiscard]] std::uint64_t get() const noexcept
+    {
+        std::uint64_t state { SEED };
+
+        for (const auto lane : _lanes) {
+            state = mix(state, lane);
+        }
+        return state;
+    }
+
+private:
+    static constexpr std::size_t LANES { 4 };
+
+    std::array<std::uint64_t, LANES> _lanes { SEED, SEED + 1, SEED + 2, SEED + 3 };
+
+    [[nodiscard]] static std::uint64_t load(const unsigned char* bytes) noexcept
+    {
+        std::uint64_t word { 0 };
+        std::memcpy(&word, bytes, sizeof(word));
+        return word;
+    }
+};
+
+}
+
+std::optional<std::uint64_t> uxx::detail::hash_draw_data(const ImDrawData& draw_data) noexcept
+{
+    hasher h {};
+    h.add(draw_data.DisplayPos);
+    h.add(draw_data.DisplaySize);
+    h.add(draw_data.FramebufferScale);
+    h.add(draw_data.CmdListsCount);
+
+    for (int i = 0; i < draw_data.CmdListsCount; ++i) {
+        const auto& list = *draw_data.CmdLists[i];
+        h.add_bytes(list.VtxBuffer.Data, static_cast<std::size_t>(list.VtxBuffer.size_in_bytes()));
+        h.add_bytes(list.IdxBuffer.Data, static_cast<std::size_t>(list.IdxBuffer.size_in_bytes()));
+
+        // Field by field, the padding of ImDrawCmd is uninitialized
+        for (const auto& command : list.CmdBuffer) {
+            if (nullptr != command.UserCallback) {
+                return std::nullopt;
+            }
+            h.add(command.ClipRect);
+            h.add(command.TextureId);
+            h.add(command.VtxOffset);
+            h.add(command.IdxOffset);
+            h.add(command.ElemCount);
+        }
+    }
+    return h.get();
+}
@@ -0,0 +1,20 @@
+#ifndef _UXX_DRAW_DATA_HASH_HPP
+#define _UXX_DRAW_DATA_HASH_HPP
+
+#include "common.hpp"
+
+#include <cstdint>
+#include <optional>
+
+namespace uxx::detail {
+
+/// Hash the display geometry and the vertex, index and command buffers of every draw list.
+/// Equal hashes mean that rendering the draw data again would produce the same image, as long as
+/// no texture has changed in between.
+///
+/// \return Nothing if the draw data can't be compared, i.e. it has user callbacks.
+[[nodiscard]] std::optional<std::uint64_t> hash_draw_data(const ImDrawData& draw_data) noexcept;
+
+}
+
+#endif
@@ -0,0 +1,519 @@
+#include "common.hpp"
+#include "draw_list.hpp"
+#include "clip_culling.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+
+namespace {
+
+// The vertices and indices of one line, like ImDrawList::AddPolyline() writes them for two points
+constexpr std::size_t THIN_LINE_VERTICES { 6 };
+constexpr std::array<std::size_t, 12> THIN_LINE_INDICES { 3, 0, 2, 2, 5, 3, 4, 1, 0, 0, 3, 4 };
+constexpr std::size_t THICK_LINE_VERTICES { 8 };
+constexpr std::array<std::size_t, 18> THICK_LINE_INDICES { 5, 1, 2, 2, 6, 5, 5, 1, 0, 0, 4, 5, 6, 2, 3, 3, 7, 6 };
+constexpr std::size_t TEXTURED_LINE_VERTICES { 4 };
+constexpr std::array<std::size_t, 6> TEXTURED_LINE_INDICES { 2, 0, 1, 3, 1, 2 };
+constexpr std::size_t ALIASED_LINE_VERTICES { 4 };
+constexpr std::array<std::size_t, 6> QUAD_INDICES { 0, 1, 2, 0, 2, 3 };
+
+// The vertices and indices of one triangle, like ImDrawList::AddConvexPolyFilled() writes them for three points
+constexpr std::size_t TRIANGLE_VERTICES { 6 };
+constexpr std::array<std::size_t, 21> TRIANGLE_INDICES { 0, 2, 4, 0, 4, 5, 5, 1, 0, 2, 0, 1, 1, 3, 2, 4, 2, 3, 3, 5, 4 };
+constexpr std::size_t ALIASED_TRIANGLE_VERTICES { 3 };
+constexpr std::array<std::size_t, 3> ALIASED_TRIANGLE_INDICES { 0, 1, 2 };
+
+constexpr float AA_SIZE { 1.0f };
+
+[[nodiscard]] ImVec2 from_vec2d(const uxx::vec2d& point) noexcept
+{
+    return ImVec2 { point.x, point.y };
+}
+
+// Same as IM_NORMALIZE2F_OVER_ZERO
+[[nodiscard]] ImVec2 normalize_over_zero(ImVec2 v) noexcept
+{
+    const float d2 = v.x * v.x + v.y * v.y;
+
+    if (d2 > 0.0f) {
+        const float inv_len = 1.0f / std::sqrt(d2);
+        v.x *= inv_len;
+        v.y *= inv_len;
+    }
+    return v;
+}
+
+// Same as IM_FIXNORMAL2F
+[[nodiscard]] ImVec2 fix_normal(ImVec2 v) noexcept
+{
+    const float d2 = std::max(v.x * v.x + v.y * v.y, 0.5f);
+    const float inv_lensq = 1.0f / d2;
+    v.x *= inv_lensq;
+    v.y *= inv_lensq;
+    return v;
+}
+
+[[nodiscard]] ImVec2 normal(const ImVec2& from, const ImVec2& to) noexcept
+{
+    const auto direction = normalize_over_zero(ImVec2 { to.x - from.x, to.y - from.y });
+    return ImVec2 { direction.y, -direction.x };
+}
+
+[[nodiscard]] ImVec2 offset(const ImVec2& p, const ImVec2& n, const float scale) noexcept
+{
+    return ImVec2 { p.x + n.x * scale, p.y + n.y * scale };
+}
+
+// The texture coordinates of the baked line in the font atlas that ImDrawList::AddPolyline() draws anti-aliased lines of
+// this thickness with, one pair for either edge, or nothing if it draws them with a fringe of vertices instead
+[[nodiscard]] std::optional<ImVec4> get_line_uvs(const ImDrawList& draw_list, float thickness) noexcept
+{
+    if ((draw_list.Flags & ImDrawListFlags_AntiAliasedLinesUseTex) == 0) {
+        return std::nullopt;
+    }
+    // Thinner lines are drawn one pixel thick
+    thickness = std::max(thickness, 1.0f);
+    const int integer_thickness = static_cast<int>(thickness);
+    const float fractional_thickness = thickness - static_cast<float>(integer_thickness);
+
+    if (integer_thickness >= IM_DRAWLIST_TEX_LINES_WIDTH_MAX || fractional_thickness > 0.00001f) {
+        return std::nullopt;
+    }
+    const auto* lines = ImGui::GetFont()->ContainerAtlas->TexUvLines;
+    auto uvs = lines[integer_thickness];
+
+    if (fractional_thickness > 0.0f) {
+        const auto& next = lines[integer_thickness + 1];
+        uvs.x += (next.x - uvs.x) * fractional_thickness;
+        uvs.y += (next.y - uvs.y) * fractional_thickness;
+        uvs.z += (next.z - uvs.z) * fractional_thickness;
+        uvs.w += (next.w - uvs.w) * fractional_thickness;
+    }
+    return uvs;
+}
+
+// Reserve the geometry of a chunk of items at once and let write() fill it in, one visible item after the other.
+// With 16-bit indices a chunk never needs more than 64k vertices, so that ImGui can start every chunk at a new vertex
+// offset when the draw list has ImDrawListFlags_AllowVtxOffset, which it sets when the renderer supports them.
+// \return The number of items left out because is_visible() said they lie outside the clip rectangle.
+template <typename T, typename V, typename F>
+std::size_t add_bulk(ImDrawList& draw_list, const std::span<const T> items, const std::size_t index_count, const std::size_t vertex_count, V&& is_visible, F&& write)
+{
+    const std::size_t chunk_size = sizeof(ImDrawIdx) > 2 ? items.size() : uxx::detail::MAX_BULK_CHUNK_VERTICES / vertex_count;
+    std::size_t culled = 0;
+
+    for (std::size_t first = 0; first < items.size(); first += chunk_size) {
+        const auto chunk = items.subspan(first, std::min(chunk_size, items.size() - first));
+        draw_list.PrimReserve(static_cast<int>(chunk.size() * index_count), static_cast<int>(chunk.size() * vertex_count));
+        std::size_t chunk_culled = 0;
+
+        for (const auto& item : chunk) {
+            if (is_visible(item)) {
+                write(item);
+            } else {
+                ++chunk_culled;
+            }
+        }
+        // Culled items were reserved all the same
+        draw_list.PrimUnreserve(static_cast<int>(chunk_culled * index_count), static_cast<int>(chunk_culled * vertex_count));
+        culled += chunk_culled;
+    }
+    return culled;
+}
+
+void write_vertex(ImDrawList& draw_list, const ImVec2& position, const ImVec2& uv, const ImU32 color) noexcept
+{
+    auto& vertex = *draw_list._VtxWritePtr++;
+    vertex.pos = position;
+    vertex.uv = uv;
+    vertex.col = color;
+}
+
+// Write the indices of an item relative to its first vertex, and move on to the vertices of the next item
+template <std::size_t N>
+void write_indices(ImDrawList& draw_list, const std::array<std::size_t, N>& indices, const std::size_t vertex_count) noexcept
+{
+    const std::size_t first = draw_list._VtxCurrentIdx;
+
+    for (const auto index : indices) {
+        *draw_list._IdxWritePtr++ = static_cast<ImDrawIdx>(first + index);
+    }
+    draw_list._VtxCurrentIdx += static_cast<unsigned int>(vertex_count);
+}
+
+}
+
+void uxx::detail::add_polyline(ImDrawList& draw_list, const std::span<const ImVec2> points, const ImU32 color, const bool closed, const float thickness)
+{
+    if constexpr (sizeof(ImDrawIdx) > 2) {
+        draw_list.AddPolyline(points.data(), static_cast<int>(points.size()), color, closed, thickness);
+    } else {
+        if (points.size() <= MAX_POLYLINE_CHUNK_POINTS) {
+            draw_list.AddPolyline(points.data(), static_cast<int>(points.size()), color, closed, thickness);
+            return;
+        }
+        // Consecutive chunks share an end point. Each chunk becomes its own primitive, which the renderer
+        // places at a new vertex offset (ImGuiBackendFlags_RendererHasVtxOffset)
+        for (std::size_t first = 0; first + 1 < points.size(); first += MAX_POLYLINE_CHUNK_POINTS - 1) {
+            const auto remaining = points.size() - first;
+            const auto count = remaining < MAX_POLYLINE_CHUNK_POINTS ? remaining : MAX_POLYLINE_CHUNK_POINTS;
+            draw_list.AddPolyline(points.data() + first, static_cast<int>(count), color, false, thickness);
+        }
+        if (closed) {
+            const std::array<ImVec2, 2> closing_segment { points.back(), points.front() };
+            draw_list.AddPolyline(closing_segment.data(), 2, color, false, thickness);
+        }
+    }
+}
+
+std::size_t uxx::detail::add_visible_polyline(ImDrawList& draw_list, const std::span<const ImVec2> points, const ImU32 color, const bool closed, const float thickness)
+{
+    if (points.size() < 2) {
+        return 0;
+    }
+    const std::size_t segment_count = closed ? points.size() : points.size() - 1;
+    const float margin = get_stroke_cull_margin(thickness);
+    const auto b = get_bounds(points);
+
+    if (is_clipped(draw_list, b, margin)) {
+        return segment_count;
+    }
+    if (closed || is_unclipped(draw_list, b, margin)) {
+        add_polyline(draw_list, points, color, closed, thickness);
+        return 0;
+    }
+    // Every run of visible segments is drawn with one hidden segment on either side, so that the joints of its first
+    // and last points are the same as those of the whole polyline. The hidden ends lie outside the clip rectangle.
+    const auto is_visible = [&](const std::size_t i) { return !is_clipped(draw_list, get_bounds(points[i], points[i + 1]), margin); };
+    const auto add_run = [&](const std::size_t first, const std::size_t last) {
+        add_polyline(draw_list, points.subspan(first, last - first + 2), color, false, thickness);
+    };
+    constexpr auto none = static_cast<std::size_t>(-1);
+    std::size_t first = none;
+    std::size_t last = 0;
+    std::size_t drawn = 0;
+
+    for (std::size_t i = 0; i < segment_count; ++i) {
+        if (is_visible(i)) {
+            first = first == none ? (i > 0 ? i - 1 : 0) : first;
+            last = i;
+        } else if (first != none && i > last + 1) {
+            add_run(first, i - 1);
+            drawn += i - first;
+            first = none;
+        }
+    }
+    if (first != none) {
+        const auto end = std::min(last + 1, segment_count - 1);
+        add_run(first, end);
+        drawn += end - first + 1;
+    }
+    return segment_count - drawn;
+}
+
+std::span<const ImVec2> uxx::detail::as_im_vec2(const std::span<const uxx::vec2d> points) noexcept
+{
+    static_assert(sizeof(uxx::vec2d) == sizeof(ImVec2) && alignof(uxx::vec2d) == alignof(ImVec2));
+    static_assert(std::is_standard_layout_v<uxx::vec2d> && std::is_standard_layout_v<ImVec2>);
+    static_assert(offsetof(uxx::vec2d, x) == offsetof(ImVec2, x) && offsetof(uxx::vec2d, y) == offsetof(ImVec2, y));
+    return { reinterpret_cast<const ImVec2*>(points.data()), points.size() };
+}
+
+std::span<const ImVec2> uxx::detail::gather_path(ImDrawList& draw_list, const uxx::strided_points& points)
+{
+    const auto* x = reinterpret_cast<const std::byte*>(points.x);
+    const auto* y = reinterpret_cast<const std::byte*>(points.y);
+    auto& path = draw_list._Path;
+    path.resize(static_cast<int>(points.count));
+
+    for (std::size_t i = 0; i < points.count; ++i) {
+        const auto offset = i * points.stride;
+        path[static_cast<int>(i)] = ImVec2 { *reinterpret_cast<const float*>(x + offset), *reinterpret_cast<const float*>(y + offset) };
+    }
+    return { path.Data, points.count };
+}
+
+std::size_t uxx::detail::add_lines(ImDrawList& draw_list, const std::span<const uxx::segment> segments, const ImU32 color, const float thickness)
+{
+    if ((color & IM_COL32_A_MASK) == 0) {
+        return 0;
+    }
+    const float margin = get_stroke_cull_margin(thickness);
+    const auto is_visible = [&](const uxx::segment& s) { return !is_clipped(draw_list, get_bounds(from_vec2d(s.from), from_vec2d(s.to)), margin); };
+
+    const auto uv = ImGui::GetFontTexUvWhitePixel();
+    const ImU32 transparent = color & ~IM_COL32_A_MASK;
+    // ImDrawList::AddLine() moves the end points to the center of their pixels
+    const auto center = [](const uxx::vec2d& p) { return ImVec2 { p.x + 0.5f, p.y + 0.5f }; };
+
+    if ((draw_list.Flags & ImDrawListFlags_AntiAliasedLines) == 0) {
+        return add_bulk(draw_list, segments, QUAD_INDICES.size(), ALIASED_LINE_VERTICES, is_visible, [&](const uxx::segment& s) {
+            const auto p1 = center(s.from);
+            const auto p2 = center(s.to);
+            const auto n = normal(p1, p2);
+            const float half_thickness = thickness * 0.5f;
+            write_vertex(draw_list, offset(p1, n, half_thickness), uv, color);
+            write_vertex(draw_list, offset(p2, n, half_thickness), uv, color);
+            write_vertex(draw_list, offset(p2, n, -half_thickness), uv, color);
+            write_vertex(draw_list, offset(p1, n, -half_thickness), uv, color);
+            write_indices(draw_list, QUAD_INDICES, ALIASED_LINE_VERTICES);
+        });
+    }
+    if (const auto line_uvs = get_line_uvs(draw_list, thickness)) {
+        // A quad over the line and its fringe, textured with the baked line of the same thickness
+        const ImVec2 uv0 { line_uvs->x, line_uvs->y };
+        const ImVec2 uv1 { line_uvs->z, line_uvs->w };
+        const float half_draw_size = std::max(thickness, 1.0f) * 0.5f + 1.0f;
+
+        return add_bulk(draw_list, segments, TEXTURED_LINE_INDICES.size(), TEXTURED_LINE_VERTICES, is_visible, [&](const uxx::segment& s) {
+            const auto p1 = center(s.from);
+            const auto p2 = center(s.to);
+            const auto n = normal(p1, p2);
+            const auto end_normal = fix_normal(n);
+            write_vertex(draw_list, offset(p1, n, half_draw_size), uv0, color);
+            write_vertex(draw_list, offset(p1, n, -half_draw_size), uv1, color);
+            write_vertex(draw_list, offset(p2, end_normal, half_draw_size), uv0, color);
+            write_vertex(draw_list, offset(p2, end_normal, -half_draw_size), uv1, color);
+            write_indices(draw_list, TEXTURED_LINE_INDICES, TEXTURED_LINE_VERTICES);
+        });
+    }
+    if (thickness <= 1.0f) {
+        // A solid center with a fringe of one pixel on either side
+        return add_bulk(draw_list, segments, THIN_LINE_INDICES.size(), THIN_LINE_VERTICES, is_visible, [&](const uxx::segment& s) {
+            const auto p1 = center(s.from);
+            const auto p2 = center(s.to);
+            const auto n = normal(p1, p2);
+            const auto end_normal = fix_normal(n);
+            write_vertex(draw_list, p1, uv, color);
+            write_vertex(draw_list, offset(p1, n, AA_SIZE), uv, transparent);
+            write_vertex(draw_list, offset(p1, n, -AA_SIZE), uv, transparent);
+            write_vertex(draw_list, p2, uv, color);
+            write_vertex(draw_list, offset(p2, end_normal, AA_SIZE), uv, transparent);
+            write_vertex(draw_list, offset(p2, end_normal, -AA_SIZE), uv, transparent);
+            write_indices(draw_list, THIN_LINE_INDICES, THIN_LINE_VERTICES);
+        });
+    }
+    // A solid core with a fringe of one pixel on either side
+    const float half_inner = (thickness - AA_SIZE) * 0.5f;
+    const float half_outer = half_inner + AA_SIZE;
+
+    return add_bulk(draw_list, segments, THICK_LINE_INDICES.size(), THICK_LINE_VERTICES, is_visible, [&](const uxx::segment& s) {
+        const auto p1 = center(s.from);
+        const auto p2 = center(s.to);
+        const auto n = normal(p1, p2);
+        const auto end_normal = fix_normal(n);
+        write_vertex(draw_list, offset(p1, n, half_outer), uv, transparent);
+        write_vertex(draw_list, offset(p1, n, half_inner), uv, color);
+        write_vertex(draw_list, offset(p1, n, -half_inner), uv, color);
+        write_vertex(draw_list, offset(p1, n, -half_outer), uv, transparent);
+        write_vertex(draw_list, offset(p2, end_normal, half_outer), uv, transparent);
+        write_vertex(draw_list, offset(p2, end_normal, half_inner), uv, color);
+        write_vertex(draw_list, offset(p2, end_normal, -half_inner), uv, color);
+        write_vertex(draw_list, offset(p2, end_normal, -half_outer), uv, transparent);
+        write_indices(draw_list, THICK_LINE_INDICES, THICK_LINE_VERTICES);
+    });
+}
+
+std::size_t uxx::detail::add_rects_filled(ImDrawList& draw_list, const std::span<const uxx::rect> rects, const ImU32 color)
+{
+    if ((color & IM_COL32_A_MASK) == 0) {
+        return 0;
+    }
+    const auto uv = ImGui::GetFontTexUvWhitePixel();
+    const auto is_visible = [&](const uxx::rect& r) { return !is_clipped(draw_list, get_bounds(from_vec2d(r.min), from_vec2d(r.max)), FILL_CULL_MARGIN); };
+
+    return add_bulk(draw_list, rects, QUAD_INDICES.size(), 4, is_visible, [&](const uxx::rect& r) {
+        write_vertex(draw_list, ImVec2 { r.min.x, r.min.y }, uv, color);
+        write_vertex(draw_list, ImVec2 { r.max.x, r.min.y }, uv, color);
+        write_vertex(draw_list, ImVec2 { r.max.x, r.max.y }, uv, color);
+        write_vertex(draw_list, ImVec2 { r.min.x, r.max.y }, uv, color);
+        write_indices(draw_list, QUAD_INDICES, 4);
+    });
+}
+
+std::size_t uxx::detail::add_triangles_filled(ImDrawList& draw_list, const std::span<const uxx::triangle> triangles, const ImU32 color)
+{
+    if ((color & IM_COL32_A_MASK) == 0) {
+        return 0;
+    }
+    const auto uv = ImGui::GetFontTexUvWhitePixel();
+    const auto is_visible = [&](const uxx::triangle& t) {
+        const std::array<ImVec2, 3> points { from_vec2d(t.p1), from_vec2d(t.p2), from_vec2d(t.p3) };
+        return !is_clipped(draw_list, get_bounds(points), FILL_CULL_MARGIN);
+    };
+
+    if ((draw_list.Flags & ImDrawListFlags_AntiAliasedFill) == 0) {
+        return add_bulk(draw_list, triangles, ALIASED_TRIANGLE_INDICES.size(), ALIASED_TRIANGLE_VERTICES, is_visible, [&](const uxx::triangle& t) {
+            write_vertex(draw_list, from_vec2d(t.p1), uv, color);
+            write_vertex(draw_list, from_vec2d(t.p2), uv, color);
+            write_vertex(draw_list, from_vec2d(t.p3), uv, color);
+            write_indices(draw_list, ALIASED_TRIANGLE_INDICES, ALIASED_TRIANGLE_VERTICES);
+        });
+    }
+    const ImU32 transparent = color & ~IM_COL32_A_MASK;
+
+    // Every corner gets an inner vertex and an outer one half a pixel either side of the edges
+    return add_bulk(draw_list, triangles, TRIANGLE_INDICES.size(), TRIANGLE_VERTICES, is_visible, [&](const uxx::triangle& t) {
+        const std::array<ImVec2, 3> points { from_vec2d(t.p1), from_vec2d(t.p2), from_vec2d(t.p3) };
+        const std::array<ImVec2, 3> normals { normal(points[0], points[1]), normal(points[1], points[2]), normal(points[2], points[0]) };
+
+        for (std::size_t i1 = 0, i0 = 2; i1 < points.size(); i0 = i1++) {
+            const auto n = fix_normal(ImVec2 { (normals[i0].x + normals[i1].x) * 0.5f, (normals[i0].y + normals[i1].y) * 0.5f });
+            write_vertex(draw_list, offset(points[i1], n, -AA_SIZE * 0.5f), uv, color);
+            write_vertex(draw_list, offset(points[i1], n, AA_SIZE * 0.5f), uv, transparent);
+        }
+        write_indices(draw_list, TRIANGLE_INDICES, TRIANGLE_VERTICES);
+    });
+}
+
+void uxx::detail::add_polygon(ImDrawList& draw_list, const shape_cache::polygon& polygon, const ImVec2& center, const float radius, const ImU32 color, const float thickness)
+{
+    if ((color & IM_COL32_A_MASK) == 0 || polygon.corners.size() < 3) {
+        return;
+    }
+    const std::size_t count = polygon.corners.size();
+    const auto corner = [&](const std::size_t i) { return offset(center, polygon.corners[i], radius); };
+    const auto uv = ImGui::GetFontTexUvWhitePixel();
+    const ImU32 transparent = color & ~IM_COL32_A_MASK;
+
+    if ((draw_list.Flags & ImDrawListFlags_AntiAliasedLines) == 0) {
+        // A quad per edge, like an aliased ImDrawList::AddPolyline()
+        draw_list.PrimReserve(static_cast<int>(count * QUAD_INDICES.size()), static_cast<int>(count * ALIASED_LINE_VERTICES));
+        const float half_thickness = thickness * 0.5f;
+
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto p1 = corner(i);
+            const auto p2 = corner((i + 1) % count);
+            const auto& n = polygon.edge_normals[i];
+            write_vertex(draw_list, offset(p1, n, half_thickness), uv, color);
+            write_vertex(draw_list, offset(p2, n, half_thickness), uv, color);
+            write_vertex(draw_list, offset(p2, n, -half_thickness), uv, color);
+            write_vertex(draw_list, offset(p1, n, -half_thickness), uv, color);
+            write_indices(draw_list, QUAD_INDICES, ALIASED_LINE_VERTICES);
+        }
+        return;
+    }
+    // Every corner gets the vertices of one end of a line, see add_lines(), shared by the edges that meet there
+    const auto line_uvs = get_line_uvs(draw_list, thickness);
+    const bool thick = thickness > 1.0f;
+    const std::size_t vertices_per_corner = line_uvs ? TEXTURED_LINE_VERTICES / 2 : (thick ? 4 : 3);
+    const std::size_t indices_per_edge = line_uvs ? TEXTURED_LINE_INDICES.size() : (thick ? THICK_LINE_INDICES.size() : THIN_LINE_INDICES.size());
+    draw_list.PrimReserve(static_cast<int>(count * indices_per_edge), static_cast<int>(count * vertices_per_corner));
+    const std::size_t first = draw_list._VtxCurrentIdx;
+    const float half_draw_size = std::max(thickness, 1.0f) * 0.5f + 1.0f;
+    const float half_inner = (thickness - AA_SIZE) * 0.5f;
+    const float half_outer = half_inner + AA_SIZE;
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto p = corner(i);
+        const auto& n = polygon.corner_normals[i];
+
+        if (line_uvs) {
+            write_vertex(draw_list, offset(p, n, half_draw_size), ImVec2 { line_uvs->x, line_uvs->y }, color);
+            write_vertex(draw_list, offset(p, n, -half_draw_size), ImVec2 { line_uvs->z, line_uvs->w }, color);
+        } else if (thick) {
+            write_vertex(draw_list, offset(p, n, half_outer), uv, transparent);
+            write_vertex(draw_list, offset(p, n, half_inner), uv, color);
+            write_vertex(draw_list, offset(p, n, -half_inner), uv, color);
+            write_vertex(draw_list, offset(p, n, -half_outer), uv, transparent);
+        } else {
+            write_vertex(draw_list, p, uv, color);
+            write_vertex(draw_list, offset(p, n, AA_SIZE), uv, transparent);
+            write_vertex(draw_list, offset(p, n, -AA_SIZE), uv, transparent);
+        }
+    }
+    // The line indices address both ends of an edge as if they were consecutive, the last edge wraps to the first corner
+    const auto write_edge = [&](const auto& indices, const std::size_t i) {
+        const auto start = first + i * vertices_per_corner;
+        const auto end = first + ((i + 1) % count) * vertices_per_corner;
+
+        for (const auto index : indices) {
+            const auto vertex = index < vertices_per_corner ? start + index : end + index - vertices_per_corner;
+            *draw_list._IdxWritePtr++ = static_cast<ImDrawIdx>(vertex);
+        }
+    };
+    for (std::size_t i = 0; i < count; ++i) {
+        if (line_uvs) {
+            write_edge(TEXTURED_LINE_INDICES, i);
+        } else if (thick) {
+            write_edge(THICK_LINE_INDICES, i);
+        } else {
+            write_edge(THIN_LINE_INDICES, i);
+        }
+    }
+    draw_list._VtxCurrentIdx += static_cast<unsigned int>(count * vertices_per_corner);
+}
+
+void uxx::detail::add_polygon_filled(ImDrawList& draw_list, const shape_cache::polygon& polygon, const ImVec2& center, const float radius, const ImU32 color)
+{
+    if ((color & IM_COL32_A_MASK) == 0 || polygon.corners.size() < 3) {
+        return;
+    }
+    const std::size_t count = polygon.corners.size();
+    const auto uv = ImGui::GetFontTexUvWhitePixel();
+
+    if ((draw_list.Flags & ImDrawListFlags_AntiAliasedFill) == 0) {
+        draw_list.PrimReserve(static_cast<int>((count - 2) * 3), static_cast<int>(count));
+        const std::size_t first = draw_list._VtxCurrentIdx;
+
+        for (std::size_t i = 0; i < count; ++i) {
+            write_vertex(draw_list, offset(center, polygon.corners[i], radius), uv, color);
+        }
+        for (std::size_t i = 2; i < count; ++i) {
+            *draw_list._IdxWritePtr++ = static_cast<ImDrawIdx>(first);
+            *draw_list._IdxWritePtr++ = static_cast<ImDrawIdx>(first + i - 1);
+            *draw_list._IdxWritePtr++ = static_cast<ImDrawIdx>(first + i);
+        }
+        draw_list._VtxCurrentIdx += static_cast<unsigned int>(count);
+        return;
+    }
+    // Like ImDrawList::AddConvexPolyFilled(), an inner vertex and an outer one half a pixel either side of every corner
+    const ImU32 transparent = color & ~IM_COL32_A_MASK;
+    draw_list.PrimReserve(static_cast<int>((count - 2) * 3 + count * 6), static_cast<int>(count * 2));
+    const std::size_t inner = draw_list._VtxCurrentIdx;
+    const std::size_t outer = inner + 1;
+
+    for (std::size_t i = 2; i < count; ++i) {
+        *draw_list._IdxWritePtr++ = static_cast<ImDrawIdx>(inner);
+        *draw_list._IdxWritePtr++ = static_cast<ImDrawIdx>(inner + ((i - 1) << 1));
+        *draw_list._IdxWritePtr++ = static_cast<ImDrawIdx>(inner + (i << 1));
+    }
+    for (std::size_t i1 = 0, i0 = count - 1; i1 < count; i0 = i1++) {
+        const auto p = offset(center, polygon.corners[i1], radius);
+        write_vertex(draw_list, offset(p, polygon.corner_normals[i1], -AA_SIZE * 0.5f), uv, color);
+        write_vertex(draw_list, offset(p, polygon.corner_normals[i1], AA_SIZE * 0.5f), uv, transparent);
+
+        for (const auto index : { inner + (i1 << 1), inner + (i0 << 1), outer + (i0 << 1), outer + (i0 << 1), outer + (i1 << 1), inner + (i1 << 1) }) {
+            *draw_list._IdxWritePtr++ = static_cast<ImDrawIdx>(index);
+        }
+    }
+    draw_list._VtxCurrentIdx += static_cast<unsigned int>(count * 2);
+}
+
+void uxx::detail::add_bezier_curve(ImDrawList& draw_list, shape_cache& cache, const std::array<ImVec2, 4>& points, const ImU32 color, const float thickness, std::size_t segments)
+{
+    if ((color & IM_COL32_A_MASK) == 0) {
+        return;
+    }
+    if (segments == 0) {
+        segments = shape_cache::get_bezier_segments(points[0], points[1], points[2], points[3], ImGui::GetStyle().CurveTessellationTol);
+    }
+    const auto weights = cache.get_bezier_weights(segments);
+    auto& path = draw_list._Path;
+    path.resize(static_cast<int>(weights.size() + 1));
+    path[0] = points[0];
+
+    for (std::size_t i = 0; i < weights.size(); ++i) {
+        const auto& w = weights[i];
+        path[static_cast<int>(i + 1)] = ImVec2 {
+            w[0] * points[0].x + w[1] * points[1].x + w[2] * points[2].x + w[3] * points[3].x,
+            w[0] * points[0].y + w[1] * points[1].y + w[2] * points[2].y + w[3] * points[3].y
+        };
+    }
+    add_polyline(draw_list, { path.Data, static_cast<std::size_t>(path.Size) }, color, false, thickness);
+    draw_list.PathClear();
+}
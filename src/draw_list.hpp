@@ -0,0 +1,57 @@
+#ifndef _UXX_DRAW_LIST_HPP
+#define _UXX_DRAW_LIST_HPP
+
+#include "common.hpp"
+#include "shape_cache.hpp"
+#include "uxx/uxx.hpp"
+
+#include <array>
+#include <span>
+
+namespace uxx::detail {
+
+/// Most points of a polyline tessellated at once when draw lists use 16-bit indices,
+/// so that a single primitive never needs more than 64k vertices.
+inline constexpr std::size_t MAX_POLYLINE_CHUNK_POINTS { 0xFFFF / 4 };
+
+/// Like ImDrawList::AddPolyline(), but splits polylines that don't fit 16-bit indices into chunks.
+/// With 32-bit indices (UXX_32BIT_INDICES) the polyline is always a single primitive.
+void add_polyline(ImDrawList& draw_list, std::span<const ImVec2> points, ImU32 color, bool closed, float thickness);
+/// Like add_polyline(), but leaves out the segments that lie outside the clip rectangle of the draw list.
+/// A closed polyline is drawn whole unless all of it is outside.
+/// \return The number of segments left out.
+std::size_t add_visible_polyline(ImDrawList& draw_list, std::span<const ImVec2> points, ImU32 color, bool closed, float thickness);
+
+/// \return The points as ImVec2, which has the same layout, without a copy.
+[[nodiscard]] std::span<const ImVec2> as_im_vec2(std::span<const uxx::vec2d> points) noexcept;
+
+/// Gather strided points into the path of the draw list, whose buffer keeps its capacity from one frame to the next.
+/// \return The gathered points, valid until the path is cleared with ImDrawList::PathClear().
+[[nodiscard]] std::span<const ImVec2> gather_path(ImDrawList& draw_list, const uxx::strided_points& points);
+
+/// Most vertices reserved at once by the bulk functions below when draw lists use 16-bit indices.
+inline constexpr std::size_t MAX_BULK_CHUNK_VERTICES { 0xFFFF };
+
+/// Like ImDrawList::AddLine() for every segment, with the same geometry, but with the vertices and indices
+/// of all segments reserved at once. The bulk functions leave out what lies outside the clip rectangle of the draw list.
+/// \return The number of segments left out.
+std::size_t add_lines(ImDrawList& draw_list, std::span<const uxx::segment> segments, ImU32 color, float thickness);
+/// Like ImDrawList::AddRectFilled() without rounding for every rectangle, reserved at once.
+/// \return The number of rectangles left out.
+std::size_t add_rects_filled(ImDrawList& draw_list, std::span<const uxx::rect> rects, ImU32 color);
+/// Like ImDrawList::AddTriangleFilled() for every triangle, with the same geometry, reserved at once.
+/// \return The number of triangles left out.
+std::size_t add_triangles_filled(ImDrawList& draw_list, std::span<const uxx::triangle> triangles, ImU32 color);
+
+/// Like ImDrawList::AddNgon(), the corners of the polygon scaled by radius and moved to center,
+/// with the miter normals taken from the polygon instead of computed again.
+void add_polygon(ImDrawList& draw_list, const shape_cache::polygon& polygon, const ImVec2& center, float radius, ImU32 color, float thickness);
+/// Like ImDrawList::AddNgonFilled(), see add_polygon().
+void add_polygon_filled(ImDrawList& draw_list, const shape_cache::polygon& polygon, const ImVec2& center, float radius, ImU32 color);
+/// Like ImDrawList::AddBezierCurve(), with the points of the curve weighted by cached tables.
+/// \param segments The number of segments, or 0 to choose it by the size of the curve on screen.
+void add_bezier_curve(ImDrawList& draw_list, shape_cache& cache, const std::array<ImVec2, 4>& points, ImU32 color, float thickness, std::size_t segments);
+
+}
+
+#endif
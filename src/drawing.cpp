@@ -0,0 +1,59 @@
+#include "common.hpp"
+#include "retained_geometry.hpp"
+#include "uxx/uxx.hpp"
+
+#include <limits>
+
+struct uxx::drawing::state {
+    // Tessellates the pencil commands while recording, bound to the shared data of the context when recording starts
+    ImDrawList recording { nullptr };
+    uxx::detail::retained_geometry geometry {};
+};
+
+uxx::drawing::drawing()
+    : _state(std::make_unique<state>())
+{
+}
+
+uxx::drawing::~drawing() noexcept = default;
+
+uxx::drawing::drawing(uxx::drawing&&) noexcept = default;
+
+uxx::drawing& uxx::drawing::operator=(uxx::drawing&&) noexcept = default;
+
+void uxx::drawing::clear() noexcept
+{
+    _state->geometry.clear();
+}
+
+bool uxx::drawing::is_empty() const noexcept
+{
+    return _state->geometry.is_empty();
+}
+
+uxx::pencil uxx::drawing::begin_recording()
+{
+    auto& list = _state->recording;
+    list._Data = ImGui::GetDrawListSharedData();
+    list._ResetForNewFrame();
+    list.PushTextureID(ImGui::GetIO().Fonts->TexID);
+    // Nothing is culled while recording, the drawing may be drawn anywhere later on
+    constexpr auto limit = std::numeric_limits<float>::max();
+    list.PushClipRect(ImVec2 { -limit, -limit }, ImVec2 { limit, limit });
+
+    // The list has the flags of the frame, so shapes of more than 64k vertices are split at vertex offsets, which
+    // replay() keeps apart
+    return uxx::pencil { std::any { &list } };
+}
+
+void uxx::drawing::end_recording()
+{
+    _state->geometry.assign(_state->recording);
+    // The recording is done with until the content changes
+    _state->recording._ClearFreeMemory();
+}
+
+std::size_t uxx::drawing::replay(const std::any& draw_list, const uxx::vec2d& translation, const float scale) const
+{
+    return _state->geometry.append_to(*std::any_cast<ImDrawList*>(draw_list), { translation.x, translation.y }, scale);
+}
@@ -0,0 +1,345 @@
+#include "common.hpp"
+#include "font_atlas.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+// Bump when the layout of the cache file changes
+constexpr std::uint32_t CACHE_VERSION { 1 };
+constexpr std::array<char, 8> CACHE_MAGIC { 'U', 'X', 'X', 'F', 'O', 'N', 'T', 'S' };
+constexpr int MAX_TEXTURE_SIZE { 16384 };
+constexpr std::uint32_t MAX_GLYPHS { 0xFFFF };
+
+class fnv1a {
+public:
+    void add(const void* data, const std::size_t size) noexcept
+    {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+
+        for (std::size_t i = 0; i < size; ++i) {
+            _hash = (_hash ^ bytes[i]) * 0x100000001b3ULL;
+        }
+    }
+
+    template <typename T>
+    void add(const T& value) noexcept requires std::is_trivially_copyable_v<T>
+    {
+        add(&value, sizeof(T));
+    }
+
+    [[nodiscard]] std::uint64_t get() const noexcept
+    {
+        return _hash;
+    }
+
+private:
+    std::uint64_t _hash { 0xcbf29ce484222325ULL };
+};
+
+template <typename T>
+void write_values(std::ostream& out, const T* values, const std::size_t count) requires std::is_trivially_copyable_v<T>
+{
+    out.write(reinterpret_cast<const char*>(values), static_cast<std::streamsize>(sizeof(T) * count));
+}
+
+template <typename T>
+void write_value(std::ostream& out, const T& value) requires std::is_trivially_copyable_v<T>
+{
+    write_values(out, &value, 1);
+}
+
+template <typename T>
+bool read_values(std::istream& in, T* values, const std::size_t count) requires std::is_trivially_copyable_v<T>
+{
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(values), static_cast<std::streamsize>(sizeof(T) * count)));
+}
+
+template <typename T>
+bool read_value(std::istream& in, T& value) requires std::is_trivially_copyable_v<T>
+{
+    return read_values(in, &value, 1);
+}
+
+struct cached_rect {
+    unsigned short width;
+    unsigned short height;
+    unsigned short x;
+    unsigned short y;
+    unsigned int glyph_id;
+    float glyph_advance_x;
+    ImVec2 glyph_offset;
+};
+
+struct cached_font {
+    float ascent;
+    float descent;
+    ImWchar ellipsis_char;
+    int metrics_total_surface;
+    std::vector<ImFontGlyph> glyphs;
+};
+
+struct cached_atlas {
+    int tex_width;
+    int tex_height;
+    ImVec2 tex_uv_scale;
+    ImVec2 tex_uv_white_pixel;
+    std::array<ImVec4, IM_DRAWLIST_TEX_LINES_WIDTH_MAX + 1> tex_uv_lines;
+    int pack_id_mouse_cursors;
+    int pack_id_lines;
+    std::vector<cached_rect> rects;
+    std::vector<cached_font> fonts;
+    std::vector<unsigned char> pixels;
+};
+
+// Only plain atlases can be restored: one output font per input font and no glyphs from custom rectangles
+bool is_cacheable(const ImFontAtlas& atlas) noexcept
+{
+    const auto has_custom_glyphs = std::any_of(atlas.CustomRects.begin(), atlas.CustomRects.end(), [](const ImFontAtlasCustomRect& r) { return nullptr != r.Font; });
+    return atlas.Fonts.Size == atlas.ConfigData.Size && !has_custom_glyphs;
+}
+
+void save_font_atlas(const ImFontAtlas& atlas, const std::uint64_t key, std::ostream& out)
+{
+    write_values(out, CACHE_MAGIC.data(), CACHE_MAGIC.size());
+    write_value(out, key);
+    write_value(out, atlas.TexWidth);
+    write_value(out, atlas.TexHeight);
+    write_value(out, atlas.TexUvScale);
+    write_value(out, atlas.TexUvWhitePixel);
+    write_values(out, atlas.TexUvLines, IM_DRAWLIST_TEX_LINES_WIDTH_MAX + 1);
+    write_value(out, atlas.PackIdMouseCursors);
+    write_value(out, atlas.PackIdLines);
+
+    write_value(out, static_cast<std::uint32_t>(atlas.CustomRects.Size));
+    for (const auto& r : atlas.CustomRects) {
+        write_value(out, cached_rect { r.Width, r.Height, r.X, r.Y, r.GlyphID, r.GlyphAdvanceX, r.GlyphOffset });
+    }
+
+    write_value(out, static_cast<std::uint32_t>(atlas.Fonts.Size));
+    for (const auto* font : atlas.Fonts) {
+        write_value(out, font->Ascent);
+        write_value(out, font->Descent);
+        write_value(out, font->EllipsisChar);
+        write_value(out, font->MetricsTotalSurface);
+        write_value(out, static_cast<std::uint32_t>(font->Glyphs.Size));
+        write_values(out, font->Glyphs.Data, static_cast<std::size_t>(font->Glyphs.Size));
+    }
+    write_values(out, atlas.TexPixelsAlpha8, static_cast<std::size_t>(atlas.TexWidth) * static_cast<std::size_t>(atlas.TexHeight));
+}
+
+// Reads the whole file before touching the atlas, a damaged cache leaves it as it was
+bool read_font_atlas(std::istream& in, const std::uint64_t key, const int font_count, cached_atlas& cache)
+{
+    std::array<char, 8> magic {};
+    std::uint64_t cached_key {};
+    std::uint32_t count {};
+
+    if (!read_values(in, magic.data(), magic.size()) || magic != CACHE_MAGIC || !read_value(in, cached_key) || cached_key != key) {
+        return false;
+    }
+    if (!read_value(in, cache.tex_width) || !read_value(in, cache.tex_height) || cache.tex_width <= 0 || cache.tex_height <= 0
+        || cache.tex_width > MAX_TEXTURE_SIZE || cache.tex_height > MAX_TEXTURE_SIZE) {
+        return false;
+    }
+    if (!read_value(in, cache.tex_uv_scale) || !read_value(in, cache.tex_uv_white_pixel) || !read_values(in, cache.tex_uv_lines.data(), cache.tex_uv_lines.size())
+        || !read_value(in, cache.pack_id_mouse_cursors) || !read_value(in, cache.pack_id_lines)) {
+        return false;
+    }
+
+    if (!read_value(in, count) || count > MAX_GLYPHS) {
+        return false;
+    }
+    cache.rects.resize(count);
+    if (!read_values(in, cache.rects.data(), cache.rects.size())) {
+        return false;
+    }
+
+    if (!read_value(in, count) || count != static_cast<std::uint32_t>(font_count)) {
+        return false;
+    }
+    cache.fonts.resize(count);
+    for (auto& font : cache.fonts) {
+        if (!read_value(in, font.ascent) || !read_value(in, font.descent) || !read_value(in, font.ellipsis_char) || !read_value(in, font.metrics_total_surface)
+            || !read_value(in, count) || count > MAX_GLYPHS) {
+            return false;
+        }
+        font.glyphs.resize(count);
+        if (!read_values(in, font.glyphs.data(), font.glyphs.size())) {
+            return false;
+        }
+    }
+    cache.pixels.resize(static_cast<std::size_t>(cache.tex_width) * static_cast<std::size_t>(cache.tex_height));
+    return read_values(in, cache.pixels.data(), cache.pixels.size());
+}
+
+// Leaves the atlas as if Build() had produced the cached output
+void restore_font_atlas(ImFontAtlas& atlas, const cached_atlas& cache)
+{
+    atlas.ClearTexData();
+    atlas.TexPixelsAlpha8 = static_cast<unsigned char*>(IM_ALLOC(cache.pixels.size()));
+    std::memcpy(atlas.TexPixelsAlpha8, cache.pixels.data(), cache.pixels.size());
+    atlas.TexWidth = cache.tex_width;
+    atlas.TexHeight = cache.tex_height;
+    atlas.TexUvScale = cache.tex_uv_scale;
+    atlas.TexUvWhitePixel = cache.tex_uv_white_pixel;
+    std::copy(cache.tex_uv_lines.begin(), cache.tex_uv_lines.end(), atlas.TexUvLines);
+    atlas.PackIdMouseCursors = cache.pack_id_mouse_cursors;
+    atlas.PackIdLines = cache.pack_id_lines;
+
+    atlas.CustomRects.resize(static_cast<int>(cache.rects.size()));
+    for (std::size_t i = 0; i < cache.rects.size(); ++i) {
+        const auto& cached = cache.rects[i];
+        auto& r = atlas.CustomRects[static_cast<int>(i)];
+        r = ImFontAtlasCustomRect {};
+        r.Width = cached.width;
+        r.Height = cached.height;
+        r.X = cached.x;
+        r.Y = cached.y;
+        r.GlyphID = cached.glyph_id;
+        r.GlyphAdvanceX = cached.glyph_advance_x;
+        r.GlyphOffset = cached.glyph_offset;
+    }
+
+    for (int i = 0; i < atlas.Fonts.Size; ++i) {
+        const auto& cached = cache.fonts[static_cast<std::size_t>(i)];
+        auto* font = atlas.Fonts[i];
+        font->ClearOutputData();
+        font->FontSize = atlas.ConfigData[i].SizePixels;
+        font->ConfigData = &atlas.ConfigData[i];
+        font->ConfigDataCount = 1;
+        font->ContainerAtlas = &atlas;
+        font->Ascent = cached.ascent;
+        font->Descent = cached.descent;
+        font->EllipsisChar = cached.ellipsis_char;
+        font->MetricsTotalSurface = cached.metrics_total_surface;
+        font->Glyphs.resize(static_cast<int>(cached.glyphs.size()));
+        std::copy(cached.glyphs.begin(), cached.glyphs.end(), font->Glyphs.begin());
+        font->BuildLookupTable();
+    }
+}
+
+std::filesystem::path get_cache_file(const std::filesystem::path& cache_directory, const std::uint64_t key)
+{
+    std::array<char, 48> name {};
+    std::snprintf(name.data(), name.size(), "font-atlas-%016llx.bin", static_cast<unsigned long long>(key));
+    return cache_directory / name.data();
+}
+
+// Writes to a temporary file first, so that concurrent starts never see a partial cache file
+void save_to_cache(const ImFontAtlas& atlas, const std::uint64_t key, const std::filesystem::path& file)
+{
+    std::error_code error {};
+    std::filesystem::create_directories(file.parent_path(), error);
+
+    if (error) {
+        return;
+    }
+    auto temporary = file;
+    temporary += ".tmp";
+    {
+        std::ofstream out { temporary, std::ios::binary | std::ios::trunc };
+        save_font_atlas(atlas, key, out);
+
+        if (!out.flush()) {
+            out.close();
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+    }
+    std::filesystem::rename(temporary, file, error);
+
+    if (error) {
+        std::filesystem::remove(temporary, error);
+    }
+}
+
+}
+
+ImFont* uxx::detail::add_embedded_font(ImFontAtlas& atlas, const embedded_font& font, const float size_pixels)
+{
+    ImFontConfig config {};
+    // The font data lives in the binary, the atlas must never free it
+    config.FontDataOwnedByAtlas = false;
+    std::snprintf(config.Name, sizeof(config.Name), "%.*s, %.0fpx", static_cast<int>(font.name.size()), font.name.data(), static_cast<double>(size_pixels));
+    return atlas.AddFontFromMemoryTTF(const_cast<unsigned char*>(font.data.data()), static_cast<int>(font.data.size()), size_pixels, &config);
+}
+
+std::uint64_t uxx::detail::get_font_atlas_key(ImFontAtlas& atlas)
+{
+    fnv1a hash {};
+    hash.add(CACHE_VERSION);
+    hash.add(IMGUI_VERSION_NUM);
+    hash.add(sizeof(ImWchar));
+    hash.add(atlas.Flags);
+    hash.add(atlas.TexDesiredWidth);
+    hash.add(atlas.TexGlyphPadding);
+
+    for (const auto& config : atlas.ConfigData) {
+        hash.add(config.FontData, static_cast<std::size_t>(config.FontDataSize));
+        hash.add(config.FontNo);
+        hash.add(config.SizePixels);
+        hash.add(config.OversampleH);
+        hash.add(config.OversampleV);
+        hash.add(config.PixelSnapH);
+        hash.add(config.GlyphExtraSpacing);
+        hash.add(config.GlyphOffset);
+        hash.add(config.GlyphMinAdvanceX);
+        hash.add(config.GlyphMaxAdvanceX);
+        hash.add(config.MergeMode);
+        hash.add(config.RasterizerFlags);
+        hash.add(config.RasterizerMultiply);
+        hash.add(config.EllipsisChar);
+
+        for (const auto* range = nullptr != config.GlyphRanges ? config.GlyphRanges : atlas.GetGlyphRangesDefault(); *range != 0; ++range) {
+            hash.add(*range);
+        }
+    }
+    return hash.get();
+}
+
+bool uxx::detail::build_font_atlas(ImFontAtlas& atlas, const std::filesystem::path& cache_directory)
+{
+    if (cache_directory.empty() || !is_cacheable(atlas)) {
+        atlas.Build();
+        return false;
+    }
+    const auto key = get_font_atlas_key(atlas);
+    const auto file = get_cache_file(cache_directory, key);
+
+    if (std::ifstream in { file, std::ios::binary }; in) {
+        cached_atlas cache {};
+
+        if (read_font_atlas(in, key, atlas.Fonts.Size, cache)) {
+            restore_font_atlas(atlas, cache);
+            return true;
+        }
+    }
+    if (atlas.Build() && is_cacheable(atlas)) {
+        save_to_cache(atlas, key, file);
+    }
+    return false;
+}
+
+std::filesystem::path uxx::detail::get_default_cache_directory()
+{
+#if !defined(_WIN32)
+    if (const char* xdg_cache = std::getenv("XDG_CACHE_HOME"); nullptr != xdg_cache && *xdg_cache != '\0') {
+        return std::filesystem::path { xdg_cache } / "uxx";
+    }
+    if (const char* home = std::getenv("HOME"); nullptr != home && *home != '\0') {
+        return std::filesystem::path { home } / ".cache" / "uxx";
+    }
+#endif
+    std::error_code error {};
+    auto temporary = std::filesystem::temp_directory_path(error);
+    return error ? std::filesystem::path {} : temporary / "uxx";
+}
@@ -0,0 +1,38 @@
+#ifndef _UXX_FONT_ATLAS_HPP
+#define _UXX_FONT_ATLAS_HPP
+
+#include "common.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+
+namespace uxx::detail {
+
+/// A font file compiled into the library.
+struct embedded_font {
+    std::string_view name;
+    std::span<const unsigned char> data;
+};
+
+/// \return The fonts of the fonts/ directory, embedded at build time by cmake/EmbedFonts.cmake.
+[[nodiscard]] std::span<const embedded_font> get_embedded_fonts() noexcept;
+
+/// Add an embedded font to the atlas without copying its data.
+ImFont* add_embedded_font(ImFontAtlas& atlas, const embedded_font& font, float size_pixels);
+
+/// \return Identifies the baked output of the atlas: font data, sizes, glyph ranges and build settings.
+[[nodiscard]] std::uint64_t get_font_atlas_key(ImFontAtlas& atlas);
+
+/// Build the atlas, or restore a previous build of the same fonts from the cache directory.
+/// The cache is best effort, an empty directory disables it.
+/// \return True if the atlas was restored from the cache.
+bool build_font_atlas(ImFontAtlas& atlas, const std::filesystem::path& cache_directory);
+
+/// \return Per-user cache directory of the platform, empty if there is none.
+[[nodiscard]] std::filesystem::path get_default_cache_directory();
+
+}
+
+#endif
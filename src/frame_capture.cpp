@@ -0,0 +1,367 @@
+#include "common.hpp"
+#include "frame_capture.hpp"
+
+#include <SFML/OpenGL.hpp>
+
+#include <array>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#define UXX_GL_API __stdcall
+#else
+#define UXX_GL_API
+#endif
+
+namespace {
+
+// Pixel buffer objects (OpenGL 2.1) and ARB_sync (OpenGL 3.2) are loaded at runtime like in the OpenGL 3 renderer
+namespace gl {
+using sizeiptr = std::ptrdiff_t;
+
+constexpr GLenum PIXEL_PACK_BUFFER { 0x88EB };
+constexpr GLenum STREAM_READ { 0x88E1 };
+constexpr GLenum READ_ONLY { 0x88B8 };
+constexpr GLenum SYNC_GPU_COMMANDS_COMPLETE { 0x9117 };
+constexpr GLenum ALREADY_SIGNALED { 0x911A };
+constexpr GLenum CONDITION_SATISFIED { 0x911C };
+
+struct sync_object;
+using sync = sync_object*;
+
+struct functions {
+    void(UXX_GL_API* GenBuffers)(GLsizei, GLuint*);
+    void(UXX_GL_API* DeleteBuffers)(GLsizei, const GLuint*);
+    void(UXX_GL_API* BindBuffer)(GLenum, GLuint);
+    void(UXX_GL_API* BufferData)(GLenum, sizeiptr, const void*, GLenum);
+    void*(UXX_GL_API* MapBuffer)(GLenum, GLenum);
+    GLboolean(UXX_GL_API* UnmapBuffer)(GLenum);
+};
+
+struct sync_functions {
+    sync(UXX_GL_API* FenceSync)(GLenum, GLbitfield);
+    GLenum(UXX_GL_API* ClientWaitSync)(sync, GLbitfield, std::uint64_t);
+    void(UXX_GL_API* DeleteSync)(sync);
+};
+
+template <typename T>
+bool try_load(T& function, const char* name) noexcept
+{
+    function = reinterpret_cast<T>(sf::Context::getFunction(name));
+    return nullptr != function;
+}
+
+template <typename T>
+void load(T& function, const char* name)
+{
+    if (!try_load(function, name)) {
+        throw std::runtime_error(std::string("Frame capture is not supported, missing ") + name);
+    }
+}
+
+[[nodiscard]] functions load_functions()
+{
+    functions f {};
+    load(f.GenBuffers, "glGenBuffers");
+    load(f.DeleteBuffers, "glDeleteBuffers");
+    load(f.BindBuffer, "glBindBuffer");
+    load(f.BufferData, "glBufferData");
+    load(f.MapBuffer, "glMapBuffer");
+    load(f.UnmapBuffer, "glUnmapBuffer");
+    return f;
+}
+
+[[nodiscard]] std::optional<sync_functions> load_sync_functions() noexcept
+{
+    if (!sf::Context::isExtensionAvailable("GL_ARB_sync")) {
+        return {};
+    }
+    sync_functions f {};
+
+    if (try_load(f.FenceSync, "glFenceSync") && try_load(f.ClientWaitSync, "glClientWaitSync") && try_load(f.DeleteSync, "glDeleteSync")) {
+        return f;
+    }
+    return {};
+}
+}
+
+}
+
+struct uxx::detail::frame_capture::pixel_buffers {
+    // A frame read into a pixel buffer that hasn't been copied out yet
+    struct in_flight {
+        std::size_t buffer;
+        unsigned int width;
+        unsigned int height;
+        // Signaled when the GPU is done writing the pixels, nullptr without ARB_sync
+        gl::sync fence;
+        // Skipped frames that followed it and repeat it
+        std::size_t repeats;
+    };
+
+    gl::functions f { gl::load_functions() };
+    std::optional<gl::sync_functions> sync { gl::load_sync_functions() };
+    std::array<GLuint, PIXEL_BUFFERS> names {};
+    std::array<std::size_t, PIXEL_BUFFERS> sizes {};
+    std::deque<in_flight> frames {};
+    std::size_t next { 0 };
+
+    pixel_buffers()
+    {
+        f.GenBuffers(static_cast<GLsizei>(names.size()), names.data());
+    }
+
+    // Forget the frames in flight
+    void discard() noexcept
+    {
+        for (auto& frame : frames) {
+            if (nullptr != frame.fence) {
+                sync->DeleteSync(frame.fence);
+            }
+        }
+        frames.clear();
+    }
+
+    // Delete the buffers, with the context they were created in active
+    void release() noexcept
+    {
+        discard();
+        f.DeleteBuffers(static_cast<GLsizei>(names.size()), names.data());
+    }
+
+    [[nodiscard]] bool is_full() const noexcept
+    {
+        return frames.size() == PIXEL_BUFFERS;
+    }
+
+    // Without fences a frame is copied out when its buffer is needed again, by then the GPU is done with it
+    [[nodiscard]] bool is_ready(const in_flight& frame) const noexcept
+    {
+        if (nullptr == frame.fence) {
+            return is_full();
+        }
+        const auto status = sync->ClientWaitSync(frame.fence, 0, 0);
+        return status == gl::ALREADY_SIGNALED || status == gl::CONDITION_SATISFIED;
+    }
+
+    // Start reading the framebuffer into the next buffer, glReadPixels returns without waiting for the GPU
+    void read(const unsigned int width, const unsigned int height)
+    {
+        const std::size_t size = std::size_t { width } * height * 4;
+        f.BindBuffer(gl::PIXEL_PACK_BUFFER, names[next]);
+
+        if (sizes[next] < size) {
+            f.BufferData(gl::PIXEL_PACK_BUFFER, static_cast<gl::sizeiptr>(size), nullptr, gl::STREAM_READ);
+            sizes[next] = size;
+        }
+        glReadPixels(0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        const auto fence = sync ? sync->FenceSync(gl::SYNC_GPU_COMMANDS_COMPLETE, 0) : nullptr;
+        // SFML reads textures back into client memory, which an unbound pack buffer would break
+        f.BindBuffer(gl::PIXEL_PACK_BUFFER, 0);
+        frames.push_back({ next, width, height, fence, 0 });
+        next = (next + 1) % PIXEL_BUFFERS;
+    }
+
+    // Copy the oldest frame out of its buffer, waiting for the GPU if it isn't done yet
+    // \return False if the buffer couldn't be mapped.
+    bool copy_out(std::vector<std::uint8_t>& pixels, in_flight& frame)
+    {
+        frame = frames.front();
+        frames.pop_front();
+        f.BindBuffer(gl::PIXEL_PACK_BUFFER, names[frame.buffer]);
+        const auto* mapped = static_cast<const std::uint8_t*>(f.MapBuffer(gl::PIXEL_PACK_BUFFER, gl::READ_ONLY));
+
+        if (nullptr != mapped) {
+            pixels.assign(mapped, mapped + std::size_t { frame.width } * frame.height * 4);
+            f.UnmapBuffer(gl::PIXEL_PACK_BUFFER);
+        }
+        f.BindBuffer(gl::PIXEL_PACK_BUFFER, 0);
+
+        if (nullptr != frame.fence) {
+            sync->DeleteSync(frame.fence);
+        }
+        return nullptr != mapped;
+    }
+};
+
+uxx::detail::frame_capture::frame_capture() noexcept = default;
+
+// The pixel buffers belong to a context that may be gone, close() releases them
+uxx::detail::frame_capture::~frame_capture() noexcept = default;
+
+void uxx::detail::frame_capture::start(const std::filesystem::path& path, const uxx::app::capture_format format, const unsigned int frame_rate)
+{
+    auto encoder = std::make_unique<capture_encoder>(path, format, frame_rate);
+    std::scoped_lock lock { _mutex };
+    _request = std::move(encoder);
+    _capturing = true;
+}
+
+void uxx::detail::frame_capture::stop() noexcept
+{
+    std::scoped_lock lock { _mutex };
+    _request = std::unique_ptr<capture_encoder> {};
+    _capturing = false;
+}
+
+void uxx::detail::frame_capture::repeat() noexcept
+{
+    if (_capturing) {
+        ++_repeats;
+    }
+}
+
+bool uxx::detail::frame_capture::is_capturing() const noexcept
+{
+    return _capturing;
+}
+
+void uxx::detail::frame_capture::read(sf::RenderTarget& target)
+{
+    update();
+
+    if (nullptr == _encoder) {
+        return;
+    }
+    if (!target.setActive(true)) {
+        throw std::runtime_error("Unable to activate the render target");
+    }
+    if (nullptr == _buffers) {
+        _buffers = std::make_unique<pixel_buffers>();
+    }
+    // Frames the GPU is done with are copied out oldest first, the rest stays in flight
+    while (!_buffers->frames.empty() && _buffers->is_ready(_buffers->frames.front())) {
+        copy_out(*_encoder);
+    }
+    if (_buffers->is_full()) {
+        ++_dropped;
+        return;
+    }
+    const auto size = target.getSize();
+    _buffers->read(size.x, size.y);
+}
+
+void uxx::detail::frame_capture::add(const std::span<const std::uint8_t> pixels, const unsigned int width, const unsigned int height)
+{
+    update();
+
+    if (nullptr == _encoder) {
+        return;
+    }
+    auto buffer = _encoder->take_buffer();
+    buffer.assign(pixels.begin(), pixels.end());
+    _encoder->submit(std::move(buffer), width, height, false);
+}
+
+void uxx::detail::frame_capture::close()
+{
+    pass_repeats();
+    {
+        // A capture started during the last frame is kept for the next run
+        std::scoped_lock lock { _mutex };
+        _capturing = _request.has_value() && nullptr != *_request;
+    }
+
+    try {
+        finish_encoder();
+    } catch (...) {
+        release_buffers();
+        throw;
+    }
+    release_buffers();
+}
+
+std::size_t uxx::detail::frame_capture::get_dropped_count() const noexcept
+{
+    return _dropped;
+}
+
+void uxx::detail::frame_capture::update()
+{
+    std::optional<std::unique_ptr<capture_encoder>> request {};
+    {
+        std::scoped_lock lock { _mutex };
+        request.swap(_request);
+    }
+    // Frames skipped before the switch belong to the previous capture
+    pass_repeats();
+
+    if (request) {
+        finish_encoder();
+        _encoder = std::move(*request);
+    }
+}
+
+void uxx::detail::frame_capture::pass_repeats()
+{
+    const auto repeats = _repeats.exchange(0);
+
+    if (nullptr == _encoder || repeats == 0) {
+        return;
+    }
+    if (nullptr != _buffers && !_buffers->frames.empty()) {
+        // The skipped frames come after the frames still in flight
+        _buffers->frames.back().repeats += repeats;
+        return;
+    }
+    for (std::size_t i = 0; i < repeats; ++i) {
+        _encoder->repeat();
+    }
+}
+
+void uxx::detail::frame_capture::copy_out(capture_encoder& encoder)
+{
+    pixel_buffers::in_flight frame {};
+    auto pixels = encoder.take_buffer();
+
+    if (_buffers->copy_out(pixels, frame)) {
+        encoder.submit(std::move(pixels), frame.width, frame.height, true);
+    } else {
+        ++_dropped;
+    }
+    for (std::size_t i = 0; i < frame.repeats; ++i) {
+        encoder.repeat();
+    }
+}
+
+void uxx::detail::frame_capture::finish_encoder()
+{
+    if (nullptr == _encoder) {
+        return;
+    }
+    const auto encoder = std::move(_encoder);
+    std::exception_ptr error {};
+
+    try {
+        // The context may be about to go away or the next capture reuses the buffers, wait for the GPU
+        while (nullptr != _buffers && !_buffers->frames.empty()) {
+            copy_out(*encoder);
+        }
+        encoder->finish();
+    } catch (...) {
+        error = std::current_exception();
+
+        if (nullptr != _buffers) {
+            _buffers->discard();
+        }
+    }
+    _dropped += encoder->get_dropped_count();
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void uxx::detail::frame_capture::release_buffers() noexcept
+{
+    if (nullptr != _buffers) {
+        _buffers->release();
+        _buffers.reset();
+    }
+}
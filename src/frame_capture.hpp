@@ -0,0 +1,82 @@
+#ifndef _UXX_FRAME_CAPTURE_HPP
+#define _UXX_FRAME_CAPTURE_HPP
+
+#include "common.hpp"
+#include "capture_encoder.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+
+namespace uxx::detail {
+
+/// Records the frames of a window or offscreen target, see uxx::app::start_capture().
+/// Frames are read back through a ring of pixel buffer objects. glReadPixels into a pixel buffer returns right away,
+/// and the pixels are copied out a few frames later when the GPU is done with them, so the main loop never waits.
+///
+/// start(), stop() and repeat() may be called from any thread. Everything else runs on the thread that renders,
+/// with the OpenGL context of the target active. Call close() before that context goes away.
+class frame_capture {
+public:
+    /// Frames read back but not yet copied out of their pixel buffer.
+    static constexpr std::size_t PIXEL_BUFFERS { 3 };
+
+    frame_capture() noexcept;
+    ~frame_capture() noexcept;
+
+    frame_capture(const frame_capture&) = delete;
+    frame_capture(frame_capture&&) = delete;
+    frame_capture& operator=(const frame_capture&) = delete;
+    frame_capture& operator=(frame_capture&&) = delete;
+
+    /// Start a new capture with the next frame, finishing the current one.
+    /// \throw std::runtime_error If the file or directory can't be created.
+    void start(const std::filesystem::path& path, uxx::app::capture_format format, unsigned int frame_rate);
+    /// Finish the current capture with the next frame.
+    void stop() noexcept;
+    /// Count a frame that was skipped because nothing changed, the capture repeats the previous frame for it.
+    void repeat() noexcept;
+    /// \return True between start() and stop(), whether or not the next frame has started the capture yet.
+    [[nodiscard]] bool is_capturing() const noexcept;
+
+    /// Read back the frame just drawn into the target, before it is displayed.
+    void read(sf::RenderTarget& target);
+    /// Capture a frame that is already in memory.
+    /// \param pixels RGBA pixels, row by row from the top.
+    void add(std::span<const std::uint8_t> pixels, unsigned int width, unsigned int height);
+    /// Copy out the frames still in flight, finish the capture and release the pixel buffers.
+    /// Rethrows the exception that encoding a frame threw.
+    void close();
+
+    /// \return Frames dropped by every capture so far, counted when a capture finishes.
+    [[nodiscard]] std::size_t get_dropped_count() const noexcept;
+
+private:
+    struct pixel_buffers;
+
+    std::mutex _mutex {};
+    // The encoder of the next capture, or nullptr to stop capturing, applied with the next frame
+    std::optional<std::unique_ptr<capture_encoder>> _request {};
+    std::atomic<bool> _capturing { false };
+    std::atomic<std::size_t> _repeats { 0 };
+    std::atomic<std::size_t> _dropped { 0 };
+    std::unique_ptr<capture_encoder> _encoder {};
+    std::unique_ptr<pixel_buffers> _buffers {};
+
+    // Switch to the requested encoder
+    void update();
+    // Hand the frames skipped since the previous frame to the encoder
+    void pass_repeats();
+    // Copy the oldest frame in flight out of its pixel buffer and queue it for encoding
+    void copy_out(capture_encoder& encoder);
+    // Finish the current encoder, keeping the count of frames it dropped
+    void finish_encoder();
+    void release_buffers() noexcept;
+};
+
+}
+
+#endif
@@ -0,0 +1,128 @@
+#include "common.hpp"
+#include "frame_policy.hpp"
+
+#include <thread>
+
+namespace {
+
+// Sleep while far from the deadline and spin for the last stretch, since sleeping alone overshoots by up to a
+// scheduler quantum.
+void wait_until(const uxx::detail::frame_pacer::clock::time_point deadline, const std::chrono::microseconds spin_threshold)
+{
+    using namespace std::chrono;
+
+    for (auto remaining = deadline - steady_clock::now(); remaining > nanoseconds::zero(); remaining = deadline - steady_clock::now()) {
+        if (remaining > spin_threshold) {
+            const auto sleep_time = duration_cast<microseconds>(remaining - spin_threshold);
+            sf::sleep(sf::microseconds(static_cast<sf::Int64>(sleep_time.count())));
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+}
+
+uxx::app::frame_policy::frame_policy(const mode m, const unsigned int rate) noexcept
+    : _mode(m)
+    , _rate(rate)
+    , _spin_threshold(DEFAULT_SPIN_THRESHOLD)
+{
+}
+
+uxx::app::frame_policy uxx::app::frame_policy::vsync(const unsigned int refresh_rate) noexcept
+{
+    return frame_policy { mode::vsync, refresh_rate };
+}
+
+uxx::app::frame_policy uxx::app::frame_policy::fixed_rate(const unsigned int frames_per_second) noexcept
+{
+    if (frames_per_second == 0) {
+        return uncapped();
+    }
+    return frame_policy { mode::fixed_rate, frames_per_second };
+}
+
+uxx::app::frame_policy uxx::app::frame_policy::uncapped() noexcept
+{
+    return frame_policy { mode::uncapped, 0 };
+}
+
+uxx::app::frame_policy uxx::app::frame_policy::set_spin_threshold(const std::chrono::microseconds threshold) noexcept
+{
+    _spin_threshold = threshold;
+    return *this;
+}
+
+uxx::app::frame_policy::mode uxx::app::frame_policy::get_mode() const noexcept
+{
+    return _mode;
+}
+
+std::chrono::nanoseconds uxx::app::frame_policy::get_frame_budget() const noexcept
+{
+    if (_rate == 0) {
+        return std::chrono::nanoseconds::zero();
+    }
+    return std::chrono::nanoseconds { std::chrono::seconds { 1 } } / _rate;
+}
+
+std::chrono::microseconds uxx::app::frame_policy::get_spin_threshold() const noexcept
+{
+    return _spin_threshold;
+}
+
+uxx::detail::frame_pacer::frame_pacer(const uxx::app::frame_policy& policy) noexcept
+    : _policy(policy)
+    , _frame_start(clock::now())
+{
+}
+
+void uxx::detail::frame_pacer::reset() noexcept
+{
+    _frame_start = clock::now();
+}
+
+uxx::app::frame_report uxx::detail::frame_pacer::end_frame(const bool skipped)
+{
+    using mode = uxx::app::frame_policy::mode;
+
+    const auto budget = _policy.get_frame_budget();
+    const auto previous_start = _frame_start;
+    auto now = clock::now();
+    std::chrono::nanoseconds deadline_miss { 0 };
+
+    switch (_policy.get_mode()) {
+    case mode::fixed_rate: {
+        const auto deadline = previous_start + budget;
+
+        if (now > deadline) {
+            deadline_miss = now - deadline;
+            _frame_start = now;
+        } else {
+            wait_until(deadline, _policy.get_spin_threshold());
+            // Continue from the deadline rather than the wake-up time so the schedule doesn't drift
+            _frame_start = deadline;
+        }
+        break;
+    }
+    case mode::vsync:
+        if (skipped) {
+            // Nothing waited for the vertical blank, take the time a presented frame would have taken
+            wait_until(previous_start + budget, _policy.get_spin_threshold());
+            now = clock::now();
+        }
+        // display() already blocked until the vertical blank. Only count a miss when a whole refresh was skipped,
+        // as the measured interval always jitters around the budget.
+        if (budget > std::chrono::nanoseconds::zero() && (now - previous_start) > budget + budget / 2) {
+            deadline_miss = (now - previous_start) - budget;
+        }
+        _frame_start = now;
+        break;
+    case mode::uncapped:
+    default:
+        _frame_start = now;
+        break;
+    }
+    return uxx::app::frame_report { _frame_index++, _frame_start - previous_start, deadline_miss, {}, skipped };
+}
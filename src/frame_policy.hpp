@@ -0,0 +1,29 @@
+#ifndef _UXX_FRAME_POLICY_HPP
+#define _UXX_FRAME_POLICY_HPP
+
+#include "uxx/uxx.hpp"
+
+namespace uxx::detail {
+
+/// Paces the main loop according to a uxx::app::frame_policy.
+class frame_pacer {
+public:
+    using clock = std::chrono::steady_clock;
+
+    explicit frame_pacer(const uxx::app::frame_policy& policy) noexcept;
+
+    /// Start a new schedule, e.g. after the main loop has been idle.
+    void reset() noexcept;
+    /// Finish the current frame: wait for its deadline and report how well it was met.
+    /// \param skipped True if the frame wasn't presented, so that no vertical blank has paced it.
+    [[nodiscard]] uxx::app::frame_report end_frame(bool skipped = false);
+
+private:
+    uxx::app::frame_policy _policy;
+    clock::time_point _frame_start;
+    std::uint64_t _frame_index { 0 };
+};
+
+}
+
+#endif
@@ -0,0 +1,84 @@
+#include "uxx/uxx.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+template <typename Projection>
+[[nodiscard]] uxx::app::frame_stats::summary summarize(const uxx::app::frame_stats& stats, Projection project)
+{
+    const auto count = stats.get_sample_count();
+
+    if (count == 0) {
+        return {};
+    }
+    std::vector<std::chrono::nanoseconds> durations;
+    durations.reserve(count);
+    std::chrono::nanoseconds sum { 0 };
+
+    for (std::size_t age = 0; age < count; ++age) {
+        durations.push_back(project(stats.get_sample(age)));
+        sum += durations.back();
+    }
+    std::sort(durations.begin(), durations.end());
+
+    // Nearest-rank percentile
+    const auto percentile = [&durations](const double p) {
+        const auto rank = static_cast<std::size_t>(std::ceil(p * static_cast<double>(durations.size())));
+        return durations[std::clamp<std::size_t>(rank, 1, durations.size()) - 1];
+    };
+    return uxx::app::frame_stats::summary {
+        durations.front(),
+        sum / static_cast<std::chrono::nanoseconds::rep>(count),
+        percentile(0.95),
+        percentile(0.99)
+    };
+}
+
+}
+
+void uxx::app::frame_stats::add(const frame_sample& sample) noexcept
+{
+    _samples[_next] = sample;
+    _next = (_next + 1) % CAPACITY;
+    _count = std::min(_count + 1, CAPACITY);
+}
+
+void uxx::app::frame_stats::clear() noexcept
+{
+    _next = 0;
+    _count = 0;
+}
+
+uxx::app::frame_stats::summary uxx::app::frame_stats::get_summary(const frame_phase phase) const
+{
+    return summarize(*this, [phase](const frame_sample& sample) { return sample.get(phase); });
+}
+
+uxx::app::frame_stats::summary uxx::app::frame_stats::get_frame_summary() const
+{
+    return summarize(*this, [](const frame_sample& sample) { return sample.get_total(); });
+}
+
+std::size_t uxx::app::frame_stats::get_sample_count() const noexcept
+{
+    return _count;
+}
+
+std::size_t uxx::app::frame_stats::get_skipped_count() const noexcept
+{
+    std::size_t skipped = 0;
+
+    for (std::size_t age = 0; age < _count; ++age) {
+        if (get_sample(age).skipped) {
+            ++skipped;
+        }
+    }
+    return skipped;
+}
+
+const uxx::app::frame_sample& uxx::app::frame_stats::get_sample(const std::size_t age) const noexcept
+{
+    return _samples[(_next + CAPACITY - 1 - (age % CAPACITY)) % CAPACITY];
+}
@@ -0,0 +1,585 @@
+#include "common.hpp"
+#include "gl3_renderer.hpp"
+
+#include <SFML/OpenGL.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+#if defined(_WIN32)
+#define UXX_GL_API __stdcall
+#else
+#define UXX_GL_API
+#endif
+
+namespace {
+
+// Everything above OpenGL 1.1 has to be loaded at runtime, GL/gl.h of Windows doesn't even declare it
+namespace gl {
+using char_type = char;
+using sizeiptr = std::ptrdiff_t;
+using intptr = std::ptrdiff_t;
+
+constexpr GLenum ARRAY_BUFFER { 0x8892 };
+constexpr GLenum ARRAY_BUFFER_BINDING { 0x8894 };
+constexpr GLenum ELEMENT_ARRAY_BUFFER { 0x8893 };
+constexpr GLenum STREAM_DRAW { 0x88E0 };
+constexpr GLenum VERTEX_SHADER { 0x8B31 };
+constexpr GLenum FRAGMENT_SHADER { 0x8B30 };
+constexpr GLenum COMPILE_STATUS { 0x8B81 };
+constexpr GLenum LINK_STATUS { 0x8B82 };
+constexpr GLenum INFO_LOG_LENGTH { 0x8B84 };
+constexpr GLenum CURRENT_PROGRAM { 0x8B8D };
+constexpr GLenum VERTEX_ARRAY_BINDING { 0x85B5 };
+constexpr GLenum TEXTURE0 { 0x84C0 };
+constexpr GLenum ACTIVE_TEXTURE { 0x84E0 };
+constexpr GLenum FUNC_ADD { 0x8006 };
+constexpr GLbitfield MAP_WRITE_BIT { 0x0002 };
+constexpr GLbitfield MAP_PERSISTENT_BIT { 0x0040 };
+constexpr GLbitfield MAP_COHERENT_BIT { 0x0080 };
+constexpr GLenum SYNC_GPU_COMMANDS_COMPLETE { 0x9117 };
+constexpr GLbitfield SYNC_FLUSH_COMMANDS_BIT { 0x0001 };
+constexpr GLenum TIMEOUT_EXPIRED { 0x911B };
+constexpr GLenum WAIT_FAILED { 0x911D };
+
+struct sync_object;
+using sync = sync_object*;
+
+struct functions {
+    void(UXX_GL_API* GenVertexArrays)(GLsizei, GLuint*);
+    void(UXX_GL_API* DeleteVertexArrays)(GLsizei, const GLuint*);
+    void(UXX_GL_API* BindVertexArray)(GLuint);
+    void(UXX_GL_API* GenBuffers)(GLsizei, GLuint*);
+    void(UXX_GL_API* DeleteBuffers)(GLsizei, const GLuint*);
+    void(UXX_GL_API* BindBuffer)(GLenum, GLuint);
+    void(UXX_GL_API* BufferData)(GLenum, sizeiptr, const void*, GLenum);
+    void(UXX_GL_API* BufferSubData)(GLenum, intptr, sizeiptr, const void*);
+    void(UXX_GL_API* EnableVertexAttribArray)(GLuint);
+    void(UXX_GL_API* VertexAttribPointer)(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*);
+    GLuint(UXX_GL_API* CreateShader)(GLenum);
+    void(UXX_GL_API* DeleteShader)(GLuint);
+    void(UXX_GL_API* ShaderSource)(GLuint, GLsizei, const char_type* const*, const GLint*);
+    void(UXX_GL_API* CompileShader)(GLuint);
+    void(UXX_GL_API* GetShaderiv)(GLuint, GLenum, GLint*);
+    void(UXX_GL_API* GetShaderInfoLog)(GLuint, GLsizei, GLsizei*, char_type*);
+    GLuint(UXX_GL_API* CreateProgram)();
+    void(UXX_GL_API* DeleteProgram)(GLuint);
+    void(UXX_GL_API* AttachShader)(GLuint, GLuint);
+    void(UXX_GL_API* BindAttribLocation)(GLuint, GLuint, const char_type*);
+    void(UXX_GL_API* LinkProgram)(GLuint);
+    void(UXX_GL_API* GetProgramiv)(GLuint, GLenum, GLint*);
+    void(UXX_GL_API* GetProgramInfoLog)(GLuint, GLsizei, GLsizei*, char_type*);
+    void(UXX_GL_API* UseProgram)(GLuint);
+    GLint(UXX_GL_API* GetUniformLocation)(GLuint, const char_type*);
+    void(UXX_GL_API* Uniform1i)(GLint, GLint);
+    void(UXX_GL_API* UniformMatrix4fv)(GLint, GLsizei, GLboolean, const GLfloat*);
+    void(UXX_GL_API* ActiveTexture)(GLenum);
+    void(UXX_GL_API* BlendEquation)(GLenum);
+    void(UXX_GL_API* BlendFuncSeparate)(GLenum, GLenum, GLenum, GLenum);
+};
+
+// ARB_buffer_storage (OpenGL 4.4) and ARB_sync (OpenGL 3.2)
+struct buffer_storage_functions {
+    void(UXX_GL_API* BufferStorage)(GLenum, sizeiptr, const void*, GLbitfield);
+    void*(UXX_GL_API* MapBufferRange)(GLenum, intptr, sizeiptr, GLbitfield);
+    sync(UXX_GL_API* FenceSync)(GLenum, GLbitfield);
+    GLenum(UXX_GL_API* ClientWaitSync)(sync, GLbitfield, std::uint64_t);
+    void(UXX_GL_API* DeleteSync)(sync);
+};
+
+template <typename T>
+bool try_load(T& function, const char* name) noexcept
+{
+    function = reinterpret_cast<T>(sf::Context::getFunction(name));
+    return nullptr != function;
+}
+
+template <typename T>
+void load(T& function, const char* name)
+{
+    if (!try_load(function, name)) {
+        throw std::runtime_error(std::string("OpenGL 3 renderer is not supported, missing ") + name);
+    }
+}
+
+[[nodiscard]] functions load_functions()
+{
+    functions f {};
+    load(f.GenVertexArrays, "glGenVertexArrays");
+    load(f.DeleteVertexArrays, "glDeleteVertexArrays");
+    load(f.BindVertexArray, "glBindVertexArray");
+    load(f.GenBuffers, "glGenBuffers");
+    load(f.DeleteBuffers, "glDeleteBuffers");
+    load(f.BindBuffer, "glBindBuffer");
+    load(f.BufferData, "glBufferData");
+    load(f.BufferSubData, "glBufferSubData");
+    load(f.EnableVertexAttribArray, "glEnableVertexAttribArray");
+    load(f.VertexAttribPointer, "glVertexAttribPointer");
+    load(f.CreateShader, "glCreateShader");
+    load(f.DeleteShader, "glDeleteShader");
+    load(f.ShaderSource, "glShaderSource");
+    load(f.CompileShader, "glCompileShader");
+    load(f.GetShaderiv, "glGetShaderiv");
+    load(f.GetShaderInfoLog, "glGetShaderInfoLog");
+    load(f.CreateProgram, "glCreateProgram");
+    load(f.DeleteProgram, "glDeleteProgram");
+    load(f.AttachShader, "glAttachShader");
+    load(f.BindAttribLocation, "glBindAttribLocation");
+    load(f.LinkProgram, "glLinkProgram");
+    load(f.GetProgramiv, "glGetProgramiv");
+    load(f.GetProgramInfoLog, "glGetProgramInfoLog");
+    load(f.UseProgram, "glUseProgram");
+    load(f.GetUniformLocation, "glGetUniformLocation");
+    load(f.Uniform1i, "glUniform1i");
+    load(f.UniformMatrix4fv, "glUniformMatrix4fv");
+    load(f.ActiveTexture, "glActiveTexture");
+    load(f.BlendEquation, "glBlendEquation");
+    load(f.BlendFuncSeparate, "glBlendFuncSeparate");
+    return f;
+}
+
+[[nodiscard]] std::optional<buffer_storage_functions> load_buffer_storage_functions() noexcept
+{
+    if (!sf::Context::isExtensionAvailable("GL_ARB_buffer_storage") || !sf::Context::isExtensionAvailable("GL_ARB_sync")) {
+        return {};
+    }
+    buffer_storage_functions f {};
+
+    if (try_load(f.BufferStorage, "glBufferStorage")
+        && try_load(f.MapBufferRange, "glMapBufferRange")
+        && try_load(f.FenceSync, "glFenceSync")
+        && try_load(f.ClientWaitSync, "glClientWaitSync")
+        && try_load(f.DeleteSync, "glDeleteSync")) {
+        return f;
+    }
+    return {};
+}
+}
+
+// GLSL 1.30 runs on every OpenGL 3 context, including the compatibility contexts SFML creates
+constexpr const char* VERTEX_SHADER_SOURCE { R"(#version 130
+uniform mat4 projection;
+in vec2 position;
+in vec2 uv;
+in vec4 color;
+out vec2 frag_uv;
+out vec4 frag_color;
+
+void main()
+{
+    frag_uv = uv;
+    frag_color = color;
+    gl_Position = projection * vec4(position, 0.0, 1.0);
+}
+)" };
+
+constexpr const char* FRAGMENT_SHADER_SOURCE { R"(#version 130
+uniform sampler2D texture_sampler;
+in vec2 frag_uv;
+in vec4 frag_color;
+out vec4 out_color;
+
+void main()
+{
+    out_color = frag_color * texture(texture_sampler, frag_uv);
+}
+)" };
+
+enum attribute : GLuint {
+    position_attribute,
+    uv_attribute,
+    color_attribute
+};
+
+constexpr GLenum INDEX_TYPE { sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT };
+
+[[nodiscard]] const void* buffer_offset(const std::size_t offset) noexcept
+{
+    return reinterpret_cast<const void*>(offset);
+}
+
+[[nodiscard]] GLuint to_texture_handle(const ImTextureID texture_id) noexcept
+{
+    GLuint handle {};
+    std::memcpy(&handle, &texture_id, sizeof(handle));
+    return handle;
+}
+
+GLuint compile_shader(const gl::functions& f, const GLenum type, const char* source)
+{
+    const auto shader = f.CreateShader(type);
+    GLint status { GL_FALSE };
+
+    f.ShaderSource(shader, 1, &source, nullptr);
+    f.CompileShader(shader);
+    f.GetShaderiv(shader, gl::COMPILE_STATUS, &status);
+
+    if (status != GL_TRUE) {
+        GLint length { 0 };
+        f.GetShaderiv(shader, gl::INFO_LOG_LENGTH, &length);
+        std::string log(static_cast<std::size_t>(std::max(length, 1)), '\0');
+        f.GetShaderInfoLog(shader, length, nullptr, log.data());
+        f.DeleteShader(shader);
+        throw std::runtime_error("Unable to compile renderer shader: " + log);
+    }
+    return shader;
+}
+
+GLuint link_program(const gl::functions& f)
+{
+    const auto vertex_shader = compile_shader(f, gl::VERTEX_SHADER, VERTEX_SHADER_SOURCE);
+    const auto fragment_shader = compile_shader(f, gl::FRAGMENT_SHADER, FRAGMENT_SHADER_SOURCE);
+    const auto program = f.CreateProgram();
+    GLint status { GL_FALSE };
+
+    f.AttachShader(program, vertex_shader);
+    f.AttachShader(program, fragment_shader);
+    f.BindAttribLocation(program, position_attribute, "position");
+    f.BindAttribLocation(program, uv_attribute, "uv");
+    f.BindAttribLocation(program, color_attribute, "color");
+    f.LinkProgram(program);
+    // The program keeps the shaders alive for as long as it needs them
+    f.DeleteShader(vertex_shader);
+    f.DeleteShader(fragment_shader);
+    f.GetProgramiv(program, gl::LINK_STATUS, &status);
+
+    if (status != GL_TRUE) {
+        GLint length { 0 };
+        f.GetProgramiv(program, gl::INFO_LOG_LENGTH, &length);
+        std::string log(static_cast<std::size_t>(std::max(length, 1)), '\0');
+        f.GetProgramInfoLog(program, length, nullptr, log.data());
+        f.DeleteProgram(program);
+        throw std::runtime_error("Unable to link renderer shaders: " + log);
+    }
+    return program;
+}
+
+// Grow buffers geometrically so that their size, and with it the driver's allocation, rarely changes
+[[nodiscard]] std::size_t grow_capacity(const std::size_t capacity, const std::size_t required) noexcept
+{
+    return required > capacity ? std::max(required, capacity * 2) : capacity;
+}
+
+// Frames the GPU may still be reading from a persistently mapped buffer while the next one is written
+constexpr std::size_t RING_SEGMENTS { 3 };
+
+// Smallest ring segment, enough for a typical UI without reallocating
+constexpr std::size_t MIN_SEGMENT_SIZE { std::size_t { 1 } << 20 };
+
+// Where the draw data of a frame starts in the vertex and index buffers
+struct buffer_offsets {
+    std::size_t vertices;
+    std::size_t indices;
+};
+
+}
+
+struct uxx::detail::gl3_renderer::objects {
+    gl::functions f {};
+    std::optional<gl::buffer_storage_functions> storage {};
+    GLuint program { 0 };
+    GLint projection_location { -1 };
+    GLuint vertex_array { 0 };
+    GLuint vertex_buffer { 0 };
+    GLuint index_buffer { 0 };
+    // Size of the buffers when orphaning, size of each ring segment when persistently mapped
+    std::size_t vertex_capacity { 0 };
+    std::size_t index_capacity { 0 };
+    unsigned char* vertex_mapping { nullptr };
+    unsigned char* index_mapping { nullptr };
+    std::array<gl::sync, RING_SEGMENTS> fences {};
+    std::size_t segment { 0 };
+
+    // Point the vertex attributes at the vertices of a draw list, starting at a byte offset into the buffer
+    void set_vertex_offset(const std::size_t offset) const noexcept
+    {
+        constexpr auto stride = static_cast<GLsizei>(sizeof(ImDrawVert));
+        f.VertexAttribPointer(position_attribute, 2, GL_FLOAT, GL_FALSE, stride, buffer_offset(offset + offsetof(ImDrawVert, pos)));
+        f.VertexAttribPointer(uv_attribute, 2, GL_FLOAT, GL_FALSE, stride, buffer_offset(offset + offsetof(ImDrawVert, uv)));
+        f.VertexAttribPointer(color_attribute, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, buffer_offset(offset + offsetof(ImDrawVert, col)));
+    }
+
+    // Block until the GPU is done with the frame that was drawn from a ring segment
+    void wait_for(gl::sync& fence) const noexcept
+    {
+        if (nullptr == fence) {
+            return;
+        }
+        GLenum status { gl::TIMEOUT_EXPIRED };
+
+        while (status == gl::TIMEOUT_EXPIRED) {
+            status = storage->ClientWaitSync(fence, gl::SYNC_FLUSH_COMMANDS_BIT, 1'000'000'000);
+        }
+        storage->DeleteSync(fence);
+        fence = nullptr;
+    }
+
+    // Replace both buffers with immutable storage for RING_SEGMENTS segments of the given sizes, mapped once for good
+    void create_ring_buffers(const std::size_t vertex_segment_size, const std::size_t index_segment_size)
+    {
+        for (auto& fence : fences) {
+            wait_for(fence);
+        }
+        f.DeleteBuffers(1, &vertex_buffer);
+        f.DeleteBuffers(1, &index_buffer);
+        f.GenBuffers(1, &vertex_buffer);
+        f.GenBuffers(1, &index_buffer);
+
+        constexpr GLbitfield flags { gl::MAP_WRITE_BIT | gl::MAP_PERSISTENT_BIT | gl::MAP_COHERENT_BIT };
+        const auto map = [this, flags](const GLenum target, const GLuint buffer, const std::size_t segment_size) {
+            const auto size = static_cast<gl::sizeiptr>(segment_size * RING_SEGMENTS);
+            f.BindBuffer(target, buffer);
+            storage->BufferStorage(target, size, nullptr, flags);
+            return static_cast<unsigned char*>(storage->MapBufferRange(target, 0, size, flags));
+        };
+        vertex_mapping = map(gl::ARRAY_BUFFER, vertex_buffer, vertex_segment_size);
+        index_mapping = map(gl::ELEMENT_ARRAY_BUFFER, index_buffer, index_segment_size);
+
+        if (nullptr == vertex_mapping || nullptr == index_mapping) {
+            throw std::runtime_error("Unable to map renderer buffers");
+        }
+        vertex_capacity = vertex_segment_size;
+        index_capacity = index_segment_size;
+        segment = 0;
+    }
+
+    // Copy the frame into the next ring segment, which the GPU finished reading two frames ago
+    [[nodiscard]] buffer_offsets upload_persistent(const ImDrawData& draw_data, const std::size_t vertex_bytes, const std::size_t index_bytes)
+    {
+        if (vertex_bytes > vertex_capacity || index_bytes > index_capacity) {
+            create_ring_buffers(grow_capacity(vertex_capacity, vertex_bytes), grow_capacity(index_capacity, index_bytes));
+        }
+        wait_for(fences[segment]);
+
+        const buffer_offsets base { segment * vertex_capacity, segment * index_capacity };
+        auto* vertices = vertex_mapping + base.vertices;
+        auto* indices = index_mapping + base.indices;
+
+        for (int n = 0; n < draw_data.CmdListsCount; ++n) {
+            const auto& list = *draw_data.CmdLists[n];
+            const auto list_vertex_bytes = static_cast<std::size_t>(list.VtxBuffer.Size) * sizeof(ImDrawVert);
+            const auto list_index_bytes = static_cast<std::size_t>(list.IdxBuffer.Size) * sizeof(ImDrawIdx);
+
+            std::memcpy(vertices, list.VtxBuffer.Data, list_vertex_bytes);
+            std::memcpy(indices, list.IdxBuffer.Data, list_index_bytes);
+            vertices += list_vertex_bytes;
+            indices += list_index_bytes;
+        }
+        return base;
+    }
+
+    // Orphan the storage of the previous frame instead of waiting for the GPU to release it
+    [[nodiscard]] buffer_offsets upload_orphaning(const ImDrawData& draw_data, const std::size_t vertex_bytes, const std::size_t index_bytes)
+    {
+        vertex_capacity = grow_capacity(vertex_capacity, vertex_bytes);
+        index_capacity = grow_capacity(index_capacity, index_bytes);
+        f.BufferData(gl::ARRAY_BUFFER, static_cast<gl::sizeiptr>(vertex_capacity), nullptr, gl::STREAM_DRAW);
+        f.BufferData(gl::ELEMENT_ARRAY_BUFFER, static_cast<gl::sizeiptr>(index_capacity), nullptr, gl::STREAM_DRAW);
+
+        std::size_t vertex_offset { 0 };
+        std::size_t index_offset { 0 };
+
+        for (int n = 0; n < draw_data.CmdListsCount; ++n) {
+            const auto& list = *draw_data.CmdLists[n];
+            const auto list_vertex_bytes = static_cast<std::size_t>(list.VtxBuffer.Size) * sizeof(ImDrawVert);
+            const auto list_index_bytes = static_cast<std::size_t>(list.IdxBuffer.Size) * sizeof(ImDrawIdx);
+
+            f.BufferSubData(gl::ARRAY_BUFFER, static_cast<gl::intptr>(vertex_offset), static_cast<gl::sizeiptr>(list_vertex_bytes), list.VtxBuffer.Data);
+            f.BufferSubData(gl::ELEMENT_ARRAY_BUFFER, static_cast<gl::intptr>(index_offset), static_cast<gl::sizeiptr>(list_index_bytes), list.IdxBuffer.Data);
+            vertex_offset += list_vertex_bytes;
+            index_offset += list_index_bytes;
+        }
+        return { 0, 0 };
+    }
+
+    /// Expects the vertex array to be bound.
+    [[nodiscard]] buffer_offsets upload(const ImDrawData& draw_data)
+    {
+        const auto vertex_bytes = static_cast<std::size_t>(draw_data.TotalVtxCount) * sizeof(ImDrawVert);
+        const auto index_bytes = static_cast<std::size_t>(draw_data.TotalIdxCount) * sizeof(ImDrawIdx);
+
+        f.BindBuffer(gl::ARRAY_BUFFER, vertex_buffer);
+        f.BindBuffer(gl::ELEMENT_ARRAY_BUFFER, index_buffer);
+
+        if (storage) {
+            return upload_persistent(draw_data, vertex_bytes, index_bytes);
+        }
+        return upload_orphaning(draw_data, vertex_bytes, index_bytes);
+    }
+
+    // Protect the segment of this frame until the GPU has executed its draw calls
+    void end_frame() noexcept
+    {
+        if (storage) {
+            fences[segment] = storage->FenceSync(gl::SYNC_GPU_COMMANDS_COMPLETE, 0);
+            segment = (segment + 1) % RING_SEGMENTS;
+        }
+    }
+};
+
+uxx::detail::gl3_renderer::gl3_renderer(sf::RenderTarget& target, const streaming preferred)
+    : _target { target }
+    , _objects { std::make_unique<objects>() }
+{
+    if (!_target.setActive(true)) {
+        throw std::runtime_error("Unable to activate the render target");
+    }
+    auto& o = *_objects;
+    o.f = gl::load_functions();
+    o.program = link_program(o.f);
+    o.projection_location = o.f.GetUniformLocation(o.program, "projection");
+
+    GLint last_program { 0 };
+    glGetIntegerv(gl::CURRENT_PROGRAM, &last_program);
+    o.f.UseProgram(o.program);
+    o.f.Uniform1i(o.f.GetUniformLocation(o.program, "texture_sampler"), 0);
+    o.f.UseProgram(static_cast<GLuint>(last_program));
+
+    GLint last_vertex_array { 0 };
+    GLint last_array_buffer { 0 };
+    glGetIntegerv(gl::VERTEX_ARRAY_BINDING, &last_vertex_array);
+    glGetIntegerv(gl::ARRAY_BUFFER_BINDING, &last_array_buffer);
+
+    o.f.GenVertexArrays(1, &o.vertex_array);
+    o.f.BindVertexArray(o.vertex_array);
+    o.f.EnableVertexAttribArray(position_attribute);
+    o.f.EnableVertexAttribArray(uv_attribute);
+    o.f.EnableVertexAttribArray(color_attribute);
+
+    if (preferred == streaming::persistent_mapping) {
+        o.storage = gl::load_buffer_storage_functions();
+    }
+    if (o.storage) {
+        o.create_ring_buffers(MIN_SEGMENT_SIZE, MIN_SEGMENT_SIZE);
+    } else {
+        o.f.GenBuffers(1, &o.vertex_buffer);
+        o.f.GenBuffers(1, &o.index_buffer);
+    }
+    o.f.BindVertexArray(static_cast<GLuint>(last_vertex_array));
+    o.f.BindBuffer(gl::ARRAY_BUFFER, static_cast<GLuint>(last_array_buffer));
+}
+
+uxx::detail::gl3_renderer::~gl3_renderer() noexcept
+{
+    // Names are per context, so make sure to delete the ones of the target
+    if (_target.setActive(true)) {
+        auto& o = *_objects;
+
+        for (auto* fence : o.fences) {
+            if (nullptr != fence) {
+                o.storage->DeleteSync(fence);
+            }
+        }
+        // Deleting a buffer unmaps it, and the driver keeps it alive until the GPU is done with it
+        o.f.DeleteVertexArrays(1, &o.vertex_array);
+        o.f.DeleteBuffers(1, &o.vertex_buffer);
+        o.f.DeleteBuffers(1, &o.index_buffer);
+        o.f.DeleteProgram(o.program);
+    }
+}
+
+void uxx::detail::gl3_renderer::render(const ImDrawData& draw_data)
+{
+    _target.resetGLStates();
+
+    if (draw_data.CmdListsCount == 0) {
+        return;
+    }
+    const auto scale = draw_data.FramebufferScale;
+    const auto fb_width = static_cast<GLsizei>(draw_data.DisplaySize.x * scale.x);
+    const auto fb_height = static_cast<GLsizei>(draw_data.DisplaySize.y * scale.y);
+
+    if (fb_width <= 0 || fb_height <= 0) {
+        return;
+    }
+    auto& o = *_objects;
+
+    GLint last_program { 0 };
+    GLint last_vertex_array { 0 };
+    GLint last_array_buffer { 0 };
+    GLint last_active_texture { 0 };
+    GLint last_texture { 0 };
+    glGetIntegerv(gl::CURRENT_PROGRAM, &last_program);
+    glGetIntegerv(gl::VERTEX_ARRAY_BINDING, &last_vertex_array);
+    glGetIntegerv(gl::ARRAY_BUFFER_BINDING, &last_array_buffer);
+    glGetIntegerv(gl::ACTIVE_TEXTURE, &last_active_texture);
+    o.f.ActiveTexture(gl::TEXTURE0);
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
+
+    glEnable(GL_BLEND);
+    o.f.BlendEquation(gl::FUNC_ADD);
+    o.f.BlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    glDisable(GL_CULL_FACE);
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_SCISSOR_TEST);
+    glViewport(0, 0, fb_width, fb_height);
+
+    const float left = draw_data.DisplayPos.x;
+    const float right = draw_data.DisplayPos.x + draw_data.DisplaySize.x;
+    const float top = draw_data.DisplayPos.y;
+    const float bottom = draw_data.DisplayPos.y + draw_data.DisplaySize.y;
+    const std::array<GLfloat, 16> projection {
+        2.0f / (right - left), 0.0f, 0.0f, 0.0f,
+        0.0f, 2.0f / (top - bottom), 0.0f, 0.0f,
+        0.0f, 0.0f, -1.0f, 0.0f,
+        (right + left) / (left - right), (top + bottom) / (bottom - top), 0.0f, 1.0f
+    };
+    o.f.UseProgram(o.program);
+    o.f.UniformMatrix4fv(o.projection_location, 1, GL_FALSE, projection.data());
+    o.f.BindVertexArray(o.vertex_array);
+
+    const auto base = o.upload(draw_data);
+    std::size_t list_vertex_offset { base.vertices };
+    std::size_t list_index_offset { base.indices };
+
+    for (int n = 0; n < draw_data.CmdListsCount; ++n) {
+        const auto& list = *draw_data.CmdLists[n];
+        std::size_t bound_vertex_offset { SIZE_MAX };
+
+        for (const auto& command : list.CmdBuffer) {
+            if (nullptr != command.UserCallback) {
+                command.UserCallback(&list, &command);
+                continue;
+            }
+            const ImVec4 clip {
+                (command.ClipRect.x - draw_data.DisplayPos.x) * scale.x,
+                (command.ClipRect.y - draw_data.DisplayPos.y) * scale.y,
+                (command.ClipRect.z - draw_data.DisplayPos.x) * scale.x,
+                (command.ClipRect.w - draw_data.DisplayPos.y) * scale.y
+            };
+
+            if (clip.x >= static_cast<float>(fb_width) || clip.y >= static_cast<float>(fb_height) || clip.z <= 0.0f || clip.w <= 0.0f || clip.z <= clip.x || clip.w <= clip.y) {
+                continue;
+            }
+            const auto vertex_offset = list_vertex_offset + command.VtxOffset * sizeof(ImDrawVert);
+
+            if (vertex_offset != bound_vertex_offset) {
+                o.set_vertex_offset(vertex_offset);
+                bound_vertex_offset = vertex_offset;
+            }
+            glScissor(static_cast<GLint>(clip.x), static_cast<GLint>(static_cast<float>(fb_height) - clip.w),
+                static_cast<GLsizei>(clip.z - clip.x), static_cast<GLsizei>(clip.w - clip.y));
+            glBindTexture(GL_TEXTURE_2D, to_texture_handle(command.TextureId));
+            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(command.ElemCount), INDEX_TYPE,
+                buffer_offset(list_index_offset + command.IdxOffset * sizeof(ImDrawIdx)));
+        }
+        list_vertex_offset += static_cast<std::size_t>(list.VtxBuffer.Size) * sizeof(ImDrawVert);
+        list_index_offset += static_cast<std::size_t>(list.IdxBuffer.Size) * sizeof(ImDrawIdx);
+    }
+
+    o.end_frame();
+
+    // Leave the state the way SFML expects it
+    glDisable(GL_SCISSOR_TEST);
+    glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(last_texture));
+    o.f.ActiveTexture(static_cast<GLenum>(last_active_texture));
+    o.f.BindVertexArray(static_cast<GLuint>(last_vertex_array));
+    o.f.BindBuffer(gl::ARRAY_BUFFER, static_cast<GLuint>(last_array_buffer));
+    o.f.UseProgram(static_cast<GLuint>(last_program));
+}
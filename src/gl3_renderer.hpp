@@ -0,0 +1,43 @@
+#ifndef _UXX_GL3_RENDERER_HPP
+#define _UXX_GL3_RENDERER_HPP
+
+#include "common.hpp"
+
+#include <memory>
+
+namespace uxx::detail {
+
+/// Draws ImGui draw data with OpenGL 3 vertex array and buffer objects instead of client-side arrays.
+/// The draw data is streamed into the buffers without waiting for the GPU to finish reading the previous frame.
+///
+/// Owns OpenGL objects of the target's context, destroy it before the target.
+class gl3_renderer {
+public:
+    enum class streaming {
+        orphaning, // Reallocate the buffers every frame and fill them with glBufferSubData
+        persistent_mapping // Write into ring buffers that stay mapped, guarded by fences (ARB_buffer_storage)
+    };
+
+    /// \param preferred Persistent mapping falls back to orphaning when the context doesn't support it.
+    /// \throw std::runtime_error If the context of the target doesn't support OpenGL 3.
+    explicit gl3_renderer(sf::RenderTarget& target, streaming preferred = streaming::persistent_mapping);
+    ~gl3_renderer() noexcept;
+
+    gl3_renderer(const gl3_renderer&) = delete;
+    gl3_renderer(gl3_renderer&&) = delete;
+    gl3_renderer& operator=(const gl3_renderer&) = delete;
+    gl3_renderer& operator=(gl3_renderer&&) = delete;
+
+    /// Draw the data produced by ImGui::Render(), like ImGui::SFML::RenderDrawData().
+    void render(const ImDrawData& draw_data);
+
+private:
+    struct objects;
+
+    sf::RenderTarget& _target;
+    std::unique_ptr<objects> _objects;
+};
+
+}
+
+#endif
@@ -0,0 +1,57 @@
+#include "uxx/uxx.hpp"
+
+uxx::app::headless::headless(std::function<bool(std::uint64_t)> done) noexcept
+    : _done(std::move(done))
+    , _delta_time(DEFAULT_DELTA_TIME)
+    , _input_replay()
+    , _output_image()
+{
+}
+
+uxx::app::headless uxx::app::headless::frames(const std::uint64_t frame_count)
+{
+    return headless { [frame_count](const std::uint64_t frame_index) { return frame_index >= frame_count; } };
+}
+
+uxx::app::headless uxx::app::headless::until(std::function<bool(std::uint64_t)> predicate)
+{
+    return headless { std::move(predicate) };
+}
+
+uxx::app::headless uxx::app::headless::set_delta_time(const std::chrono::microseconds delta_time) noexcept
+{
+    _delta_time = delta_time;
+    return *this;
+}
+
+uxx::app::headless uxx::app::headless::set_input_replay(const std::filesystem::path& file)
+{
+    _input_replay = file;
+    return *this;
+}
+
+uxx::app::headless uxx::app::headless::set_output_image(const std::filesystem::path& file)
+{
+    _output_image = file;
+    return *this;
+}
+
+bool uxx::app::headless::is_done(const std::uint64_t frame_index) const
+{
+    return !_done || _done(frame_index);
+}
+
+std::chrono::microseconds uxx::app::headless::get_delta_time() const noexcept
+{
+    return _delta_time;
+}
+
+const std::filesystem::path& uxx::app::headless::get_input_replay() const noexcept
+{
+    return _input_replay;
+}
+
+const std::filesystem::path& uxx::app::headless::get_output_image() const noexcept
+{
+    return _output_image;
+}
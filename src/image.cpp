@@ -12,7 +12,10 @@ uxx::image::image(const std::filesystem::path& image_path) noexcept
 
     if (!_raw_image->texture.loadFromFile(path)) {
         _raw_image = nullptr;
+        return;
     }
+    const auto size = _raw_image->texture.getSize();
+    uxx::detail::count_texture_upload(std::size_t { size.x } * size.y * 4);
 }
 
 uxx::image::~image() noexcept
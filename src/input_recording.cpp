@@ -0,0 +1,171 @@
+#include "common.hpp"
+#include "input_recording.hpp"
+
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+constexpr auto FILE_HEADER = "uxx-input-recording 1";
+
+template <typename T>
+void read_fields(std::istream& in, T& field)
+{
+    in >> field;
+}
+
+template <typename T, typename... Ts>
+void read_fields(std::istream& in, T& field, Ts&... fields)
+{
+    in >> field;
+    read_fields(in, fields...);
+}
+
+template <typename T>
+T read_enum(std::istream& in)
+{
+    int value {};
+    in >> value;
+    return static_cast<T>(value);
+}
+
+}
+
+bool uxx::detail::write_event(std::ostream& out, const recorded_event& e)
+{
+    const auto& ev = e.event;
+    std::ostringstream line {};
+    line.precision(std::numeric_limits<float>::max_digits10);
+    line << e.frame_index << ' ' << e.timestamp.count() << ' ' << static_cast<int>(ev.type);
+
+    switch (ev.type) {
+    case sf::Event::Closed:
+    case sf::Event::LostFocus:
+    case sf::Event::GainedFocus:
+    case sf::Event::MouseEntered:
+    case sf::Event::MouseLeft:
+        break;
+    case sf::Event::Resized:
+        line << ' ' << ev.size.width << ' ' << ev.size.height;
+        break;
+    case sf::Event::TextEntered:
+        line << ' ' << ev.text.unicode;
+        break;
+    case sf::Event::KeyPressed:
+    case sf::Event::KeyReleased:
+        line << ' ' << static_cast<int>(ev.key.code) << ' ' << ev.key.alt << ' ' << ev.key.control << ' ' << ev.key.shift << ' ' << ev.key.system;
+        break;
+    case sf::Event::MouseWheelScrolled:
+        line << ' ' << static_cast<int>(ev.mouseWheelScroll.wheel) << ' ' << ev.mouseWheelScroll.delta << ' ' << ev.mouseWheelScroll.x << ' ' << ev.mouseWheelScroll.y;
+        break;
+    case sf::Event::MouseButtonPressed:
+    case sf::Event::MouseButtonReleased:
+        line << ' ' << static_cast<int>(ev.mouseButton.button) << ' ' << ev.mouseButton.x << ' ' << ev.mouseButton.y;
+        break;
+    case sf::Event::MouseMoved:
+        line << ' ' << ev.mouseMove.x << ' ' << ev.mouseMove.y;
+        break;
+    case sf::Event::TouchBegan:
+    case sf::Event::TouchMoved:
+    case sf::Event::TouchEnded:
+        line << ' ' << ev.touch.finger << ' ' << ev.touch.x << ' ' << ev.touch.y;
+        break;
+    default:
+        return false;
+    }
+    out << line.str() << '\n';
+    return true;
+}
+
+bool uxx::detail::read_event(std::istream& in, recorded_event& e)
+{
+    std::string text {};
+
+    if (!std::getline(in, text)) {
+        return false;
+    }
+    std::istringstream line { text };
+    std::chrono::microseconds::rep timestamp {};
+    auto& ev = e.event;
+
+    line >> e.frame_index >> timestamp;
+    e.timestamp = std::chrono::microseconds { timestamp };
+    ev.type = read_enum<sf::Event::EventType>(line);
+
+    switch (ev.type) {
+    case sf::Event::Closed:
+    case sf::Event::LostFocus:
+    case sf::Event::GainedFocus:
+    case sf::Event::MouseEntered:
+    case sf::Event::MouseLeft:
+        break;
+    case sf::Event::Resized:
+        read_fields(line, ev.size.width, ev.size.height);
+        break;
+    case sf::Event::TextEntered:
+        read_fields(line, ev.text.unicode);
+        break;
+    case sf::Event::KeyPressed:
+    case sf::Event::KeyReleased:
+        ev.key.code = read_enum<sf::Keyboard::Key>(line);
+        read_fields(line, ev.key.alt, ev.key.control, ev.key.shift, ev.key.system);
+        break;
+    case sf::Event::MouseWheelScrolled:
+        ev.mouseWheelScroll.wheel = read_enum<sf::Mouse::Wheel>(line);
+        read_fields(line, ev.mouseWheelScroll.delta, ev.mouseWheelScroll.x, ev.mouseWheelScroll.y);
+        break;
+    case sf::Event::MouseButtonPressed:
+    case sf::Event::MouseButtonReleased:
+        ev.mouseButton.button = read_enum<sf::Mouse::Button>(line);
+        read_fields(line, ev.mouseButton.x, ev.mouseButton.y);
+        break;
+    case sf::Event::MouseMoved:
+        read_fields(line, ev.mouseMove.x, ev.mouseMove.y);
+        break;
+    case sf::Event::TouchBegan:
+    case sf::Event::TouchMoved:
+    case sf::Event::TouchEnded:
+        read_fields(line, ev.touch.finger, ev.touch.x, ev.touch.y);
+        break;
+    default:
+        throw std::runtime_error("Unsupported event in input recording: " + text);
+    }
+    if (line.fail()) {
+        throw std::runtime_error("Malformed input recording line: " + text);
+    }
+    return true;
+}
+
+uxx::detail::input_recorder::input_recorder(const std::filesystem::path& file)
+    : _out { file, std::ios::trunc }
+    , _start { std::chrono::steady_clock::now() }
+{
+    if (!_out) {
+        throw std::runtime_error("Unable to create input recording: " + file.generic_string());
+    }
+    _out << FILE_HEADER << '\n';
+}
+
+void uxx::detail::input_recorder::record(const std::uint64_t frame_index, const sf::Event& event)
+{
+    const auto timestamp = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _start);
+    write_event(_out, { frame_index, timestamp, event });
+}
+
+uxx::detail::input_player::input_player(const std::filesystem::path& file)
+    : _events()
+{
+    std::ifstream in { file };
+    std::string header {};
+
+    if (!std::getline(in, header) || header != FILE_HEADER) {
+        throw std::runtime_error("Not an input recording: " + file.generic_string());
+    }
+    for (recorded_event e {}; read_event(in, e);) {
+        _events.push_back(e);
+    }
+}
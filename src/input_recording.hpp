@@ -0,0 +1,63 @@
+#ifndef _UXX_INPUT_RECORDING_HPP
+#define _UXX_INPUT_RECORDING_HPP
+
+#include "common.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iosfwd>
+#include <vector>
+
+namespace uxx::detail {
+
+/// A window event together with the frame it was handled in.
+struct recorded_event {
+    std::uint64_t frame_index;
+    /// Time since the recording started, for reference only. Replays are paced by frame index.
+    std::chrono::microseconds timestamp;
+    sf::Event event;
+};
+
+/// Write one line of an input recording.
+/// \return False if the event type is not recorded (joystick and sensor events).
+bool write_event(std::ostream& out, const recorded_event& e);
+/// Read one line of an input recording. Throws std::runtime_error on malformed lines.
+/// \return False at the end of the stream.
+bool read_event(std::istream& in, recorded_event& e);
+
+/// Writes the events handled by the main loop to an input recording file.
+class input_recorder {
+public:
+    explicit input_recorder(const std::filesystem::path& file);
+
+    void record(std::uint64_t frame_index, const sf::Event& event);
+
+private:
+    std::ofstream _out;
+    std::chrono::steady_clock::time_point _start;
+};
+
+/// Hands the events of an input recording back, frame by frame.
+class input_player {
+public:
+    explicit input_player(const std::filesystem::path& file);
+
+    /// Call 'f' with every event recorded for 'frame_index'. Frames must be played in order.
+    template <typename F>
+    void play(const std::uint64_t frame_index, F&& f)
+    {
+        for (; _next < _events.size() && _events[_next].frame_index <= frame_index; ++_next) {
+            f(_events[_next].event);
+        }
+    }
+
+private:
+    std::vector<recorded_event> _events;
+    std::size_t _next { 0 };
+};
+
+}
+
+#endif
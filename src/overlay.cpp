@@ -0,0 +1,99 @@
+#include "common.hpp"
+#include "uxx/uxx.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+using milliseconds = std::chrono::duration<double, std::milli>;
+
+constexpr uxx::vec2d GRAPH_SIZE { 320.0f, 80.0f };
+
+constexpr std::array<const char*, uxx::app::FRAME_PHASE_COUNT> PHASE_NAMES { "Events", "Update", "Callback", "Render", "Display" };
+
+[[nodiscard]] double to_milliseconds(const std::chrono::nanoseconds time) noexcept
+{
+    return std::chrono::duration_cast<milliseconds>(time).count();
+}
+
+// One bar per recorded frame, newest to the right, with a line marking the frame budget
+void draw_frame_graph(const uxx::canvas& canvas, uxx::pencil& pencil, const uxx::app::frame_stats& stats, const std::chrono::nanoseconds budget)
+{
+    const auto origin = canvas.get_position();
+    const auto size = canvas.get_size();
+    const auto sample_count = stats.get_sample_count();
+
+    pencil.set_color(uxx::rgba_color { 0.0f, 0.0f, 0.0f, 0.5f });
+    pencil.draw_rect_filled(origin, { origin.x + size.x, origin.y + size.y });
+
+    auto scale = std::max(budget, stats.get_frame_summary().p99);
+
+    for (std::size_t age = 0; age < sample_count; ++age) {
+        scale = std::max(scale, stats.get_sample(age).get_total());
+    }
+    if (scale.count() == 0) {
+        return;
+    }
+    const auto to_height = [&](const std::chrono::nanoseconds time) {
+        return static_cast<float>(static_cast<double>(time.count()) / static_cast<double>(scale.count())) * size.y;
+    };
+    const auto bar_width = size.x / static_cast<float>(uxx::app::frame_stats::CAPACITY);
+
+    for (std::size_t age = 0; age < sample_count; ++age) {
+        const auto total = stats.get_sample(age).get_total();
+        const auto x = origin.x + size.x - static_cast<float>(age + 1) * bar_width;
+
+        pencil.set_color(total > budget && budget.count() > 0 ? uxx::rgb_color { 0.9f, 0.3f, 0.2f } : uxx::rgb_color { 0.3f, 0.8f, 0.4f });
+        pencil.draw_rect_filled({ x, origin.y + size.y - to_height(total) }, { x + bar_width, origin.y + size.y });
+    }
+    if (budget.count() > 0) {
+        const auto y = origin.y + size.y - to_height(budget);
+        pencil.set_color(uxx::rgb_color { 1.0f, 1.0f, 0.4f });
+        pencil.draw_line({ origin.x, y }, { origin.x + size.x, y });
+    }
+}
+
+}
+
+void uxx::app::draw_overlay(result<bool>& visible) const
+{
+    if (!visible.get()) {
+        return;
+    }
+    const screen s {};
+    const auto properties = pane::properties {}
+                                .set_always_auto_resize()
+                                .set_no_saved_settings()
+                                .set_no_focus_on_appearing()
+                                .set_no_nav();
+
+    s.window("Performance (F12)##uxx_overlay", visible, properties, [this](pane& p) {
+        const auto& stats = get_frame_stats();
+        const auto report = get_last_frame_report();
+        const auto frame = stats.get_frame_summary();
+        std::array<char, 128> text {};
+
+        std::snprintf(text.data(), text.size(), "Frame %.2f ms (avg %.2f, p95 %.2f, p99 %.2f)", to_milliseconds(report.frame_time), to_milliseconds(frame.avg), to_milliseconds(frame.p95), to_milliseconds(frame.p99));
+        p.label(text.data());
+        p.canvas(uxx::id { "##uxx_overlay_graph" }, GRAPH_SIZE, [&](uxx::canvas& c, uxx::pencil& pencil) {
+            draw_frame_graph(c, pencil, stats, _frame_policy.get_frame_budget());
+        });
+
+        for (std::size_t i = 0; i < FRAME_PHASE_COUNT; ++i) {
+            const auto phase = stats.get_summary(static_cast<frame_phase>(i));
+            std::snprintf(text.data(), text.size(), "%-9s avg %6.2f  p95 %6.2f  p99 %6.2f ms", PHASE_NAMES[i], to_milliseconds(phase.avg), to_milliseconds(phase.p95), to_milliseconds(phase.p99));
+            p.label(text.data());
+        }
+
+        const auto& counters = report.counters;
+        std::snprintf(text.data(), text.size(), "Vertices %zu  Indices %zu  Draw commands %zu of %zu", counters.vertices, counters.indices, counters.draw_commands, counters.unmerged_draw_commands);
+        p.label(text.data());
+        std::snprintf(text.data(), text.size(), "Texture uploads %.1f KiB  Redrawn pixels %zu  Culled %zu", static_cast<double>(counters.texture_upload_bytes) / 1024.0, counters.redrawn_pixels, counters.culled_primitives);
+        p.label(text.data());
+        std::snprintf(text.data(), text.size(), "Unchanged frames skipped %zu of %zu", stats.get_skipped_count(), stats.get_sample_count());
+        p.label(text.data());
+    });
+}
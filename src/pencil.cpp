@@ -1,11 +1,12 @@
 #include "common.hpp"
+#include "clip_culling.hpp"
+#include "draw_list.hpp"
+#include "polyline_lod.hpp"
 #include "uxx/uxx.hpp"
 
-#ifdef _WIN32
 #include <algorithm>
-#else
-#include <ranges>
-#endif
+#include <array>
+#include <utility>
 
 namespace {
 
@@ -19,16 +20,40 @@ namespace {
     return ImVec2 { point.x, point.y };
 }
 
-[[nodiscard]] std::vector<ImVec2> from_vec2d(const std::vector<uxx::vec2d>& points) noexcept
+// Like ImGui, an explicit number of segments is clamped to avoid insanely tessellated circles
+[[nodiscard]] std::size_t get_circle_segments(uxx::detail::shape_cache& cache, const float radius, const int num_segments)
 {
-    static const auto convert = [](const uxx::vec2d& p) { return from_vec2d(p); };
-    std::vector<ImVec2> copy;
-#ifdef _WIN32
-    std::transform(points.cbegin(), points.cend(), std::back_inserter(copy), convert);
-#else
-    std::ranges::transform(points, std::back_inserter(copy), convert);
-#endif
-    return copy;
+    if (num_segments <= 0) {
+        return cache.get_circle_segments(radius, ImGui::GetStyle().CircleSegmentMaxError);
+    }
+    return std::clamp(static_cast<std::size_t>(num_segments), std::size_t { 3 }, uxx::detail::shape_cache::MAX_CIRCLE_SEGMENTS);
+}
+
+[[nodiscard]] uxx::detail::bounds get_bounds(const ImVec2& center, const float radius) noexcept
+{
+    return { ImVec2 { center.x - radius, center.y - radius }, ImVec2 { center.x + radius, center.y + radius } };
+}
+
+// Leave out primitives outside the clip rectangle before they are tessellated, and count them for the frame counters
+[[nodiscard]] bool is_culled(const ImDrawList& draw_list, const uxx::detail::bounds& b, const float margin) noexcept
+{
+    if (uxx::detail::is_clipped(draw_list, b, margin)) {
+        uxx::detail::count_culled_primitives(1);
+        return true;
+    }
+    return false;
+}
+
+void count_culled(const std::size_t count) noexcept
+{
+    if (count > 0) {
+        uxx::detail::count_culled_primitives(count);
+    }
+}
+
+[[nodiscard]] uxx::strided_points from_spans(const std::span<const float> x, const std::span<const float> y) noexcept
+{
+    return { x.data(), y.data(), std::min(x.size(), y.size()), sizeof(float) };
 }
 
 }
@@ -93,12 +118,18 @@ static auto get_draw_list(const uxx::pencil::type type) noexcept
 }
 
 uxx::pencil::pencil(const uxx::pencil::type pencil_type) noexcept
-    : _draw_list(get_draw_list(pencil_type))
+    : pencil(std::any { get_draw_list(pencil_type) })
+{
+}
+
+uxx::pencil::pencil(std::any draw_list) noexcept
+    : _draw_list(std::move(draw_list))
     , _color(ImGui::GetColorU32({ 1.0f, 1.0f, 1.0f, 1.0f }))
     , _thickness(1.0f)
     , _rounding(0.0f)
 {
-    cast_draw_list(_draw_list).Flags = ImDrawListFlags_None | ImDrawListFlags_AntiAliasedLines | ImDrawListFlags_AntiAliasedFill;
+    // Keeps the flags ImGui chose for the frame, e.g. the vertex offsets that split large draw lists for 16-bit indices
+    cast_draw_list(_draw_list).Flags |= ImDrawListFlags_AntiAliasedLines | ImDrawListFlags_AntiAliasedFill;
 }
 
 void uxx::pencil::set_color(const uxx::rgb_color& color) noexcept
@@ -128,42 +159,86 @@ void uxx::pencil::set_rounding(float rounding) noexcept
 
 void uxx::pencil::draw_line(const uxx::vec2d& from, const uxx::vec2d& to) const
 {
-    cast_draw_list(_draw_list).AddLine(from_vec2d(from), from_vec2d(to), _color, _thickness);
+    auto& draw_list = cast_draw_list(_draw_list);
+
+    if (is_culled(draw_list, uxx::detail::get_bounds(from_vec2d(from), from_vec2d(to)), uxx::detail::get_stroke_cull_margin(_thickness))) {
+        return;
+    }
+    draw_list.AddLine(from_vec2d(from), from_vec2d(to), _color, _thickness);
 }
 
 void uxx::pencil::draw_rect(const uxx::vec2d& min, const uxx::vec2d& max) const
 {
-    cast_draw_list(_draw_list).AddRect(from_vec2d(min), from_vec2d(max), _color, _rounding, static_cast<ImDrawCornerFlags>(_corner_props), _thickness);
+    auto& draw_list = cast_draw_list(_draw_list);
+
+    if (is_culled(draw_list, uxx::detail::get_bounds(from_vec2d(min), from_vec2d(max)), uxx::detail::get_stroke_cull_margin(_thickness))) {
+        return;
+    }
+    draw_list.AddRect(from_vec2d(min), from_vec2d(max), _color, _rounding, static_cast<ImDrawCornerFlags>(_corner_props), _thickness);
 }
 
 void uxx::pencil::draw_rect_filled(const uxx::vec2d& min, const uxx::vec2d& max) const
 {
-    cast_draw_list(_draw_list).AddRectFilled(from_vec2d(min), from_vec2d(max), _color, _rounding, static_cast<ImDrawCornerFlags>(_corner_props));
+    auto& draw_list = cast_draw_list(_draw_list);
+
+    if (is_culled(draw_list, uxx::detail::get_bounds(from_vec2d(min), from_vec2d(max)), uxx::detail::FILL_CULL_MARGIN)) {
+        return;
+    }
+    draw_list.AddRectFilled(from_vec2d(min), from_vec2d(max), _color, _rounding, static_cast<ImDrawCornerFlags>(_corner_props));
 }
 
 void uxx::pencil::draw_rect_filled_multi_color(const uxx::vec2d& min, const uxx::vec2d& max, const uxx::color_rect& colors) const
 {
-    cast_draw_list(_draw_list).AddRectFilledMultiColor(from_vec2d(min), from_vec2d(max), colors.upper_left.to_color32(), colors.upper_right.to_color32(), colors.bottom_right.to_color32(), colors.bottom_left.to_color32());
+    auto& draw_list = cast_draw_list(_draw_list);
+
+    if (is_culled(draw_list, uxx::detail::get_bounds(from_vec2d(min), from_vec2d(max)), uxx::detail::FILL_CULL_MARGIN)) {
+        return;
+    }
+    draw_list.AddRectFilledMultiColor(from_vec2d(min), from_vec2d(max), colors.upper_left.to_color32(), colors.upper_right.to_color32(), colors.bottom_right.to_color32(), colors.bottom_left.to_color32());
 }
 
 void uxx::pencil::draw_quad(const uxx::vec2d& p1, const uxx::vec2d& p2, const uxx::vec2d& p3, const uxx::vec2d& p4) const
 {
-    cast_draw_list(_draw_list).AddQuad(from_vec2d(p1), from_vec2d(p2), from_vec2d(p3), from_vec2d(p4), _color, _thickness);
+    auto& draw_list = cast_draw_list(_draw_list);
+    const std::array<ImVec2, 4> points { from_vec2d(p1), from_vec2d(p2), from_vec2d(p3), from_vec2d(p4) };
+
+    if (is_culled(draw_list, uxx::detail::get_bounds(points), uxx::detail::get_stroke_cull_margin(_thickness))) {
+        return;
+    }
+    draw_list.AddQuad(points[0], points[1], points[2], points[3], _color, _thickness);
 }
 
 void uxx::pencil::draw_quad_filled(const uxx::vec2d& p1, const uxx::vec2d& p2, const uxx::vec2d& p3, const uxx::vec2d& p4) const
 {
-    cast_draw_list(_draw_list).AddQuadFilled(from_vec2d(p1), from_vec2d(p2), from_vec2d(p3), from_vec2d(p4), _color);
+    auto& draw_list = cast_draw_list(_draw_list);
+    const std::array<ImVec2, 4> points { from_vec2d(p1), from_vec2d(p2), from_vec2d(p3), from_vec2d(p4) };
+
+    if (is_culled(draw_list, uxx::detail::get_bounds(points), uxx::detail::FILL_CULL_MARGIN)) {
+        return;
+    }
+    draw_list.AddQuadFilled(points[0], points[1], points[2], points[3], _color);
 }
 
 void uxx::pencil::draw_triangle(const uxx::vec2d& p1, const uxx::vec2d& p2, const uxx::vec2d& p3) const
 {
-    cast_draw_list(_draw_list).AddTriangle(from_vec2d(p1), from_vec2d(p2), from_vec2d(p3), _color, _thickness);
+    auto& draw_list = cast_draw_list(_draw_list);
+    const std::array<ImVec2, 3> points { from_vec2d(p1), from_vec2d(p2), from_vec2d(p3) };
+
+    if (is_culled(draw_list, uxx::detail::get_bounds(points), uxx::detail::get_stroke_cull_margin(_thickness))) {
+        return;
+    }
+    draw_list.AddTriangle(points[0], points[1], points[2], _color, _thickness);
 }
 
 void uxx::pencil::draw_triangle_filled(const uxx::vec2d& p1, const uxx::vec2d& p2, const uxx::vec2d& p3) const
 {
-    cast_draw_list(_draw_list).AddTriangleFilled(from_vec2d(p1), from_vec2d(p2), from_vec2d(p3), _color);
+    auto& draw_list = cast_draw_list(_draw_list);
+    const std::array<ImVec2, 3> points { from_vec2d(p1), from_vec2d(p2), from_vec2d(p3) };
+
+    if (is_culled(draw_list, uxx::detail::get_bounds(points), uxx::detail::FILL_CULL_MARGIN)) {
+        return;
+    }
+    draw_list.AddTriangleFilled(points[0], points[1], points[2], _color);
 }
 
 void uxx::pencil::draw_circle(const uxx::vec2d& center, const uxx::radius radius) const
@@ -173,7 +248,18 @@ void uxx::pencil::draw_circle(const uxx::vec2d& center, const uxx::radius radius
 
 void uxx::pencil::draw_circle(const uxx::vec2d& center, const uxx::radius radius, int num_segments) const
 {
-    cast_draw_list(_draw_list).AddCircle(from_vec2d(center), radius.get(), _color, num_segments, _thickness);
+    if (radius.get() <= 0.0f) {
+        return;
+    }
+    auto& draw_list = cast_draw_list(_draw_list);
+
+    if (is_culled(draw_list, get_bounds(from_vec2d(center), radius.get()), uxx::detail::get_stroke_cull_margin(_thickness))) {
+        return;
+    }
+    auto& cache = uxx::detail::get_shape_cache();
+    const auto& polygon = cache.get_polygon(get_circle_segments(cache, radius.get(), num_segments));
+    // Like ImGui, the outline is centered on the edge of the filled circle
+    uxx::detail::add_polygon(draw_list, polygon, from_vec2d(center), radius.get() - 0.5f, _color, _thickness);
 }
 
 void uxx::pencil::draw_circle_filled(const uxx::vec2d& center, const uxx::radius radius) const
@@ -183,29 +269,97 @@ void uxx::pencil::draw_circle_filled(const uxx::vec2d& center, const uxx::radius
 
 void uxx::pencil::draw_circle_filled(const uxx::vec2d& center, const uxx::radius radius, int num_segments) const
 {
-    cast_draw_list(_draw_list).AddCircleFilled(from_vec2d(center), radius.get(), _color, num_segments);
+    if (radius.get() <= 0.0f) {
+        return;
+    }
+    auto& draw_list = cast_draw_list(_draw_list);
+
+    if (is_culled(draw_list, get_bounds(from_vec2d(center), radius.get()), uxx::detail::FILL_CULL_MARGIN)) {
+        return;
+    }
+    auto& cache = uxx::detail::get_shape_cache();
+    const auto& polygon = cache.get_polygon(get_circle_segments(cache, radius.get(), num_segments));
+    uxx::detail::add_polygon_filled(draw_list, polygon, from_vec2d(center), radius.get(), _color);
 }
 
 void uxx::pencil::draw_ngon(const uxx::vec2d& center, const uxx::radius radius, int num_segments) const
 {
-    cast_draw_list(_draw_list).AddNgon(from_vec2d(center), radius.get(), _color, num_segments, _thickness);
+    if (num_segments < 3) {
+        return;
+    }
+    auto& draw_list = cast_draw_list(_draw_list);
+
+    if (is_culled(draw_list, get_bounds(from_vec2d(center), radius.get()), uxx::detail::get_stroke_cull_margin(_thickness))) {
+        return;
+    }
+    const auto& polygon = uxx::detail::get_shape_cache().get_polygon(static_cast<std::size_t>(num_segments));
+    uxx::detail::add_polygon(draw_list, polygon, from_vec2d(center), radius.get() - 0.5f, _color, _thickness);
 }
 
 void uxx::pencil::draw_ngon_filled(const uxx::vec2d& center, const uxx::radius radius, int num_segments) const
 {
-    cast_draw_list(_draw_list).AddNgonFilled(from_vec2d(center), radius.get(), _color, num_segments);
+    if (num_segments < 3) {
+        return;
+    }
+    auto& draw_list = cast_draw_list(_draw_list);
+
+    if (is_culled(draw_list, get_bounds(from_vec2d(center), radius.get()), uxx::detail::FILL_CULL_MARGIN)) {
+        return;
+    }
+    const auto& polygon = uxx::detail::get_shape_cache().get_polygon(static_cast<std::size_t>(num_segments));
+    uxx::detail::add_polygon_filled(draw_list, polygon, from_vec2d(center), radius.get(), _color);
+}
+
+void uxx::pencil::draw_polyline(const std::span<const uxx::vec2d> points, const bool closed) const
+{
+    count_culled(uxx::detail::add_visible_polyline(cast_draw_list(_draw_list), uxx::detail::as_im_vec2(points), _color, closed, _thickness));
+}
+
+void uxx::pencil::draw_polyline(const std::span<const float> x, const std::span<const float> y, const bool closed) const
+{
+    draw_polyline(from_spans(x, y), closed);
+}
+
+void uxx::pencil::draw_polyline(const uxx::strided_points& points, const bool closed) const
+{
+    auto& draw_list = cast_draw_list(_draw_list);
+    count_culled(uxx::detail::add_visible_polyline(draw_list, uxx::detail::gather_path(draw_list, points), _color, closed, _thickness));
+    draw_list.PathClear();
+}
+
+void uxx::pencil::draw_polyline_lod(const std::span<const uxx::plot_sample> samples, const uxx::plot_view& view) const
+{
+    auto& draw_list = cast_draw_list(_draw_list);
+    uxx::detail::reduce_to_columns(samples, view, draw_list._Path);
+    count_culled(uxx::detail::add_visible_polyline(draw_list, { draw_list._Path.Data, static_cast<std::size_t>(draw_list._Path.Size) }, _color, false, _thickness));
+    draw_list.PathClear();
+}
+
+void uxx::pencil::draw_convex_poly_filled(const std::span<const uxx::vec2d> points) const
+{
+    auto& draw_list = cast_draw_list(_draw_list);
+    const auto im_points = uxx::detail::as_im_vec2(points);
+
+    if (im_points.empty() || is_culled(draw_list, uxx::detail::get_bounds(im_points), uxx::detail::FILL_CULL_MARGIN)) {
+        return;
+    }
+    draw_list.AddConvexPolyFilled(im_points.data(), static_cast<int>(im_points.size()), _color);
 }
 
-void uxx::pencil::draw_polyline(const std::vector<uxx::vec2d>& points, bool closed) const
+void uxx::pencil::draw_convex_poly_filled(const std::span<const float> x, const std::span<const float> y) const
 {
-    const auto copy = from_vec2d(points);
-    cast_draw_list(_draw_list).AddPolyline(copy.data(), static_cast<int>(copy.size()), _color, closed, _thickness);
+    draw_convex_poly_filled(from_spans(x, y));
 }
 
-void uxx::pencil::draw_convex_poly_filled(const std::vector<uxx::vec2d>& points) const
+void uxx::pencil::draw_convex_poly_filled(const uxx::strided_points& points) const
 {
-    const auto copy = from_vec2d(points);
-    cast_draw_list(_draw_list).AddConvexPolyFilled(copy.data(), static_cast<int>(copy.size()), _color);
+    auto& draw_list = cast_draw_list(_draw_list);
+    const auto path = uxx::detail::gather_path(draw_list, points);
+
+    if (!path.empty() && !is_culled(draw_list, uxx::detail::get_bounds(path), uxx::detail::FILL_CULL_MARGIN)) {
+        draw_list.AddConvexPolyFilled(path.data(), static_cast<int>(path.size()), _color);
+    }
+    draw_list.PathClear();
 }
 
 void uxx::pencil::draw_bezier_curve(const uxx::vec2d& p1, const uxx::vec2d& p2, const uxx::vec2d& p3, const uxx::vec2d& p4) const
@@ -215,7 +369,51 @@ void uxx::pencil::draw_bezier_curve(const uxx::vec2d& p1, const uxx::vec2d& p2,
 
 void uxx::pencil::draw_bezier_curve(const uxx::vec2d& p1, const uxx::vec2d& p2, const uxx::vec2d& p3, const uxx::vec2d& p4, int num_segments) const
 {
-    cast_draw_list(_draw_list).AddBezierCurve(from_vec2d(p1), from_vec2d(p2), from_vec2d(p3), from_vec2d(p4), _color, _thickness, num_segments);
+    auto& draw_list = cast_draw_list(_draw_list);
+    const std::array<ImVec2, 4> points { from_vec2d(p1), from_vec2d(p2), from_vec2d(p3), from_vec2d(p4) };
+
+    // The curve never leaves the hull of its control points
+    if (is_culled(draw_list, uxx::detail::get_bounds(points), uxx::detail::get_stroke_cull_margin(_thickness))) {
+        return;
+    }
+    const auto segments = static_cast<std::size_t>(std::max(num_segments, 0));
+    uxx::detail::add_bezier_curve(draw_list, uxx::detail::get_shape_cache(), points, _color, _thickness, segments);
+}
+
+void uxx::pencil::draw_lines(const std::span<const uxx::segment> segments) const
+{
+    count_culled(uxx::detail::add_lines(cast_draw_list(_draw_list), segments, _color, _thickness));
+}
+
+void uxx::pencil::draw_rects_filled(const std::span<const uxx::rect> rects) const
+{
+    auto& draw_list = cast_draw_list(_draw_list);
+
+    if (_rounding > 0.0f) {
+        // Rounded corners are paths of their own
+        for (const auto& r : rects) {
+            if (!is_culled(draw_list, uxx::detail::get_bounds(from_vec2d(r.min), from_vec2d(r.max)), uxx::detail::FILL_CULL_MARGIN)) {
+                draw_list.AddRectFilled(from_vec2d(r.min), from_vec2d(r.max), _color, _rounding, static_cast<ImDrawCornerFlags>(_corner_props));
+            }
+        }
+        return;
+    }
+    count_culled(uxx::detail::add_rects_filled(draw_list, rects, _color));
+}
+
+void uxx::pencil::draw_triangles_filled(const std::span<const uxx::triangle> triangles) const
+{
+    count_culled(uxx::detail::add_triangles_filled(cast_draw_list(_draw_list), triangles, _color));
+}
+
+void uxx::pencil::draw(const uxx::drawing& d) const
+{
+    count_culled(d.replay(_draw_list, { 0.0f, 0.0f }, 1.0f));
+}
+
+void uxx::pencil::draw(const uxx::drawing& d, const uxx::vec2d& translation, const float scale) const
+{
+    count_culled(d.replay(_draw_list, translation, scale));
 }
 
 void uxx::pencil::push_clip_rect(const uxx::vec2d& min, const uxx::vec2d& max, const bool intersect_with_current_clip_rect) const
@@ -0,0 +1,56 @@
+#include "common.hpp"
+#include "polyline_lod.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+void uxx::detail::reduce_to_columns(const std::span<const uxx::plot_sample> samples, const uxx::plot_view& view, ImVector<ImVec2>& reduced)
+{
+    reduced.resize(0);
+
+    if (!(view.max_x > view.min_x)) {
+        return;
+    }
+    auto first = std::lower_bound(samples.begin(), samples.end(), view.min_x, [](const uxx::plot_sample& sample, const double x) { return sample.x < x; });
+    auto last = std::upper_bound(first, samples.end(), view.max_x, [](const double x, const uxx::plot_sample& sample) { return x < sample.x; });
+
+    if (first != samples.begin()) {
+        --first;
+    }
+    if (last != samples.end()) {
+        ++last;
+    }
+    // Pixels per unit of x, in double so that columns stay apart far from zero
+    const double x_scale = static_cast<double>(view.screen.max.x - view.screen.min.x) / (view.max_x - view.min_x);
+    const float y_scale = view.max_y > view.min_y ? (view.screen.max.y - view.screen.min.y) / (view.max_y - view.min_y) : 0.0f;
+    const auto column_of = [&](const uxx::plot_sample& sample) { return std::floor((sample.x - view.min_x) * x_scale); };
+    const auto to_screen = [&](const uxx::plot_sample& sample) {
+        return ImVec2 { view.screen.min.x + static_cast<float>((sample.x - view.min_x) * x_scale), view.screen.max.y - (sample.y - view.min_y) * y_scale };
+    };
+
+    for (auto column_start = first; column_start != last;) {
+        const double column = column_of(*column_start);
+        auto lowest = column_start;
+        auto highest = column_start;
+        auto end = column_start + 1;
+
+        for (; end != last && column_of(*end) == column; ++end) {
+            if (end->y < lowest->y) {
+                lowest = end;
+            }
+            if (end->y > highest->y) {
+                highest = end;
+            }
+        }
+        // The four samples in their original order, each once
+        std::array<decltype(end), 4> kept { column_start, lowest, highest, end - 1 };
+        std::sort(kept.begin(), kept.end());
+        const auto unique_end = std::unique(kept.begin(), kept.end());
+
+        for (auto sample = kept.begin(); sample != unique_end; ++sample) {
+            reduced.push_back(to_screen(**sample));
+        }
+        column_start = end;
+    }
+}
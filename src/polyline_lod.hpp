@@ -0,0 +1,22 @@
+#ifndef _UXX_POLYLINE_LOD_HPP
+#define _UXX_POLYLINE_LOD_HPP
+
+#include "common.hpp"
+#include "uxx/uxx.hpp"
+
+#include <span>
+
+namespace uxx::detail {
+
+/// Reduce samples sorted by x to the first, lowest, highest and last sample of every pixel column of the view (M4).
+/// A polyline through the reduced samples covers the same pixels as one through all of them, with at most
+/// four points per column. Samples outside [view.min_x, view.max_x] are dropped, except the nearest one on either
+/// side, so the polyline still leaves the view towards them. The visible samples are found by binary search,
+/// and only the ones kept are mapped to the screen.
+/// \param reduced Receives the kept samples in screen coordinates and in their original order, its capacity is reused
+///                from call to call. Empty if the x-range of the view is.
+void reduce_to_columns(std::span<const uxx::plot_sample> samples, const uxx::plot_view& view, ImVector<ImVec2>& reduced);
+
+}
+
+#endif
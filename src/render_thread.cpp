@@ -0,0 +1,137 @@
+#include "common.hpp"
+#include "render_thread.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+template <typename T>
+void copy_vector(ImVector<T>& destination, const ImVector<T>& source)
+{
+    // ImVector::resize() keeps the allocation when it is large enough, unlike its assignment operator
+    destination.resize(source.Size);
+    std::copy(source.begin(), source.end(), destination.begin());
+}
+
+}
+
+void uxx::detail::draw_data_copy::assign(const ImDrawData& source)
+{
+    const auto count = static_cast<std::size_t>(source.CmdListsCount);
+
+    while (_lists.size() < count) {
+        _lists.push_back(std::make_unique<ImDrawList>(nullptr));
+    }
+    _list_pointers.resize(count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto& list = *source.CmdLists[i];
+        auto& copy = *_lists[i];
+        copy_vector(copy.CmdBuffer, list.CmdBuffer);
+        copy_vector(copy.IdxBuffer, list.IdxBuffer);
+        copy_vector(copy.VtxBuffer, list.VtxBuffer);
+        copy.Flags = list.Flags;
+        _list_pointers[i] = &copy;
+    }
+    _draw_data.Valid = source.Valid;
+    _draw_data.CmdLists = _list_pointers.data();
+    _draw_data.CmdListsCount = source.CmdListsCount;
+    _draw_data.TotalIdxCount = source.TotalIdxCount;
+    _draw_data.TotalVtxCount = source.TotalVtxCount;
+    _draw_data.DisplayPos = source.DisplayPos;
+    _draw_data.DisplaySize = source.DisplaySize;
+    _draw_data.FramebufferScale = source.FramebufferScale;
+}
+
+ImDrawData& uxx::detail::draw_data_copy::get() noexcept
+{
+    return _draw_data;
+}
+
+uxx::detail::render_thread::render_thread(render_function render, activate_function activate)
+    : _render(std::move(render))
+    , _activate(std::move(activate))
+    , _thread([this]() { run(); })
+{
+}
+
+uxx::detail::render_thread::~render_thread() noexcept
+{
+    {
+        // An error of the last frame has nobody left to report it to
+        std::unique_lock lock { _mutex };
+        _changed.wait(lock, [this]() { return !_pending && !_busy; });
+        _stopping = true;
+    }
+    _changed.notify_all();
+    _thread.join();
+}
+
+std::size_t uxx::detail::render_thread::submit(const ImDrawData& draw_data, const bool textures_changed)
+{
+    // Only this thread swaps the buffers, the back buffer can be written while the front buffer is rendered
+    const auto back = 1 - _front;
+    _buffers[back].assign(draw_data);
+    std::size_t drawn_pixels = 0;
+    {
+        std::unique_lock lock { _mutex };
+        wait_until_idle(lock);
+        drawn_pixels = _drawn_pixels;
+        _front = back;
+        _textures_changed = textures_changed;
+        _pending = true;
+    }
+    _changed.notify_all();
+    return drawn_pixels;
+}
+
+void uxx::detail::render_thread::finish()
+{
+    std::unique_lock lock { _mutex };
+    wait_until_idle(lock);
+}
+
+void uxx::detail::render_thread::wait_until_idle(std::unique_lock<std::mutex>& lock)
+{
+    _changed.wait(lock, [this]() { return !_pending && !_busy; });
+
+    if (_error) {
+        std::rethrow_exception(std::exchange(_error, nullptr));
+    }
+}
+
+void uxx::detail::render_thread::run()
+{
+    _activate(true);
+    std::unique_lock lock { _mutex };
+
+    while (true) {
+        _changed.wait(lock, [this]() { return _pending || _stopping; });
+
+        if (!_pending) {
+            break;
+        }
+        _pending = false;
+        _busy = true;
+        auto& draw_data = _buffers[_front].get();
+        const bool textures_changed = _textures_changed;
+        lock.unlock();
+
+        std::size_t drawn_pixels = 0;
+        std::exception_ptr error {};
+
+        try {
+            drawn_pixels = _render(draw_data, textures_changed);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        lock.lock();
+        _busy = false;
+        _drawn_pixels = drawn_pixels;
+        _error = error;
+        _changed.notify_all();
+    }
+    lock.unlock();
+    _activate(false);
+}
@@ -0,0 +1,84 @@
+#ifndef _UXX_RENDER_THREAD_HPP
+#define _UXX_RENDER_THREAD_HPP
+
+#include "common.hpp"
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace uxx::detail {
+
+/// Deep copy of ImDrawData that stays valid while ImGui builds the next frame.
+/// Copying another frame into it reuses the memory of the previous one.
+class draw_data_copy {
+public:
+    void assign(const ImDrawData& source);
+
+    [[nodiscard]] ImDrawData& get() noexcept;
+
+private:
+    ImDrawData _draw_data {};
+    std::vector<std::unique_ptr<ImDrawList>> _lists {};
+    std::vector<ImDrawList*> _list_pointers {};
+};
+
+/// Renders and presents frames on a thread of its own, while the calling thread builds the next frame.
+/// The draw data is copied into a back buffer that is swapped with the front buffer once the render thread is done
+/// with the previous frame, so building, copying and rendering overlap.
+class render_thread {
+public:
+    /// Draws a frame on the render thread.
+    /// \return Number of pixels drawn.
+    using render_function = std::function<std::size_t(ImDrawData& draw_data, bool textures_changed)>;
+    /// Called on the render thread with true before the first frame and with false after the last one,
+    /// e.g. to make the OpenGL context of the target current on it.
+    using activate_function = std::function<void(bool active)>;
+
+    explicit render_thread(render_function render, activate_function activate);
+    /// Finishes the frame in flight before the thread ends.
+    ~render_thread() noexcept;
+
+    render_thread(const render_thread&) = delete;
+    render_thread(render_thread&&) = delete;
+    render_thread& operator=(const render_thread&) = delete;
+    render_thread& operator=(render_thread&&) = delete;
+
+    /// Copy the draw data, wait for the frame in flight and hand the copy to the render thread.
+    /// Rethrows the exception that rendering a previous frame threw.
+    /// \param textures_changed Passed on to the render function.
+    /// \return Number of pixels the previous frame drew, the frame in flight is one frame behind.
+    std::size_t submit(const ImDrawData& draw_data, bool textures_changed);
+    /// Wait until every submitted frame is rendered.
+    /// Rethrows the exception that rendering a previous frame threw.
+    void finish();
+
+private:
+    render_function _render;
+    activate_function _activate;
+    std::array<draw_data_copy, 2> _buffers {};
+    std::size_t _front { 0 };
+    std::mutex _mutex {};
+    std::condition_variable _changed {};
+    bool _pending { false };
+    bool _busy { false };
+    bool _textures_changed { false };
+    bool _stopping { false };
+    std::size_t _drawn_pixels { 0 };
+    std::exception_ptr _error {};
+    std::thread _thread;
+
+    void run();
+    // Waits until the render thread is idle, the lock must be held
+    void wait_until_idle(std::unique_lock<std::mutex>& lock);
+};
+
+}
+
+#endif
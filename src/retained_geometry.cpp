@@ -0,0 +1,94 @@
+#include "common.hpp"
+#include "retained_geometry.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+void uxx::detail::retained_geometry::assign(const ImDrawList& draw_list)
+{
+    clear();
+    _vertices.assign(draw_list.VtxBuffer.begin(), draw_list.VtxBuffer.end());
+    _indices.assign(draw_list.IdxBuffer.begin(), draw_list.IdxBuffer.end());
+    _white_pixel = ImGui::GetFontTexUvWhitePixel();
+
+    for (const auto& command : draw_list.CmdBuffer) {
+        if (command.ElemCount == 0 || nullptr != command.UserCallback) {
+            continue;
+        }
+        // Commands that share a vertex offset are consecutive and so are their indices
+        if (_chunks.empty() || _chunks.back().first_vertex != command.VtxOffset) {
+            _chunks.push_back({ command.VtxOffset, 0, command.IdxOffset, 0, {} });
+        }
+        _chunks.back().index_count += command.ElemCount;
+    }
+    for (std::size_t i = 0; i < _chunks.size(); ++i) {
+        auto& c = _chunks[i];
+        const auto end = i + 1 < _chunks.size() ? _chunks[i + 1].first_vertex : _vertices.size();
+        c.vertex_count = end - c.first_vertex;
+        constexpr auto limit = std::numeric_limits<float>::max();
+        c.area = { ImVec2 { limit, limit }, ImVec2 { -limit, -limit } };
+
+        for (std::size_t v = c.first_vertex; v < end; ++v) {
+            const auto& p = _vertices[v].pos;
+            c.area.min = ImVec2 { std::min(c.area.min.x, p.x), std::min(c.area.min.y, p.y) };
+            c.area.max = ImVec2 { std::max(c.area.max.x, p.x), std::max(c.area.max.y, p.y) };
+        }
+    }
+}
+
+void uxx::detail::retained_geometry::clear() noexcept
+{
+    _vertices.clear();
+    _indices.clear();
+    _chunks.clear();
+}
+
+bool uxx::detail::retained_geometry::is_empty() const noexcept
+{
+    return _chunks.empty();
+}
+
+std::size_t uxx::detail::retained_geometry::get_vertex_count() const noexcept
+{
+    return _vertices.size();
+}
+
+std::size_t uxx::detail::retained_geometry::append_to(ImDrawList& draw_list, const ImVec2& translation, const float scale) const
+{
+    const auto white_pixel = ImGui::GetFontTexUvWhitePixel();
+    // A rebuilt font atlas may have moved the white pixel
+    const bool moved = white_pixel.x != _white_pixel.x || white_pixel.y != _white_pixel.y;
+    const bool transformed = scale != 1.0f || translation.x != 0.0f || translation.y != 0.0f;
+
+    const auto transform = [&](const ImVec2& p) { return ImVec2 { p.x * scale + translation.x, p.y * scale + translation.y }; };
+    std::size_t culled = 0;
+
+    for (const auto& c : _chunks) {
+        if (is_clipped(draw_list, get_bounds(transform(c.area.min), transform(c.area.max)), 0.0f)) {
+            ++culled;
+            continue;
+        }
+        draw_list.PrimReserve(static_cast<int>(c.index_count), static_cast<int>(c.vertex_count));
+        const std::size_t first = draw_list._VtxCurrentIdx;
+        const auto vertices = _vertices.cbegin() + static_cast<std::ptrdiff_t>(c.first_vertex);
+        const auto indices = _indices.cbegin() + static_cast<std::ptrdiff_t>(c.first_index);
+        auto* const written = draw_list._VtxWritePtr;
+        draw_list._VtxWritePtr = std::copy(vertices, vertices + static_cast<std::ptrdiff_t>(c.vertex_count), written);
+
+        if (transformed || moved) {
+            for (auto* vertex = written; vertex != draw_list._VtxWritePtr; ++vertex) {
+                vertex->pos = transform(vertex->pos);
+
+                if (moved && vertex->uv.x == _white_pixel.x && vertex->uv.y == _white_pixel.y) {
+                    vertex->uv = white_pixel;
+                }
+            }
+        }
+        for (auto index = indices; index != indices + static_cast<std::ptrdiff_t>(c.index_count); ++index) {
+            *draw_list._IdxWritePtr++ = static_cast<ImDrawIdx>(first + *index);
+        }
+        draw_list._VtxCurrentIdx += static_cast<unsigned int>(c.vertex_count);
+    }
+    return culled;
+}
@@ -0,0 +1,47 @@
+#ifndef _UXX_RETAINED_GEOMETRY_HPP
+#define _UXX_RETAINED_GEOMETRY_HPP
+
+#include "common.hpp"
+#include "clip_culling.hpp"
+
+#include <vector>
+
+namespace uxx::detail {
+
+/// Vertices and indices taken from a draw list once, and appended to other draw lists as often as needed
+/// without tessellating the shapes again, see uxx::drawing.
+class retained_geometry {
+public:
+    /// Keep the geometry of a draw list that was drawn into. Clip rectangles and textures aren't kept,
+    /// the geometry takes on those of the draw list it is appended to.
+    void assign(const ImDrawList& draw_list);
+    void clear() noexcept;
+    [[nodiscard]] bool is_empty() const noexcept;
+    [[nodiscard]] std::size_t get_vertex_count() const noexcept;
+
+    /// Append the geometry, every position scaled and then translated.
+    /// Vertices that refer to the white pixel of the font atlas are moved to where it is now.
+    /// Chunks that end up outside the clip rectangle of the draw list are left out.
+    /// \return The number of chunks left out.
+    std::size_t append_to(ImDrawList& draw_list, const ImVec2& translation, float scale) const;
+
+private:
+    // Vertices whose indices count from the first one, like the vertex offsets of a draw list with 16-bit indices
+    struct chunk {
+        std::size_t first_vertex;
+        std::size_t vertex_count;
+        std::size_t first_index;
+        std::size_t index_count;
+        // Bounds of the vertices, fringes included
+        bounds area;
+    };
+
+    std::vector<ImDrawVert> _vertices {};
+    std::vector<ImDrawIdx> _indices {};
+    std::vector<chunk> _chunks {};
+    ImVec2 _white_pixel {};
+};
+
+}
+
+#endif
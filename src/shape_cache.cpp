@@ -0,0 +1,117 @@
+#include "common.hpp"
+#include "shape_cache.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <utility>
+
+namespace {
+
+[[nodiscard]] std::size_t calculate_circle_segments(const float radius, const float max_error) noexcept
+{
+    // Same as IM_DRAWLIST_CIRCLE_AUTO_SEGMENT_CALC
+    const auto segments = 2.0f * std::numbers::pi_v<float> / std::acos((radius - max_error) / radius);
+
+    if (!(segments < static_cast<float>(uxx::detail::shape_cache::MAX_CIRCLE_SEGMENTS))) {
+        return uxx::detail::shape_cache::MAX_CIRCLE_SEGMENTS;
+    }
+    return std::max(static_cast<std::size_t>(segments), uxx::detail::shape_cache::MIN_CIRCLE_SEGMENTS);
+}
+
+[[nodiscard]] ImVec2 edge_normal(const ImVec2& from, const ImVec2& to) noexcept
+{
+    const float dx = to.x - from.x;
+    const float dy = to.y - from.y;
+    const float length = std::sqrt(dx * dx + dy * dy);
+    return length > 0.0f ? ImVec2 { dy / length, -dx / length } : ImVec2 { 0.0f, 0.0f };
+}
+
+}
+
+const uxx::detail::shape_cache::polygon& uxx::detail::shape_cache::get_polygon(const std::size_t corners)
+{
+    const auto found = _polygons.find(corners);
+
+    if (found != _polygons.end()) {
+        return found->second;
+    }
+    polygon p {};
+    p.corners.resize(corners);
+    p.edge_normals.resize(corners);
+    p.corner_normals.resize(corners);
+
+    for (std::size_t i = 0; i < corners; ++i) {
+        const auto a = 2.0f * std::numbers::pi_v<float> * static_cast<float>(i) / static_cast<float>(corners);
+        p.corners[i] = ImVec2 { std::cos(a), std::sin(a) };
+    }
+    for (std::size_t i = 0; i < corners; ++i) {
+        p.edge_normals[i] = edge_normal(p.corners[i], p.corners[(i + 1) % corners]);
+    }
+    for (std::size_t i = 0; i < corners; ++i) {
+        // Like IM_FIXNORMAL2F on the average of the normals of the edges that meet at the corner
+        const auto& before = p.edge_normals[(i + corners - 1) % corners];
+        const auto& after = p.edge_normals[i];
+        ImVec2 n { (before.x + after.x) * 0.5f, (before.y + after.y) * 0.5f };
+        const float inv_lensq = 1.0f / std::max(n.x * n.x + n.y * n.y, 0.5f);
+        p.corner_normals[i] = ImVec2 { n.x * inv_lensq, n.y * inv_lensq };
+    }
+    return _polygons.emplace(corners, std::move(p)).first->second;
+}
+
+std::size_t uxx::detail::shape_cache::get_circle_segments(const float radius, const float max_error)
+{
+    const auto whole_radius = std::max(std::floor(radius), 1.0f);
+
+    if (whole_radius >= static_cast<float>(CACHED_RADII)) {
+        return calculate_circle_segments(whole_radius, max_error);
+    }
+    if (max_error != _max_error) {
+        // A change of style invalidates every count
+        _circle_segments.assign(CACHED_RADII, 0);
+        _max_error = max_error;
+    }
+    auto& segments = _circle_segments[static_cast<std::size_t>(whole_radius)];
+
+    if (segments == 0) {
+        segments = calculate_circle_segments(whole_radius, max_error);
+    }
+    return segments;
+}
+
+std::span<const uxx::detail::shape_cache::bezier_weights> uxx::detail::shape_cache::get_bezier_weights(const std::size_t segments)
+{
+    auto& weights = _bezier_weights[segments];
+
+    if (weights.empty()) {
+        weights.resize(segments);
+
+        for (std::size_t i = 0; i < segments; ++i) {
+            // Same as ImBezierCalc()
+            const auto t = static_cast<float>(i + 1) / static_cast<float>(segments);
+            const auto u = 1.0f - t;
+            weights[i] = { u * u * u, 3.0f * u * u * t, 3.0f * u * t * t, t * t * t };
+        }
+    }
+    return weights;
+}
+
+std::size_t uxx::detail::shape_cache::get_bezier_segments(const ImVec2& p1, const ImVec2& p2, const ImVec2& p3, const ImVec2& p4, const float tolerance) noexcept
+{
+    // The second derivative of the curve is at most 6 times the larger of these, and a segment of length 1/n
+    // strays at most a eighth of the second derivative divided by n squared from the curve
+    const auto d1 = std::hypot(p1.x - 2.0f * p2.x + p3.x, p1.y - 2.0f * p2.y + p3.y);
+    const auto d2 = std::hypot(p2.x - 2.0f * p3.x + p4.x, p2.y - 2.0f * p3.y + p4.y);
+    const auto segments = std::ceil(std::sqrt(6.0f * std::max(d1, d2) / (8.0f * std::max(tolerance, 0.01f))));
+
+    if (!(segments < static_cast<float>(MAX_BEZIER_SEGMENTS))) {
+        return MAX_BEZIER_SEGMENTS;
+    }
+    return std::max(static_cast<std::size_t>(segments), std::size_t { 1 });
+}
+
+uxx::detail::shape_cache& uxx::detail::get_shape_cache() noexcept
+{
+    thread_local shape_cache cache {};
+    return cache;
+}
@@ -0,0 +1,61 @@
+#ifndef _UXX_SHAPE_CACHE_HPP
+#define _UXX_SHAPE_CACHE_HPP
+
+#include "common.hpp"
+
+#include <array>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace uxx::detail {
+
+/// Geometry of unit shapes that circles, n-gons and bezier curves of any size and position are drawn from,
+/// computed once per segment count instead of on every call.
+class shape_cache {
+public:
+    /// Fewest and most segments of a circle, like ImGui's automatic and clamped segment counts.
+    static constexpr std::size_t MIN_CIRCLE_SEGMENTS { 12 };
+    static constexpr std::size_t MAX_CIRCLE_SEGMENTS { 512 };
+    /// Most segments of a bezier curve with an automatic segment count.
+    static constexpr std::size_t MAX_BEZIER_SEGMENTS { 256 };
+
+    /// Regular polygon with its corners on the unit circle, the first one at angle 0.
+    /// The normals are independent of the size of the polygon, so they are shared by all polygons with as many corners.
+    struct polygon {
+        std::vector<ImVec2> corners;
+        /// Unit normal of the edge from corner i to corner i + 1.
+        std::vector<ImVec2> edge_normals;
+        /// Miter normal at corner i, scaled so that an offset of one along it is one pixel away from both edges.
+        std::vector<ImVec2> corner_normals;
+    };
+
+    /// Weights of the four control points of a cubic bezier curve at the end of each segment.
+    using bezier_weights = std::array<float, 4>;
+
+    /// \return The polygon with the given number of corners, at least three.
+    [[nodiscard]] const polygon& get_polygon(std::size_t corners);
+    /// Segments of a circle that keep its polygon within max_error pixels of it, cached per whole radius.
+    [[nodiscard]] std::size_t get_circle_segments(float radius, float max_error);
+    /// \return The weights of the end points of the segments, without the start of the curve.
+    [[nodiscard]] std::span<const bezier_weights> get_bezier_weights(std::size_t segments);
+
+    /// Segments of a cubic bezier curve that keep it within tolerance pixels of its polyline.
+    [[nodiscard]] static std::size_t get_bezier_segments(const ImVec2& p1, const ImVec2& p2, const ImVec2& p3, const ImVec2& p4, float tolerance) noexcept;
+
+private:
+    // Radii up to this many pixels have their circle segment count cached
+    static constexpr std::size_t CACHED_RADII { 1024 };
+
+    std::unordered_map<std::size_t, polygon> _polygons {};
+    std::unordered_map<std::size_t, std::vector<bezier_weights>> _bezier_weights {};
+    std::vector<std::size_t> _circle_segments {};
+    float _max_error { 0.0f };
+};
+
+/// \return The shape cache of the calling thread.
+[[nodiscard]] shape_cache& get_shape_cache() noexcept;
+
+}
+
+#endif
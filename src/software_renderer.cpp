@@ -0,0 +1,610 @@
+#include "common.hpp"
+#include "software_renderer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define UXX_SOFTWARE_RENDERER_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+constexpr std::size_t LANES { 4 };
+
+// Four floats that are processed together, with SSE2 where it is available
+class float4 {
+public:
+#if defined(UXX_SOFTWARE_RENDERER_SSE2)
+    explicit float4(const float value) noexcept
+        : _v(_mm_set1_ps(value))
+    {
+    }
+
+    /// \return start, start + 1, start + 2, start + 3
+    [[nodiscard]] static float4 ramp(const float start) noexcept
+    {
+        return float4 { _mm_add_ps(_mm_set1_ps(start), _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f)) };
+    }
+
+    friend float4 operator+(const float4 a, const float4 b) noexcept
+    {
+        return float4 { _mm_add_ps(a._v, b._v) };
+    }
+
+    friend float4 operator-(const float4 a, const float4 b) noexcept
+    {
+        return float4 { _mm_sub_ps(a._v, b._v) };
+    }
+
+    friend float4 operator*(const float4 a, const float4 b) noexcept
+    {
+        return float4 { _mm_mul_ps(a._v, b._v) };
+    }
+
+    /// \return Bit i is set if lane i of a is greater than lane i of b.
+    friend unsigned int greater_mask(const float4 a, const float4 b) noexcept
+    {
+        return static_cast<unsigned int>(_mm_movemask_ps(_mm_cmpgt_ps(a._v, b._v)));
+    }
+
+    /// \return Bit i is set if lane i of a equals lane i of b.
+    friend unsigned int equal_mask(const float4 a, const float4 b) noexcept
+    {
+        return static_cast<unsigned int>(_mm_movemask_ps(_mm_cmpeq_ps(a._v, b._v)));
+    }
+
+    [[nodiscard]] std::array<float, LANES> to_array() const noexcept
+    {
+        std::array<float, LANES> lanes {};
+        _mm_storeu_ps(lanes.data(), _v);
+        return lanes;
+    }
+
+private:
+    __m128 _v;
+
+    explicit float4(const __m128 v) noexcept
+        : _v(v)
+    {
+    }
+#else
+    explicit float4(const float value) noexcept
+    {
+        _v.fill(value);
+    }
+
+    [[nodiscard]] static float4 ramp(const float start) noexcept
+    {
+        return float4 { { start, start + 1.0f, start + 2.0f, start + 3.0f } };
+    }
+
+    friend float4 operator+(const float4 a, const float4 b) noexcept
+    {
+        return apply(a, b, [](const float x, const float y) { return x + y; });
+    }
+
+    friend float4 operator-(const float4 a, const float4 b) noexcept
+    {
+        return apply(a, b, [](const float x, const float y) { return x - y; });
+    }
+
+    friend float4 operator*(const float4 a, const float4 b) noexcept
+    {
+        return apply(a, b, [](const float x, const float y) { return x * y; });
+    }
+
+    friend unsigned int greater_mask(const float4 a, const float4 b) noexcept
+    {
+        return mask(a, b, [](const float x, const float y) { return x > y; });
+    }
+
+    friend unsigned int equal_mask(const float4 a, const float4 b) noexcept
+    {
+        return mask(a, b, [](const float x, const float y) { return x == y; });
+    }
+
+    [[nodiscard]] std::array<float, LANES> to_array() const noexcept
+    {
+        return _v;
+    }
+
+private:
+    std::array<float, LANES> _v {};
+
+    explicit float4(const std::array<float, LANES>& v) noexcept
+        : _v(v)
+    {
+    }
+
+    template <typename F>
+    [[nodiscard]] static float4 apply(const float4 a, const float4 b, F f) noexcept
+    {
+        std::array<float, LANES> result {};
+        for (std::size_t i = 0; i < LANES; ++i) {
+            result[i] = f(a._v[i], b._v[i]);
+        }
+        return float4 { result };
+    }
+
+    template <typename F>
+    [[nodiscard]] static unsigned int mask(const float4 a, const float4 b, F f) noexcept
+    {
+        unsigned int bits = 0;
+        for (std::size_t i = 0; i < LANES; ++i) {
+            bits |= f(a._v[i], b._v[i]) ? 1U << i : 0U;
+        }
+        return bits;
+    }
+#endif
+};
+
+struct texture {
+    int width;
+    int height;
+    std::vector<std::uint8_t> pixels;
+};
+
+// Integer pixel bounds, the maximum is exclusive
+struct pixel_rect {
+    int x0;
+    int y0;
+    int x1;
+    int y1;
+
+    [[nodiscard]] bool is_empty() const noexcept
+    {
+        return x0 >= x1 || y0 >= y1;
+    }
+
+    [[nodiscard]] pixel_rect intersect(const pixel_rect& other) const noexcept
+    {
+        return { std::max(x0, other.x0), std::max(y0, other.y0), std::min(x1, other.x1), std::min(y1, other.y1) };
+    }
+};
+
+// Edge function of a triangle edge. Both triangles that share an edge evaluate it from the same end point and
+// negate the result as needed, so their values are exact opposites and every pixel center on the edge is
+// filled by exactly one of them.
+struct edge {
+    ImVec2 origin;
+    ImVec2 direction;
+    // Makes the value positive inside of the triangle
+    float factor;
+    // Whether pixel centers exactly on the edge belong to the triangle
+    bool inclusive;
+
+    [[nodiscard]] static edge create(const ImVec2 a, const ImVec2 b, const float orientation) noexcept
+    {
+        const bool swapped = a.x > b.x || (a.x == b.x && a.y > b.y);
+        const auto origin = swapped ? b : a;
+        const auto end = swapped ? a : b;
+        const float factor = swapped ? -orientation : orientation;
+        return { origin, ImVec2 { end.x - origin.x, end.y - origin.y }, factor, factor > 0.0f };
+    }
+
+    /// \param x Pixel centers of a row of pixels.
+    /// \return Twice the area of the triangles of the edge and the pixel centers, positive on the inside.
+    [[nodiscard]] float4 evaluate(const float4 x, const float y) const noexcept
+    {
+        const float row = (y - origin.y) * direction.x;
+        return float4 { factor } * (float4 { row } - (x - float4 { origin.x }) * float4 { direction.y });
+    }
+
+    /// \return Bit i is set if the pixel center of lane i is inside of the edge.
+    [[nodiscard]] static unsigned int inside_mask(const edge& e, const float4 value) noexcept
+    {
+        const float4 zero { 0.0f };
+        return greater_mask(value, zero) | (e.inclusive ? equal_mask(value, zero) : 0U);
+    }
+};
+
+enum attribute : std::size_t { RED, GREEN, BLUE, ALPHA, U, V, ATTRIBUTE_COUNT };
+
+// Triangle prepared for rasterization, in framebuffer coordinates
+struct triangle_setup {
+    // Edge i is opposite to vertex (i + 2) % 3
+    std::array<edge, 3> edges;
+    // Per vertex, colors from 0 to 255
+    std::array<std::array<float, ATTRIBUTE_COUNT>, 3> attributes;
+    float inverse_area;
+    // Pixels the triangle may cover, limited to its clip rectangle and the image
+    pixel_rect bounds;
+    // Nullptr samples white
+    const texture* tex;
+    // All vertices have the same color and texture coordinates, as in most filled shapes
+    bool flat;
+};
+
+[[nodiscard]] std::uint8_t to_byte(const float value) noexcept
+{
+    return static_cast<std::uint8_t>(std::clamp(value + 0.5f, 0.0f, 255.0f));
+}
+
+constexpr float INV_255 { 1.0f / 255.0f };
+
+// Nearest texel, clamped to the edges like SFML's unrepeated textures
+[[nodiscard]] const std::uint8_t* sample(const texture& tex, const float u, const float v) noexcept
+{
+    const auto x = std::clamp(static_cast<int>(std::floor(u * static_cast<float>(tex.width))), 0, tex.width - 1);
+    const auto y = std::clamp(static_cast<int>(std::floor(v * static_cast<float>(tex.height))), 0, tex.height - 1);
+    return &tex.pixels[(static_cast<std::size_t>(y) * static_cast<std::size_t>(tex.width) + static_cast<std::size_t>(x)) * 4];
+}
+
+// Source alpha blending, with the alpha channel accumulated like glBlendFuncSeparate(..., GL_ONE, GL_ONE_MINUS_SRC_ALPHA)
+void shade(std::uint8_t* pixel, const std::array<float, ATTRIBUTE_COUNT>& color, const std::uint8_t* texel) noexcept
+{
+    const float alpha = color[ALPHA] * static_cast<float>(texel[3]) * INV_255 * INV_255;
+
+    if (alpha <= 0.0f) {
+        return;
+    }
+    for (std::size_t c = RED; c <= BLUE; ++c) {
+        const float source = color[c] * static_cast<float>(texel[c]) * INV_255;
+        pixel[c] = to_byte(source * alpha + static_cast<float>(pixel[c]) * (1.0f - alpha));
+    }
+    pixel[3] = to_byte(alpha * 255.0f + static_cast<float>(pixel[3]) * (1.0f - alpha));
+}
+
+// Runs a job on several threads at once, the threads stay alive between jobs
+class worker_pool {
+public:
+    explicit worker_pool(const unsigned int thread_count)
+    {
+        for (unsigned int i = 1; i < thread_count; ++i) {
+            _threads.emplace_back([this]() { work(); });
+        }
+    }
+
+    ~worker_pool() noexcept
+    {
+        {
+            std::scoped_lock lock { _mutex };
+            _stopping = true;
+        }
+        _start.notify_all();
+
+        for (auto& thread : _threads) {
+            thread.join();
+        }
+    }
+
+    worker_pool(const worker_pool&) = delete;
+    worker_pool(worker_pool&&) = delete;
+    worker_pool& operator=(const worker_pool&) = delete;
+    worker_pool& operator=(worker_pool&&) = delete;
+
+    /// Run the job on every thread of the pool and on the calling thread, and wait until all of them return.
+    void run(const std::function<void()>& job)
+    {
+        {
+            std::scoped_lock lock { _mutex };
+            _job = &job;
+            _running = _threads.size();
+            ++_generation;
+        }
+        _start.notify_all();
+        job();
+
+        std::unique_lock lock { _mutex };
+        _done.wait(lock, [this]() { return _running == 0; });
+        _job = nullptr;
+    }
+
+private:
+    std::vector<std::thread> _threads {};
+    std::mutex _mutex {};
+    std::condition_variable _start {};
+    std::condition_variable _done {};
+    const std::function<void()>* _job { nullptr };
+    std::uint64_t _generation { 0 };
+    std::size_t _running { 0 };
+    bool _stopping { false };
+
+    void work()
+    {
+        std::uint64_t generation = 0;
+
+        for (;;) {
+            const std::function<void()>* job = nullptr;
+            {
+                std::unique_lock lock { _mutex };
+                _start.wait(lock, [&]() { return _stopping || _generation != generation; });
+
+                if (_stopping) {
+                    return;
+                }
+                generation = _generation;
+                job = _job;
+            }
+            (*job)();
+            {
+                std::scoped_lock lock { _mutex };
+                --_running;
+            }
+            _done.notify_one();
+        }
+    }
+};
+
+}
+
+struct uxx::detail::software_renderer::state {
+    explicit state(const unsigned int thread_count)
+        : workers(thread_count)
+    {
+    }
+
+    int width { 0 };
+    int height { 0 };
+    std::vector<std::uint8_t> pixels {};
+    std::unordered_map<ImTextureID, texture> textures {};
+    std::vector<triangle_setup> triangles {};
+    // Indices of the triangles that overlap each tile, in draw order
+    std::vector<std::vector<std::uint32_t>> bins {};
+    int tiles_x { 0 };
+    std::atomic<std::size_t> next_tile { 0 };
+    worker_pool workers;
+
+    void set_up_triangles(const ImDrawData& draw_data);
+    void bin_triangles();
+    void rasterize_tile(std::size_t tile);
+    void rasterize(const triangle_setup& t, const pixel_rect& area);
+};
+
+void uxx::detail::software_renderer::state::set_up_triangles(const ImDrawData& draw_data)
+{
+    const auto origin = draw_data.DisplayPos;
+    const auto scale = draw_data.FramebufferScale;
+    const pixel_rect image { 0, 0, width, height };
+    triangles.clear();
+
+    for (int n = 0; n < draw_data.CmdListsCount; ++n) {
+        const auto& list = *draw_data.CmdLists[n];
+
+        for (const auto& command : list.CmdBuffer) {
+            if (nullptr != command.UserCallback) {
+                // Callbacks draw with OpenGL, there is nothing they could draw into
+                continue;
+            }
+            // Truncated like the scissor rectangles of the OpenGL renderers
+            const auto clip_x = static_cast<int>((command.ClipRect.x - origin.x) * scale.x);
+            const auto clip_y = static_cast<int>((command.ClipRect.y - origin.y) * scale.y);
+            const pixel_rect clip {
+                clip_x,
+                clip_y,
+                clip_x + static_cast<int>((command.ClipRect.z - command.ClipRect.x) * scale.x),
+                clip_y + static_cast<int>((command.ClipRect.w - command.ClipRect.y) * scale.y)
+            };
+            const auto scissor = clip.intersect(image);
+
+            if (scissor.is_empty()) {
+                continue;
+            }
+            const auto found = textures.find(command.TextureId);
+            const texture* tex = found != textures.end() ? &found->second : nullptr;
+
+            for (unsigned int i = 0; i + 2 < command.ElemCount; i += 3) {
+                std::array<ImVec2, 3> p {};
+                triangle_setup t {};
+
+                for (std::size_t k = 0; k < p.size(); ++k) {
+                    const auto index = command.VtxOffset + list.IdxBuffer[static_cast<int>(command.IdxOffset + i + k)];
+                    const auto& vertex = list.VtxBuffer[static_cast<int>(index)];
+                    p[k] = ImVec2 { (vertex.pos.x - origin.x) * scale.x, (vertex.pos.y - origin.y) * scale.y };
+                    t.attributes[k] = {
+                        static_cast<float>((vertex.col >> IM_COL32_R_SHIFT) & 0xFF),
+                        static_cast<float>((vertex.col >> IM_COL32_G_SHIFT) & 0xFF),
+                        static_cast<float>((vertex.col >> IM_COL32_B_SHIFT) & 0xFF),
+                        static_cast<float>((vertex.col >> IM_COL32_A_SHIFT) & 0xFF),
+                        vertex.uv.x,
+                        vertex.uv.y
+                    };
+                }
+                const float area = (p[2].y - p[0].y) * (p[1].x - p[0].x) - (p[2].x - p[0].x) * (p[1].y - p[0].y);
+
+                if (area == 0.0f || !std::isfinite(area)) {
+                    continue;
+                }
+                const float orientation = area > 0.0f ? 1.0f : -1.0f;
+                t.edges = { edge::create(p[0], p[1], orientation), edge::create(p[1], p[2], orientation), edge::create(p[2], p[0], orientation) };
+                t.inverse_area = 1.0f / std::abs(area);
+                t.tex = tex;
+                t.flat = t.attributes[0] == t.attributes[1] && t.attributes[0] == t.attributes[2];
+
+                const auto [min_x, max_x] = std::minmax({ p[0].x, p[1].x, p[2].x });
+                const auto [min_y, max_y] = std::minmax({ p[0].y, p[1].y, p[2].y });
+                // Large enough to hold any image, small enough to convert to int
+                constexpr float LIMIT { 16777216.0f };
+                const pixel_rect bounds {
+                    static_cast<int>(std::floor(std::clamp(min_x, -LIMIT, LIMIT))),
+                    static_cast<int>(std::floor(std::clamp(min_y, -LIMIT, LIMIT))),
+                    static_cast<int>(std::ceil(std::clamp(max_x, -LIMIT, LIMIT))),
+                    static_cast<int>(std::ceil(std::clamp(max_y, -LIMIT, LIMIT)))
+                };
+                t.bounds = bounds.intersect(scissor);
+
+                if (!t.bounds.is_empty()) {
+                    triangles.push_back(t);
+                }
+            }
+        }
+    }
+}
+
+void uxx::detail::software_renderer::state::bin_triangles()
+{
+    tiles_x = (width + TILE_SIZE - 1) / TILE_SIZE;
+    const int tiles_y = (height + TILE_SIZE - 1) / TILE_SIZE;
+    bins.resize(static_cast<std::size_t>(tiles_x * tiles_y));
+
+    for (auto& bin : bins) {
+        bin.clear();
+    }
+    for (std::size_t i = 0; i < triangles.size(); ++i) {
+        const auto& bounds = triangles[i].bounds;
+
+        for (int ty = bounds.y0 / TILE_SIZE; ty <= (bounds.y1 - 1) / TILE_SIZE; ++ty) {
+            for (int tx = bounds.x0 / TILE_SIZE; tx <= (bounds.x1 - 1) / TILE_SIZE; ++tx) {
+                bins[static_cast<std::size_t>(ty * tiles_x + tx)].push_back(static_cast<std::uint32_t>(i));
+            }
+        }
+    }
+}
+
+void uxx::detail::software_renderer::state::rasterize_tile(const std::size_t tile)
+{
+    const auto tx = static_cast<int>(tile) % tiles_x;
+    const auto ty = static_cast<int>(tile) / tiles_x;
+    const pixel_rect area { tx * TILE_SIZE, ty * TILE_SIZE, std::min((tx + 1) * TILE_SIZE, width), std::min((ty + 1) * TILE_SIZE, height) };
+
+    for (int y = area.y0; y < area.y1; ++y) {
+        auto* row = &pixels[(static_cast<std::size_t>(y) * static_cast<std::size_t>(width) + static_cast<std::size_t>(area.x0)) * 4];
+
+        for (int x = area.x0; x < area.x1; ++x, row += 4) {
+            row[0] = 0;
+            row[1] = 0;
+            row[2] = 0;
+            row[3] = 255;
+        }
+    }
+    for (const auto index : bins[tile]) {
+        rasterize(triangles[index], area.intersect(triangles[index].bounds));
+    }
+}
+
+void uxx::detail::software_renderer::state::rasterize(const triangle_setup& t, const pixel_rect& area)
+{
+    static constexpr std::array<std::uint8_t, 4> WHITE { 255, 255, 255, 255 };
+    const float4 inverse_area { t.inverse_area };
+    const auto& flat_color = t.attributes[0];
+    const auto* flat_texel = nullptr != t.tex ? sample(*t.tex, flat_color[U], flat_color[V]) : WHITE.data();
+    // Flat triangles blend the same premultiplied color into every pixel, opaque ones simply overwrite them
+    const float flat_alpha = flat_color[ALPHA] * static_cast<float>(flat_texel[3]) * INV_255 * INV_255;
+    const bool opaque = t.flat && flat_alpha >= 1.0f;
+    const std::array<float, 4> premultiplied {
+        flat_color[RED] * static_cast<float>(flat_texel[0]) * INV_255 * flat_alpha,
+        flat_color[GREEN] * static_cast<float>(flat_texel[1]) * INV_255 * flat_alpha,
+        flat_color[BLUE] * static_cast<float>(flat_texel[2]) * INV_255 * flat_alpha,
+        flat_alpha * 255.0f
+    };
+    const std::array<std::uint8_t, 4> flat_pixel { to_byte(premultiplied[0]), to_byte(premultiplied[1]), to_byte(premultiplied[2]), to_byte(premultiplied[3]) };
+    const unsigned int inverse_alpha { 255U - flat_pixel[3] };
+
+    for (int y = area.y0; y < area.y1; ++y) {
+        const float center_y = static_cast<float>(y) + 0.5f;
+        auto* row = &pixels[static_cast<std::size_t>(y) * static_cast<std::size_t>(width) * 4];
+
+        for (int x = area.x0; x < area.x1; x += static_cast<int>(LANES)) {
+            const auto center_x = float4::ramp(static_cast<float>(x) + 0.5f);
+            const auto e0 = t.edges[0].evaluate(center_x, center_y);
+            const auto e1 = t.edges[1].evaluate(center_x, center_y);
+            const auto e2 = t.edges[2].evaluate(center_x, center_y);
+            const auto remaining = static_cast<unsigned int>(area.x1 - x);
+            const unsigned int in_area = remaining >= LANES ? 0xFU : (1U << remaining) - 1U;
+            const auto covered = in_area & edge::inside_mask(t.edges[0], e0) & edge::inside_mask(t.edges[1], e1) & edge::inside_mask(t.edges[2], e2);
+
+            if (covered == 0) {
+                continue;
+            }
+            if (t.flat) {
+                for (std::size_t lane = 0; lane < LANES; ++lane) {
+                    if ((covered & (1U << lane)) == 0) {
+                        continue;
+                    }
+                    auto* pixel = &row[(static_cast<std::size_t>(x) + lane) * 4];
+
+                    if (opaque) {
+                        std::copy(flat_pixel.begin(), flat_pixel.end(), pixel);
+                    } else if (flat_alpha > 0.0f) {
+                        for (std::size_t c = 0; c < flat_pixel.size(); ++c) {
+                            pixel[c] = static_cast<std::uint8_t>(flat_pixel[c] + (pixel[c] * inverse_alpha + 127U) / 255U);
+                        }
+                    }
+                }
+                continue;
+            }
+            // Barycentric weights of the vertices, each one is the edge function of the opposite edge
+            const auto w0 = e1 * inverse_area;
+            const auto w1 = e2 * inverse_area;
+            const auto w2 = e0 * inverse_area;
+            std::array<std::array<float, LANES>, ATTRIBUTE_COUNT> values {};
+
+            for (std::size_t a = 0; a < ATTRIBUTE_COUNT; ++a) {
+                const auto value = w0 * float4 { t.attributes[0][a] } + w1 * float4 { t.attributes[1][a] } + w2 * float4 { t.attributes[2][a] };
+                values[a] = value.to_array();
+            }
+            for (std::size_t lane = 0; lane < LANES; ++lane) {
+                if ((covered & (1U << lane)) == 0) {
+                    continue;
+                }
+                std::array<float, ATTRIBUTE_COUNT> color {};
+
+                for (std::size_t a = 0; a < ATTRIBUTE_COUNT; ++a) {
+                    color[a] = values[a][lane];
+                }
+                const auto* texel = nullptr != t.tex ? sample(*t.tex, color[U], color[V]) : WHITE.data();
+                shade(&row[(static_cast<std::size_t>(x) + lane) * 4], color, texel);
+            }
+        }
+    }
+}
+
+uxx::detail::software_renderer::software_renderer(const unsigned int thread_count)
+    : _state { std::make_unique<state>(thread_count > 0 ? thread_count : std::max(1U, std::thread::hardware_concurrency())) }
+{
+}
+
+uxx::detail::software_renderer::~software_renderer() noexcept = default;
+
+void uxx::detail::software_renderer::set_texture(const ImTextureID id, const unsigned int width, const unsigned int height, const unsigned char* pixels)
+{
+    const auto size = std::size_t { width } * height * 4;
+    _state->textures[id] = texture { static_cast<int>(width), static_cast<int>(height), std::vector<std::uint8_t>(pixels, pixels + size) };
+}
+
+void uxx::detail::software_renderer::render(const ImDrawData& draw_data)
+{
+    auto& s = *_state;
+    s.width = std::max(0, static_cast<int>(draw_data.DisplaySize.x * draw_data.FramebufferScale.x));
+    s.height = std::max(0, static_cast<int>(draw_data.DisplaySize.y * draw_data.FramebufferScale.y));
+    s.pixels.resize(static_cast<std::size_t>(s.width) * static_cast<std::size_t>(s.height) * 4);
+
+    if (s.width == 0 || s.height == 0) {
+        return;
+    }
+    s.set_up_triangles(draw_data);
+    s.bin_triangles();
+    s.next_tile = 0;
+
+    // Tiles are handed out one by one, so that threads that got cheap tiles take over the remaining ones
+    s.workers.run([&s]() {
+        for (auto tile = s.next_tile++; tile < s.bins.size(); tile = s.next_tile++) {
+            s.rasterize_tile(tile);
+        }
+    });
+}
+
+unsigned int uxx::detail::software_renderer::get_width() const noexcept
+{
+    return static_cast<unsigned int>(_state->width);
+}
+
+unsigned int uxx::detail::software_renderer::get_height() const noexcept
+{
+    return static_cast<unsigned int>(_state->height);
+}
+
+std::span<const std::uint8_t> uxx::detail::software_renderer::get_pixels() const noexcept
+{
+    return _state->pixels;
+}
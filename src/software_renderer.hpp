@@ -0,0 +1,50 @@
+#ifndef _UXX_SOFTWARE_RENDERER_HPP
+#define _UXX_SOFTWARE_RENDERER_HPP
+
+#include "common.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <span>
+
+namespace uxx::detail {
+
+/// Rasterizes ImGui draw data into an RGBA image in memory, without OpenGL.
+/// Triangles are binned into tiles, and the tiles are rasterized in parallel with edge functions that are evaluated
+/// for several pixels at once. Shared edges are filled exactly once, so antialiased fringes blend like on the GPU.
+///
+/// Textures are sampled with nearest filtering, like the unsmoothed textures of imgui-SFML.
+class software_renderer {
+public:
+    static constexpr int TILE_SIZE { 64 };
+
+    /// \param thread_count Threads that rasterize tiles, including the calling one. Zero uses every hardware thread.
+    explicit software_renderer(unsigned int thread_count = 0);
+    ~software_renderer() noexcept;
+
+    software_renderer(const software_renderer&) = delete;
+    software_renderer(software_renderer&&) = delete;
+    software_renderer& operator=(const software_renderer&) = delete;
+    software_renderer& operator=(software_renderer&&) = delete;
+
+    /// Make the pixels of a texture available to the draw commands that use its id. The pixels are copied.
+    /// Commands with unknown textures are drawn as if the texture was white.
+    /// \param pixels RGBA pixels, row by row from the top.
+    void set_texture(ImTextureID id, unsigned int width, unsigned int height, const unsigned char* pixels);
+    /// Clear the image to opaque black and draw the data into it. The image takes the framebuffer size of the data.
+    void render(const ImDrawData& draw_data);
+
+    [[nodiscard]] unsigned int get_width() const noexcept;
+    [[nodiscard]] unsigned int get_height() const noexcept;
+    /// \return RGBA pixels of the image, row by row from the top.
+    [[nodiscard]] std::span<const std::uint8_t> get_pixels() const noexcept;
+
+private:
+    struct state;
+
+    std::unique_ptr<state> _state;
+};
+
+}
+
+#endif
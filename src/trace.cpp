@@ -0,0 +1,163 @@
+#include "common.hpp"
+#include "uxx/uxx.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using trace_clock = uxx::detail::trace_clock;
+
+struct trace_event {
+    std::string name;
+    trace_clock::time_point start;
+    trace_clock::duration duration;
+    std::uint32_t thread;
+};
+
+struct recorder {
+    std::mutex mutex {};
+    std::filesystem::path file {};
+    trace_clock::time_point origin {};
+    std::vector<trace_event> events {};
+};
+
+std::atomic<bool> enabled { false };
+std::atomic<std::uint32_t> next_thread_index { 0 };
+
+recorder& get_recorder()
+{
+    static recorder r {};
+    return r;
+}
+
+// Small stable thread numbers keep the trace viewer rows readable
+std::uint32_t get_thread_index() noexcept
+{
+    thread_local const std::uint32_t index = next_thread_index++;
+    return index;
+}
+
+void write_json_string(std::ostream& out, const std::string& str)
+{
+    out << '"';
+
+    for (const char c : str) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            std::array<char, 8> escaped {};
+            std::snprintf(escaped.data(), escaped.size(), "\\u%04x", static_cast<unsigned int>(c));
+            out << escaped.data();
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+double to_microseconds(const trace_clock::duration duration) noexcept
+{
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+void write_chrome_trace(const std::filesystem::path& file, const trace_clock::time_point origin, const std::vector<trace_event>& events)
+{
+    std::ofstream out { file, std::ios::trunc };
+
+    if (!out) {
+        throw std::runtime_error("Unable to open trace file: " + file.generic_string());
+    }
+    // Nanosecond resolution without an exponent, however long the trace ran
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    for (std::size_t i = 0; i < events.size(); ++i) {
+        const auto& e = events[i];
+        out << (i == 0 ? "\n" : ",\n") << "{\"name\":";
+        write_json_string(out, e.name);
+        out << ",\"cat\":\"uxx\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.thread
+            << ",\"ts\":" << to_microseconds(e.start - origin)
+            << ",\"dur\":" << to_microseconds(e.duration) << '}';
+    }
+    out << "\n]}\n";
+
+    if (!out) {
+        throw std::runtime_error("Unable to write trace file: " + file.generic_string());
+    }
+}
+
+}
+
+void uxx::detail::add_trace_event(const char* name, const trace_clock::time_point start, const trace_clock::time_point end) noexcept
+{
+    if (!enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    auto& r = get_recorder();
+
+    try {
+        std::scoped_lock lock { r.mutex };
+        // A scope that started before the trace has no place on its timeline
+        if (start >= r.origin) {
+            r.events.push_back({ name, start, end - start, get_thread_index() });
+        }
+    } catch (...) {
+        // Dropping an event is preferable to taking down the traced application
+    }
+}
+
+uxx::trace_scope::trace_scope(uxx::string_ref name) noexcept
+    : _name { name }
+    , _start { enabled.load(std::memory_order_relaxed) ? trace_clock::now().time_since_epoch().count() : -1 }
+{
+}
+
+uxx::trace_scope::~trace_scope() noexcept
+{
+    if (_start >= 0) {
+        const trace_clock::time_point start { trace_clock::duration { _start } };
+        detail::add_trace_event(_name.c_str(), start, trace_clock::now());
+    }
+}
+
+void uxx::trace_scope::start(const std::filesystem::path& file)
+{
+    auto& r = get_recorder();
+    std::scoped_lock lock { r.mutex };
+    r.file = file;
+    r.origin = trace_clock::now();
+    r.events.clear();
+    enabled = true;
+}
+
+void uxx::trace_scope::stop()
+{
+    auto& r = get_recorder();
+    std::filesystem::path file {};
+    std::vector<trace_event> events {};
+    trace_clock::time_point origin {};
+    {
+        std::scoped_lock lock { r.mutex };
+
+        if (!enabled.exchange(false)) {
+            return;
+        }
+        file = std::move(r.file);
+        origin = r.origin;
+        events.swap(r.events);
+    }
+    write_chrome_trace(file, origin, events);
+}
+
+bool uxx::trace_scope::is_enabled() noexcept
+{
+    return enabled.load(std::memory_order_relaxed);
+}
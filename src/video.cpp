@@ -8,6 +8,7 @@ typedef SSIZE_T ssize_t;
 #include <vlc/vlc.h>
 
 #include <array>
+#include <atomic>
 #include <memory>
 #include <span>
 
@@ -78,8 +79,10 @@ public:
 
     void set_output(unsigned char* output, const unsigned int width, const unsigned int height) noexcept
     {
+        _sink.frame = output;
+        _sink.updated = false;
         libvlc_video_set_callbacks(
-            _player.get(), lock, unlock, display, output);
+            _player.get(), lock, unlock, display, &_sink);
         libvlc_video_set_format(
             _player.get(), "RGBA", width, height, width * 4);
     }
@@ -104,6 +107,17 @@ public:
         return nullptr != _media;
     }
 
+    /// \return True once for every frame decoded since the previous call.
+    [[nodiscard]] bool take_frame() noexcept
+    {
+        return _sink.updated.exchange(false);
+    }
+
+    [[nodiscard]] bool is_playing() const noexcept
+    {
+        return 0 != libvlc_media_player_is_playing(_player.get());
+    }
+
     [[nodiscard]] std::pair<unsigned int, unsigned int> get_resolution() const
     {
         if (nullptr == _media) {
@@ -148,18 +162,20 @@ public:
     }
 
 private:
+    struct frame_sink {
+        unsigned char* frame { nullptr };
+        std::atomic<bool> updated { false };
+    };
+
+    // Declared first so that it outlives the player calling into it
+    frame_sink _sink {};
     instance_type _instance;
     player_type _player;
     media_type _media;
 
-    struct raw_data {
-        unsigned char* frame { nullptr };
-    };
-
     static void* lock(void* data, void** pixels)
     {
-        auto* raw_data = static_cast<struct raw_data*>(data);
-        *pixels = raw_data;
+        *pixels = static_cast<frame_sink*>(data)->frame;
         return nullptr;
     }
 
@@ -167,8 +183,9 @@ private:
     {
     }
 
-    static void display(void*, void*)
+    static void display(void* data, void*)
     {
+        static_cast<frame_sink*>(data)->updated = true;
     }
 };
 
@@ -244,8 +261,15 @@ std::optional<unsigned int> uxx::video::get_native_handle() const
 
 void uxx::video::render() const
 {
-    if (nullptr != _raw_image) {
+    // Upload each decoded frame once, however many windows or frames show it
+    if (nullptr != _raw_image && _driver->take_frame()) {
+        const trace_scope scope { "video upload" };
         _raw_image->texture.update(_raw_frame.data());
+        uxx::detail::count_texture_upload(_raw_frame.size());
+    }
+    if (_driver->is_playing()) {
+        // Keep on-demand applications rendering while the video is running
+        uxx::detail::request_animation_frame();
     }
 }
 
@@ -0,0 +1,104 @@
+#include "test.hpp"
+#include "common.hpp"
+#include "draw_list.hpp"
+#include "imgui_fixture.hpp"
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+/// \return The draw list that received the segments, with nothing else in it.
+[[nodiscard]] const ImDrawList& draw_lines(const std::vector<uxx::segment>& segments, const float thickness)
+{
+    auto& draw_list = *ImGui::GetForegroundDrawList();
+    uxx::detail::add_lines(draw_list, segments, IM_COL32_WHITE, thickness);
+    ImGui::Render();
+    return draw_list;
+}
+
+[[nodiscard]] std::vector<uxx::segment> create_segments(const std::size_t count)
+{
+    std::vector<uxx::segment> segments(count);
+
+    for (std::size_t i = 0; i < segments.size(); ++i) {
+        const auto x = static_cast<float>(i % 1900);
+        const auto y = static_cast<float>(i % 1000);
+        segments[i] = { { x, y }, { x + 10.0f * std::cos(x), y + 3.0f + 20.0f * std::sin(y) } };
+    }
+    return segments;
+}
+
+}
+
+TEST_CASE("Bulk primitives have the geometry of primitives drawn one by one", "[bulk_primitives]")
+{
+    const uxx::test::imgui_frame frame { ImGuiBackendFlags_None };
+    const auto flags = GENERATE(ImDrawListFlags_None, ImDrawListFlags_AntiAliasedLines | ImDrawListFlags_AntiAliasedFill);
+    const auto thickness = GENERATE(0.5f, 1.0f, 2.5f);
+    const auto segments = create_segments(100);
+    std::vector<uxx::rect> rects {};
+    std::vector<uxx::triangle> triangles {};
+
+    for (const auto& s : segments) {
+        rects.push_back({ s.from, s.to });
+        triangles.push_back({ s.from, s.to, { s.from.x - 5.0f, s.to.y + 7.0f } });
+    }
+    auto& one_by_one = *ImGui::GetBackgroundDrawList();
+    auto& bulk = *ImGui::GetForegroundDrawList();
+    one_by_one.Flags = flags;
+    bulk.Flags = flags;
+
+    for (const auto& s : segments) {
+        one_by_one.AddLine({ s.from.x, s.from.y }, { s.to.x, s.to.y }, IM_COL32_WHITE, thickness);
+    }
+    for (const auto& s : segments) {
+        one_by_one.AddRectFilled({ s.from.x, s.from.y }, { s.to.x, s.to.y }, IM_COL32_WHITE);
+    }
+    for (const auto& t : triangles) {
+        one_by_one.AddTriangleFilled({ t.p1.x, t.p1.y }, { t.p2.x, t.p2.y }, { t.p3.x, t.p3.y }, IM_COL32_WHITE);
+    }
+    uxx::detail::add_lines(bulk, segments, IM_COL32_WHITE, thickness);
+    uxx::detail::add_rects_filled(bulk, rects, IM_COL32_WHITE);
+    uxx::detail::add_triangles_filled(bulk, triangles, IM_COL32_WHITE);
+
+    REQUIRE(uxx::test::has_same_geometry(one_by_one, bulk));
+}
+
+TEST_CASE("Bulk lines have the geometry of ImGui's lines with the flags of a new frame", "[bulk_primitives]")
+{
+    const uxx::test::imgui_frame frame { ImGuiBackendFlags_None };
+    // Textured up to a thickness of 63 pixels, only whole pixels
+    const auto thickness = GENERATE(0.5f, 1.0f, 2.0f, 2.5f, 63.0f);
+    const auto segments = create_segments(100);
+    auto& one_by_one = *ImGui::GetBackgroundDrawList();
+    auto& bulk = *ImGui::GetForegroundDrawList();
+
+    REQUIRE((bulk.Flags & ImDrawListFlags_AntiAliasedLinesUseTex) != 0);
+    REQUIRE(one_by_one.Flags == bulk.Flags);
+
+    for (const auto& s : segments) {
+        one_by_one.AddLine({ s.from.x, s.from.y }, { s.to.x, s.to.y }, IM_COL32_WHITE, thickness);
+    }
+    uxx::detail::add_lines(bulk, segments, IM_COL32_WHITE, thickness);
+
+    REQUIRE(uxx::test::has_same_geometry(one_by_one, bulk));
+}
+
+TEST_CASE("Bulk lines are split into commands of 64k vertices with 16-bit indices", "[bulk_primitives]")
+{
+    if constexpr (sizeof(ImDrawIdx) == 2) {
+        const uxx::test::imgui_frame frame { ImGuiBackendFlags_RendererHasVtxOffset };
+        const auto& draw_list = draw_lines(create_segments(100'000), 2.0f);
+
+        REQUIRE(draw_list.VtxBuffer.Size > 0xFFFF);
+        REQUIRE(draw_list.CmdBuffer.Size > draw_list.VtxBuffer.Size / 0x10000);
+        REQUIRE(uxx::test::has_valid_indices(draw_list));
+    } else {
+        const uxx::test::imgui_frame frame { ImGuiBackendFlags_None };
+        const auto& draw_list = draw_lines(create_segments(100'000), 2.0f);
+
+        REQUIRE(draw_list.CmdBuffer.Size == 1);
+        REQUIRE(uxx::test::has_valid_indices(draw_list));
+    }
+}
@@ -0,0 +1,133 @@
+#include "test.hpp"
+#include "capture_encoder.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct temporary_directory {
+    std::filesystem::path path { std::filesystem::temp_directory_path() / "uxx_capture_encoder_test" };
+
+    temporary_directory()
+    {
+        std::filesystem::remove_all(path);
+        std::filesystem::create_directories(path);
+    }
+
+    ~temporary_directory()
+    {
+        std::filesystem::remove_all(path);
+    }
+};
+
+// A frame of a single color with transparent pixels, like a framebuffer that was cleared without alpha
+[[nodiscard]] std::vector<std::uint8_t> fill(const unsigned int width, const unsigned int height, const std::uint8_t r, const std::uint8_t g, const std::uint8_t b)
+{
+    std::vector<std::uint8_t> pixels {};
+
+    for (unsigned int i = 0; i < width * height; ++i) {
+        pixels.insert(pixels.end(), { r, g, b, 0 });
+    }
+    return pixels;
+}
+
+[[nodiscard]] std::string read_file(const std::filesystem::path& file)
+{
+    std::ifstream in { file, std::ios::binary };
+    return { std::istreambuf_iterator<char> { in }, std::istreambuf_iterator<char> {} };
+}
+
+}
+
+TEST_CASE("Raw captures store opaque frames from the top row down", "[capture_encoder]")
+{
+    const temporary_directory directory {};
+    const auto file = directory.path / "capture.rgba";
+    {
+        uxx::detail::capture_encoder encoder { file, uxx::app::capture_format::raw_rgba, 60 };
+        // The bottom row first, like glReadPixels
+        REQUIRE(encoder.submit({ 1, 2, 3, 0, 4, 5, 6, 0 }, 1, 2, true));
+        encoder.finish();
+    }
+    REQUIRE(read_file(file) == std::string { 4, 5, 6, '\xff', 1, 2, 3, '\xff' });
+}
+
+TEST_CASE("Y4M captures write 4:2:0 frames and repeat skipped frames", "[capture_encoder]")
+{
+    const temporary_directory directory {};
+    const auto file = directory.path / "capture.y4m";
+    {
+        uxx::detail::capture_encoder encoder { file, uxx::app::capture_format::y4m, 30 };
+        REQUIRE(encoder.submit(fill(4, 2, 255, 255, 255), 4, 2, false));
+        encoder.repeat();
+        encoder.finish();
+    }
+    const std::string header { "YUV4MPEG2 W4 H2 F30:1 Ip A1:1 C420jpeg XCOLORRANGE=FULL\n" };
+    const std::string white_frame = "FRAME\n" + std::string(8, '\xff') + std::string(4, '\x80');
+
+    REQUIRE(read_file(file) == header + white_frame + white_frame);
+}
+
+TEST_CASE("Video captures drop frames whose size differs from the first", "[capture_encoder]")
+{
+    const temporary_directory directory {};
+    const auto file = directory.path / "capture.rgba";
+    uxx::detail::capture_encoder encoder { file, uxx::app::capture_format::raw_rgba, 60 };
+
+    REQUIRE(encoder.submit(fill(2, 2, 0, 0, 0), 2, 2, false));
+    REQUIRE(encoder.submit(fill(4, 4, 0, 0, 0), 4, 4, false));
+    encoder.finish();
+
+    REQUIRE(encoder.get_dropped_count() == 1);
+    REQUIRE(std::filesystem::file_size(file) == 2 * 2 * 4);
+}
+
+TEST_CASE("Repeated frames don't take up room in the queue", "[capture_encoder]")
+{
+    const temporary_directory directory {};
+    const auto file = directory.path / "capture.rgba";
+    uxx::detail::capture_encoder encoder { file, uxx::app::capture_format::raw_rgba, 60 };
+
+    REQUIRE(encoder.submit(fill(2, 2, 0, 0, 0), 2, 2, false));
+
+    for (std::size_t i = 0; i < uxx::detail::capture_encoder::MAX_QUEUED_FRAMES * 2; ++i) {
+        encoder.repeat();
+    }
+    encoder.finish();
+
+    REQUIRE(encoder.get_dropped_count() == 0);
+    REQUIRE(std::filesystem::file_size(file) == (uxx::detail::capture_encoder::MAX_QUEUED_FRAMES * 2 + 1) * 2 * 2 * 4);
+}
+
+TEST_CASE("PNG sequences write an image per frame", "[capture_encoder]")
+{
+    const temporary_directory directory {};
+    const auto sequence = directory.path / "frames";
+    {
+        uxx::detail::capture_encoder encoder { sequence, uxx::app::capture_format::png_sequence, 60 };
+        REQUIRE(encoder.submit(fill(3, 2, 255, 0, 0), 3, 2, false));
+        REQUIRE(encoder.submit(fill(5, 4, 0, 0, 255), 5, 4, false));
+        encoder.finish();
+    }
+    sf::Image first {};
+    sf::Image second {};
+
+    REQUIRE(first.loadFromFile((sequence / "frame_000000.png").string()));
+    REQUIRE(second.loadFromFile((sequence / "frame_000001.png").string()));
+    REQUIRE(first.getSize() == sf::Vector2u { 3, 2 });
+    // The last pixel of the second frame, opaque blue
+    const auto* pixel = second.getPixelsPtr() + (3 * 5 + 4) * 4;
+    REQUIRE(std::vector<std::uint8_t>(pixel, pixel + 4) == std::vector<std::uint8_t> { 0, 0, 255, 255 });
+}
+
+TEST_CASE("A capture that can't be created throws", "[capture_encoder]")
+{
+    const temporary_directory directory {};
+    const auto file = directory.path / "missing" / "capture.y4m";
+
+    REQUIRE_THROWS_AS(uxx::detail::capture_encoder(file, uxx::app::capture_format::y4m, 60), std::runtime_error);
+}
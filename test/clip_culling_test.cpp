@@ -0,0 +1,82 @@
+#include "test.hpp"
+#include "common.hpp"
+#include "draw_list.hpp"
+#include "imgui_fixture.hpp"
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <vector>
+
+TEST_CASE("Bulk primitives outside the clip rectangle are left out", "[clip_culling]")
+{
+    const uxx::test::imgui_frame frame { ImGuiBackendFlags_None };
+    const auto flags = GENERATE(ImDrawListFlags_None, ImDrawListFlags_AntiAliasedLines | ImDrawListFlags_AntiAliasedFill);
+    const std::vector<uxx::segment> visible { { { 10.0f, 10.0f }, { 50.0f, 60.0f } }, { { 90.0f, 10.0f }, { 150.0f, 10.0f } } };
+    const std::vector<uxx::segment> segments { visible[0], { { 200.0f, 10.0f }, { 300.0f, 60.0f } }, visible[1], { { 10.0f, 110.0f }, { 50.0f, 150.0f } } };
+    const auto to_rects = [](const std::vector<uxx::segment>& s) {
+        std::vector<uxx::rect> rects {};
+        std::transform(s.begin(), s.end(), std::back_inserter(rects), [](const uxx::segment& x) { return uxx::rect { x.from, x.to }; });
+        return rects;
+    };
+    const auto to_triangles = [](const std::vector<uxx::segment>& s) {
+        std::vector<uxx::triangle> triangles {};
+        std::transform(s.begin(), s.end(), std::back_inserter(triangles), [](const uxx::segment& x) { return uxx::triangle { x.from, x.to, { x.from.x, x.to.y } }; });
+        return triangles;
+    };
+    auto& unclipped = *ImGui::GetBackgroundDrawList();
+    auto& clipped = *ImGui::GetForegroundDrawList();
+    unclipped.Flags = flags;
+    clipped.Flags = flags;
+    clipped.PushClipRect({ 0.0f, 0.0f }, { 100.0f, 100.0f });
+
+    uxx::detail::add_lines(unclipped, visible, IM_COL32_WHITE, 2.0f);
+    uxx::detail::add_rects_filled(unclipped, to_rects(visible), IM_COL32_WHITE);
+    uxx::detail::add_triangles_filled(unclipped, to_triangles(visible), IM_COL32_WHITE);
+
+    REQUIRE(uxx::detail::add_lines(clipped, segments, IM_COL32_WHITE, 2.0f) == 2);
+    REQUIRE(uxx::detail::add_rects_filled(clipped, to_rects(segments), IM_COL32_WHITE) == 2);
+    REQUIRE(uxx::detail::add_triangles_filled(clipped, to_triangles(segments), IM_COL32_WHITE) == 2);
+    REQUIRE(uxx::test::has_same_geometry(unclipped, clipped));
+}
+
+TEST_CASE("Polylines are only tessellated where they may be visible", "[clip_culling]")
+{
+    const uxx::test::imgui_frame frame { ImGuiBackendFlags_None };
+    const auto thickness = GENERATE(1.0f, 4.0f);
+    std::vector<ImVec2> points(200);
+
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        points[i] = ImVec2 { static_cast<float>(i) * 9.0f, i % 2 == 0 ? 100.0f : 130.0f };
+    }
+    auto& unclipped = *ImGui::GetBackgroundDrawList();
+    auto& clipped = *ImGui::GetForegroundDrawList();
+    unclipped.Flags = ImDrawListFlags_AntiAliasedLines;
+    clipped.Flags = ImDrawListFlags_AntiAliasedLines;
+    const ImVec4 clip { 500.0f, 0.0f, 700.0f, 200.0f };
+    clipped.PushClipRect({ clip.x, clip.y }, { clip.z, clip.w });
+
+    REQUIRE(uxx::detail::add_visible_polyline(unclipped, points, IM_COL32_WHITE, false, thickness) == 0);
+    const auto culled = uxx::detail::add_visible_polyline(clipped, points, IM_COL32_WHITE, false, thickness);
+
+    REQUIRE(culled > 150);
+    REQUIRE(clipped.VtxBuffer.Size < unclipped.VtxBuffer.Size / 4);
+    // The joints inside the clip rectangle are the same as those of the whole polyline
+    std::size_t inside = 0;
+
+    for (const auto& v : unclipped.VtxBuffer) {
+        if (v.pos.x >= clip.x && v.pos.x <= clip.z) {
+            const auto same = std::find_if(clipped.VtxBuffer.begin(), clipped.VtxBuffer.end(), [&](const ImDrawVert& w) {
+                return w.pos.x == v.pos.x && w.pos.y == v.pos.y && w.col == v.col;
+            });
+            REQUIRE(same != clipped.VtxBuffer.end());
+            ++inside;
+        }
+    }
+    REQUIRE(inside > 0);
+    REQUIRE(uxx::test::has_valid_indices(clipped));
+
+    // Closed polylines are drawn whole, or left out whole
+    const std::array<ImVec2, 3> outside { ImVec2 { 0.0f, 0.0f }, ImVec2 { 10.0f, 0.0f }, ImVec2 { 0.0f, 10.0f } };
+    REQUIRE(uxx::detail::add_visible_polyline(clipped, outside, IM_COL32_WHITE, true, thickness) == 3);
+}
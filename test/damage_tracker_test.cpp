@@ -0,0 +1,112 @@
+#include "test.hpp"
+#include "common.hpp"
+#include "damage_tracker.hpp"
+#include "imgui_fixture.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// A static background with a small status light on top
+void draw_status(ImDrawList& draw_list, const ImU32 light)
+{
+    draw_list.AddRectFilled(ImVec2 { 0.0f, 0.0f }, ImVec2 { 800.0f, 600.0f }, IM_COL32(40, 40, 40, 255));
+    draw_list.AddRectFilled(ImVec2 { 100.5f, 200.5f }, ImVec2 { 110.0f, 210.0f }, light);
+    draw_list.AddRectFilled(ImVec2 { 300.0f, 300.0f }, ImVec2 { 400.0f, 400.0f }, IM_COL32_WHITE);
+}
+
+bool equal(const ImVec4& a, const ImVec4& b)
+{
+    return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w;
+}
+
+}
+
+TEST_CASE("The first frame damages the whole display", "[damage_tracker]")
+{
+    const uxx::test::imgui_context context {};
+    uxx::detail::damage_tracker tracker {};
+    REQUIRE(equal(tracker.update(context.build([](ImDrawList& draw_list) { draw_status(draw_list, IM_COL32_BLACK); })), ImVec4 { 0.0f, 0.0f, 800.0f, 600.0f }));
+}
+
+TEST_CASE("An unchanged frame has no damage", "[damage_tracker]")
+{
+    const uxx::test::imgui_context context {};
+    uxx::detail::damage_tracker tracker {};
+    (void)tracker.update(context.build([](ImDrawList& draw_list) { draw_status(draw_list, IM_COL32_BLACK); }));
+
+    REQUIRE(uxx::detail::is_empty(tracker.update(context.build([](ImDrawList& draw_list) { draw_status(draw_list, IM_COL32_BLACK); }))));
+}
+
+TEST_CASE("Only the changed triangles are damaged, rounded out to whole pixels", "[damage_tracker]")
+{
+    const uxx::test::imgui_context context {};
+    uxx::detail::damage_tracker tracker {};
+    (void)tracker.update(context.build([](ImDrawList& draw_list) { draw_status(draw_list, IM_COL32_BLACK); }));
+
+    const auto damage = tracker.update(context.build([](ImDrawList& draw_list) { draw_status(draw_list, IM_COL32(0, 255, 0, 255)); }));
+    REQUIRE(equal(damage, ImVec4 { 100.0f, 200.0f, 110.0f, 210.0f }));
+}
+
+TEST_CASE("Added and removed triangles are damaged", "[damage_tracker]")
+{
+    const uxx::test::imgui_context context {};
+    uxx::detail::damage_tracker tracker {};
+    (void)tracker.update(context.build([](ImDrawList& draw_list) { draw_status(draw_list, IM_COL32_BLACK); }));
+
+    const auto added = tracker.update(context.build([](ImDrawList& draw_list) {
+        draw_status(draw_list, IM_COL32_BLACK);
+        draw_list.AddRectFilled(ImVec2 { 500.0f, 20.0f }, ImVec2 { 520.0f, 40.0f }, IM_COL32_WHITE);
+    }));
+    REQUIRE(equal(added, ImVec4 { 500.0f, 20.0f, 520.0f, 40.0f }));
+
+    const auto removed = tracker.update(context.build([](ImDrawList& draw_list) { draw_status(draw_list, IM_COL32_BLACK); }));
+    REQUIRE(equal(removed, ImVec4 { 500.0f, 20.0f, 520.0f, 40.0f }));
+}
+
+TEST_CASE("A changed clip rectangle damages both clip rectangles", "[damage_tracker]")
+{
+    const uxx::test::imgui_context context {};
+    uxx::detail::damage_tracker tracker {};
+    const auto draw_clipped = [](const float right) {
+        return [right](ImDrawList& draw_list) {
+            draw_list.PushClipRect(ImVec2 { 10.0f, 10.0f }, ImVec2 { right, 50.0f });
+            draw_list.AddRectFilled(ImVec2 { 0.0f, 0.0f }, ImVec2 { 20.0f, 20.0f }, IM_COL32_WHITE);
+            draw_list.PopClipRect();
+        };
+    };
+    (void)tracker.update(context.build(draw_clipped(100.0f)));
+
+    REQUIRE(equal(tracker.update(context.build(draw_clipped(200.0f))), ImVec4 { 10.0f, 10.0f, 200.0f, 50.0f }));
+}
+
+TEST_CASE("Clipping to the damage keeps the indices of every command", "[damage_tracker]")
+{
+    const uxx::test::imgui_context context {};
+    auto& draw_data = context.build([](ImDrawList& draw_list) {
+        for (const float left : { 0.0f, 200.0f, 400.0f }) {
+            draw_list.PushClipRect(ImVec2 { left, 0.0f }, ImVec2 { left + 100.0f, 100.0f });
+            draw_list.AddRectFilled(ImVec2 { left, 0.0f }, ImVec2 { left + 50.0f, 50.0f }, IM_COL32_WHITE);
+            draw_list.PopClipRect();
+        }
+    });
+    const auto& commands = draw_data.CmdLists[0]->CmdBuffer;
+    std::vector<unsigned int> counts {};
+
+    for (const auto& command : commands) {
+        counts.push_back(command.ElemCount);
+    }
+    uxx::detail::clip_draw_data(draw_data, ImVec4 { 220.0f, 10.0f, 240.0f, 20.0f });
+
+    // The legacy renderer walks the indices of a list back to back
+    unsigned int walked = 0;
+
+    for (int i = 0; i < commands.Size; ++i) {
+        REQUIRE(commands[i].ElemCount == counts[static_cast<std::size_t>(i)]);
+        REQUIRE(commands[i].IdxOffset == walked);
+        walked += commands[i].ElemCount;
+    }
+    const auto visible = std::count_if(commands.begin(), commands.end(), [](const ImDrawCmd& command) { return !uxx::detail::is_empty(command.ClipRect); });
+    REQUIRE(visible == 1);
+}
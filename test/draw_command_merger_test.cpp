@@ -0,0 +1,145 @@
+#include "test.hpp"
+#include "common.hpp"
+#include "draw_command_merger.hpp"
+#include "imgui_fixture.hpp"
+#include "software_renderer.hpp"
+
+#include <array>
+#include <vector>
+
+namespace {
+
+constexpr unsigned int WIDTH { 400 };
+constexpr unsigned int HEIGHT { 300 };
+
+// Textures of a single color, drawn like images and videos with textures of their own
+const std::array<ImTextureID, 2> TEXTURES { reinterpret_cast<ImTextureID>(1), reinterpret_cast<ImTextureID>(2) };
+
+const ImVec2 DISPLAY_SIZE { static_cast<float>(WIDTH), static_cast<float>(HEIGHT) };
+
+// Software renderer that knows the font atlas of the context and the textures of the tiles
+class tile_renderer {
+public:
+    explicit tile_renderer(const uxx::test::imgui_context& context)
+        : _renderer { 1 }
+    {
+        context.register_font_atlas(_renderer);
+        const std::array<unsigned char, 4> red { 255, 0, 0, 255 };
+        const std::array<unsigned char, 4> blue { 0, 0, 255, 128 };
+        _renderer.set_texture(TEXTURES[0], 1, 1, red.data());
+        _renderer.set_texture(TEXTURES[1], 1, 1, blue.data());
+    }
+
+    [[nodiscard]] std::vector<std::uint8_t> render(const ImDrawData& draw_data)
+    {
+        _renderer.render(draw_data);
+        const auto pixels = _renderer.get_pixels();
+        return { pixels.begin(), pixels.end() };
+    }
+
+private:
+    uxx::detail::software_renderer _renderer;
+};
+
+void add_image(ImDrawList& draw_list, const std::size_t texture, const float x, const float y, const float size)
+{
+    draw_list.AddImage(TEXTURES[texture], ImVec2 { x, y }, ImVec2 { x + size, y + size });
+}
+
+// A grid of image tiles with alternating textures and a caption under each tile
+void draw_tiles(ImDrawList& draw_list)
+{
+    for (int row = 0; row < 3; ++row) {
+        for (int column = 0; column < 5; ++column) {
+            const float x = 10.0f + static_cast<float>(column) * 60.0f;
+            const float y = 10.0f + static_cast<float>(row) * 70.0f;
+            add_image(draw_list, static_cast<std::size_t>(row + column) % 2, x, y, 50.0f);
+            draw_list.AddText(ImVec2 { x, y + 52.0f }, IM_COL32_WHITE, "tile");
+        }
+    }
+}
+
+[[nodiscard]] std::size_t count_commands(const ImDrawData& draw_data)
+{
+    std::size_t commands = 0;
+
+    for (int i = 0; i < draw_data.CmdListsCount; ++i) {
+        commands += static_cast<std::size_t>(draw_data.CmdLists[i]->CmdBuffer.Size);
+    }
+    return commands;
+}
+
+}
+
+TEST_CASE("Commands with alternating textures merge when they don't overlap", "[draw_command_merger]")
+{
+    const uxx::test::imgui_context context { DISPLAY_SIZE };
+    auto& draw_data = context.build(draw_tiles);
+    const auto before = count_commands(draw_data);
+    const auto indices = draw_data.TotalIdxCount;
+    tile_renderer renderer { context };
+    const auto expected = renderer.render(draw_data);
+
+    uxx::detail::draw_command_merger merger {};
+    const auto after = merger.merge(draw_data);
+
+    // Every tile and caption had a command of its own, one command per texture remains
+    REQUIRE(before == 30);
+    REQUIRE(after == 3);
+    REQUIRE(count_commands(draw_data) == after);
+    REQUIRE(draw_data.TotalIdxCount == indices);
+    REQUIRE(renderer.render(draw_data) == expected);
+}
+
+TEST_CASE("Commands don't move past commands they overlap", "[draw_command_merger]")
+{
+    const uxx::test::imgui_context context { DISPLAY_SIZE };
+    auto& draw_data = context.build([](ImDrawList& draw_list) {
+        add_image(draw_list, 0, 10.0f, 10.0f, 50.0f);
+        add_image(draw_list, 1, 40.0f, 40.0f, 50.0f);
+        add_image(draw_list, 0, 70.0f, 70.0f, 50.0f);
+        add_image(draw_list, 1, 200.0f, 10.0f, 50.0f);
+    });
+    tile_renderer renderer { context };
+    const auto expected = renderer.render(draw_data);
+
+    uxx::detail::draw_command_merger merger {};
+    // The last blue tile joins the first one, the red ones are kept apart by the blue tile between them
+    REQUIRE(merger.merge(draw_data) == 3);
+    REQUIRE(renderer.render(draw_data) == expected);
+}
+
+TEST_CASE("Commands don't move past user callbacks", "[draw_command_merger]")
+{
+    const uxx::test::imgui_context context { DISPLAY_SIZE };
+    auto& draw_data = context.build([](ImDrawList& draw_list) {
+        add_image(draw_list, 0, 10.0f, 10.0f, 50.0f);
+        add_image(draw_list, 1, 100.0f, 10.0f, 50.0f);
+        draw_list.AddCallback([](const ImDrawList*, const ImDrawCmd*) {}, nullptr);
+        add_image(draw_list, 0, 200.0f, 10.0f, 50.0f);
+        add_image(draw_list, 1, 300.0f, 10.0f, 50.0f);
+    });
+    uxx::detail::draw_command_merger merger {};
+    const auto before = count_commands(draw_data);
+
+    REQUIRE(merger.merge(draw_data) == before);
+    REQUIRE(draw_data.CmdLists[0]->CmdBuffer[2].UserCallback != nullptr);
+}
+
+TEST_CASE("Empty commands are dropped", "[draw_command_merger]")
+{
+    const uxx::test::imgui_context context { DISPLAY_SIZE };
+    auto& draw_data = context.build([](ImDrawList& draw_list) {
+        add_image(draw_list, 0, 10.0f, 10.0f, 50.0f);
+        draw_list.PushClipRect(ImVec2 { 0.0f, 0.0f }, ImVec2 { 10.0f, 10.0f });
+        draw_list.PopClipRect();
+        add_image(draw_list, 1, 100.0f, 10.0f, 50.0f);
+    });
+    uxx::detail::draw_command_merger merger {};
+    const auto after = merger.merge(draw_data);
+
+    for (const auto& command : draw_data.CmdLists[0]->CmdBuffer) {
+        REQUIRE(command.ElemCount > 0);
+    }
+    REQUIRE(after == 2);
+}
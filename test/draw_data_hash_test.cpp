@@ -0,0 +1,62 @@
+#include "test.hpp"
+#include "common.hpp"
+#include "draw_data_hash.hpp"
+#include "imgui_fixture.hpp"
+
+#include <functional>
+
+namespace {
+
+/// \return Hash of a frame that draws on the foreground draw list.
+[[nodiscard]] std::optional<std::uint64_t> hash_frame(const uxx::test::imgui_context& context, const std::function<void(ImDrawList&)>& draw)
+{
+    return uxx::detail::hash_draw_data(context.build(draw));
+}
+
+void draw_rect(ImDrawList& draw_list, const float x)
+{
+    draw_list.AddRectFilled(ImVec2 { x, 10.0f }, ImVec2 { x + 100.0f, 110.0f }, IM_COL32_WHITE);
+}
+
+}
+
+TEST_CASE("Identical frames have equal draw data hashes", "[draw_data_hash]")
+{
+    const uxx::test::imgui_context context {};
+    const auto first = hash_frame(context, [](ImDrawList& draw_list) { draw_rect(draw_list, 10.0f); });
+    const auto second = hash_frame(context, [](ImDrawList& draw_list) { draw_rect(draw_list, 10.0f); });
+
+    REQUIRE(first.has_value());
+    REQUIRE(first == second);
+}
+
+TEST_CASE("Changed vertices, colors and clip rectangles change the draw data hash", "[draw_data_hash]")
+{
+    const uxx::test::imgui_context context {};
+    const auto reference = hash_frame(context, [](ImDrawList& draw_list) { draw_rect(draw_list, 10.0f); });
+
+    REQUIRE(reference != hash_frame(context, [](ImDrawList& draw_list) { draw_rect(draw_list, 10.5f); }));
+    REQUIRE(reference != hash_frame(context, [](ImDrawList& draw_list) {
+        draw_list.AddRectFilled(ImVec2 { 10.0f, 10.0f }, ImVec2 { 110.0f, 110.0f }, IM_COL32_BLACK);
+    }));
+    REQUIRE(reference != hash_frame(context, [](ImDrawList& draw_list) {
+        draw_list.PushClipRect(ImVec2 { 0.0f, 0.0f }, ImVec2 { 400.0f, 300.0f });
+        draw_rect(draw_list, 10.0f);
+        draw_list.PopClipRect();
+    }));
+    REQUIRE(reference != hash_frame(context, [](ImDrawList& draw_list) {
+        draw_rect(draw_list, 10.0f);
+        draw_rect(draw_list, 10.0f);
+    }));
+}
+
+TEST_CASE("Draw data with user callbacks can't be hashed", "[draw_data_hash]")
+{
+    const uxx::test::imgui_context context {};
+    const auto hash = hash_frame(context, [](ImDrawList& draw_list) {
+        draw_rect(draw_list, 10.0f);
+        draw_list.AddCallback([](const ImDrawList*, const ImDrawCmd*) {}, nullptr);
+    });
+
+    REQUIRE_FALSE(hash.has_value());
+}
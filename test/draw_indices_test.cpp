@@ -0,0 +1,84 @@
+#include "test.hpp"
+#include "common.hpp"
+#include "draw_list.hpp"
+#include "imgui_fixture.hpp"
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t POLYLINE_POINTS { 1'000'000 };
+
+// ImGui context set up by the imgui-SFML backend of the legacy renderer, without a window
+class legacy_frame {
+public:
+    legacy_frame()
+    {
+        ImGui::SFML::Init(sf::Vector2f { 1920.0f, 1080.0f }, false);
+        auto& io = ImGui::GetIO();
+        io.IniFilename = nullptr;
+
+        unsigned char* pixels = nullptr;
+        int width = 0;
+        int height = 0;
+        io.Fonts->GetTexDataAsAlpha8(&pixels, &width, &height);
+        ImGui::NewFrame();
+    }
+
+    ~legacy_frame()
+    {
+        ImGui::SFML::Shutdown();
+    }
+
+    legacy_frame(const legacy_frame&) = delete;
+    legacy_frame(legacy_frame&&) = delete;
+    legacy_frame& operator=(const legacy_frame&) = delete;
+    legacy_frame& operator=(legacy_frame&&) = delete;
+};
+
+/// \return The draw list that received the polyline, with nothing else in it.
+[[nodiscard]] const ImDrawList& draw_polyline(const std::size_t point_count)
+{
+    std::vector<ImVec2> points(point_count);
+
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        const auto x = static_cast<float>(i) / static_cast<float>(points.size());
+        points[i] = ImVec2 { x * 1900.0f, 540.0f + 500.0f * std::sin(x * 200.0f) };
+    }
+    auto& draw_list = *ImGui::GetForegroundDrawList();
+    uxx::detail::add_polyline(draw_list, points, IM_COL32_WHITE, false, 1.0f);
+    ImGui::Render();
+    return draw_list;
+}
+
+}
+
+TEST_CASE("A 1M point polyline is drawn with a single command with 32-bit indices", "[draw_indices]")
+{
+    if constexpr (sizeof(ImDrawIdx) == 4) {
+        const uxx::test::imgui_frame frame { ImGuiBackendFlags_None };
+        const auto& draw_list = draw_polyline(POLYLINE_POINTS);
+
+        REQUIRE(draw_list.VtxBuffer.Size > 0xFFFF);
+        REQUIRE(draw_list.CmdBuffer.Size == 1);
+        REQUIRE(uxx::test::has_valid_indices(draw_list));
+    } else {
+        SUCCEED("Configure with -DUXX_32BIT_INDICES=ON to draw the polyline with one command");
+    }
+}
+
+TEST_CASE("A 1M point polyline is split into commands of 64k vertices with 16-bit indices", "[draw_indices]")
+{
+    if constexpr (sizeof(ImDrawIdx) == 2) {
+        // Every renderer supports vertex offsets, without them the draw list would overflow its indices.
+        // The backend of the legacy renderer announces them for all of them.
+        const legacy_frame frame {};
+        const auto& draw_list = draw_polyline(POLYLINE_POINTS);
+
+        REQUIRE(draw_list.CmdBuffer.Size > draw_list.VtxBuffer.Size / 0x10000);
+        REQUIRE(uxx::test::has_valid_indices(draw_list));
+    } else {
+        SUCCEED("Draw lists use 32-bit indices");
+    }
+}
@@ -0,0 +1,92 @@
+#include "test.hpp"
+#include "font_atlas.hpp"
+
+#include <cstring>
+
+namespace {
+
+struct temporary_directory {
+    std::filesystem::path path { std::filesystem::temp_directory_path() / "uxx_font_atlas_test" };
+
+    temporary_directory()
+    {
+        std::filesystem::remove_all(path);
+    }
+
+    ~temporary_directory()
+    {
+        std::filesystem::remove_all(path);
+    }
+};
+
+void add_default_font(ImFontAtlas& atlas, const float size_pixels)
+{
+    ImFontConfig config {};
+    config.SizePixels = size_pixels;
+    atlas.AddFontDefault(&config);
+}
+
+}
+
+TEST_CASE("Font atlas is restored from the cache on the second build", "[font_atlas]")
+{
+    const temporary_directory cache {};
+
+    ImFontAtlas built {};
+    add_default_font(built, 13.0f);
+    REQUIRE_FALSE(uxx::detail::build_font_atlas(built, cache.path));
+
+    ImFontAtlas restored {};
+    add_default_font(restored, 13.0f);
+    REQUIRE(uxx::detail::build_font_atlas(restored, cache.path));
+
+    REQUIRE(restored.IsBuilt());
+    REQUIRE(restored.TexWidth == built.TexWidth);
+    REQUIRE(restored.TexHeight == built.TexHeight);
+    REQUIRE(std::memcmp(restored.TexPixelsAlpha8, built.TexPixelsAlpha8, static_cast<std::size_t>(built.TexWidth * built.TexHeight)) == 0);
+    REQUIRE(restored.Fonts[0]->Glyphs.Size == built.Fonts[0]->Glyphs.Size);
+    REQUIRE(restored.Fonts[0]->FindGlyph('A')->U0 == built.Fonts[0]->FindGlyph('A')->U0);
+    REQUIRE(restored.Fonts[0]->CalcTextSizeA(13.0f, 1000.0f, 0.0f, "uxx").x == built.Fonts[0]->CalcTextSizeA(13.0f, 1000.0f, 0.0f, "uxx").x);
+
+    ImVec2 offset {};
+    ImVec2 size {};
+    std::array<ImVec2, 2> border {};
+    std::array<ImVec2, 2> fill {};
+    REQUIRE(restored.GetMouseCursorTexData(ImGuiMouseCursor_Arrow, &offset, &size, border.data(), fill.data()));
+}
+
+TEST_CASE("Font atlas key depends on font size and glyph ranges", "[font_atlas]")
+{
+    ImFontAtlas small {};
+    add_default_font(small, 13.0f);
+    ImFontAtlas large {};
+    add_default_font(large, 26.0f);
+    ImFontAtlas cyrillic {};
+    ImFontConfig config {};
+    config.GlyphRanges = cyrillic.GetGlyphRangesCyrillic();
+    cyrillic.AddFontDefault(&config);
+
+    REQUIRE(uxx::detail::get_font_atlas_key(small) != uxx::detail::get_font_atlas_key(large));
+    REQUIRE(uxx::detail::get_font_atlas_key(small) != uxx::detail::get_font_atlas_key(cyrillic));
+}
+
+TEST_CASE("Damaged cache files are rebuilt", "[font_atlas]")
+{
+    const temporary_directory cache {};
+
+    ImFontAtlas first {};
+    add_default_font(first, 13.0f);
+    REQUIRE_FALSE(uxx::detail::build_font_atlas(first, cache.path));
+
+    for (const auto& entry : std::filesystem::directory_iterator { cache.path }) {
+        std::filesystem::resize_file(entry.path(), 64);
+    }
+    ImFontAtlas second {};
+    add_default_font(second, 13.0f);
+    REQUIRE_FALSE(uxx::detail::build_font_atlas(second, cache.path));
+    REQUIRE(second.IsBuilt());
+
+    ImFontAtlas third {};
+    add_default_font(third, 13.0f);
+    REQUIRE(uxx::detail::build_font_atlas(third, cache.path));
+}
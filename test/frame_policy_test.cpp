@@ -0,0 +1,33 @@
+#include "test.hpp"
+#include "uxx/uxx.hpp"
+
+using namespace std::chrono_literals;
+using frame_policy = uxx::app::frame_policy;
+
+TEST_CASE("Vsync is the default frame policy", "[frame_policy]")
+{
+    const auto policy = frame_policy::vsync();
+    REQUIRE(policy.get_mode() == frame_policy::mode::vsync);
+    REQUIRE(policy.get_frame_budget() == std::chrono::nanoseconds { 1s } / frame_policy::DEFAULT_REFRESH_RATE);
+}
+
+TEST_CASE("Fixed rate derives frame budget from frames per second", "[frame_policy]")
+{
+    const auto policy = frame_policy::fixed_rate(144);
+    REQUIRE(policy.get_mode() == frame_policy::mode::fixed_rate);
+    REQUIRE(policy.get_frame_budget() == std::chrono::nanoseconds { 6944444 });
+    REQUIRE(policy.get_spin_threshold() == frame_policy::DEFAULT_SPIN_THRESHOLD);
+}
+
+TEST_CASE("Fixed rate of zero frames per second is uncapped", "[frame_policy]")
+{
+    const auto policy = frame_policy::fixed_rate(0);
+    REQUIRE(policy.get_mode() == frame_policy::mode::uncapped);
+    REQUIRE(policy.get_frame_budget() == 0ns);
+}
+
+TEST_CASE("Spin threshold is configurable", "[frame_policy]")
+{
+    const auto policy = frame_policy::fixed_rate(60).set_spin_threshold(500us);
+    REQUIRE(policy.get_spin_threshold() == 500us);
+}
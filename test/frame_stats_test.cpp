@@ -0,0 +1,75 @@
+#include "test.hpp"
+#include "uxx/uxx.hpp"
+
+using namespace std::chrono_literals;
+using frame_phase = uxx::app::frame_phase;
+using frame_stats = uxx::app::frame_stats;
+
+static uxx::app::frame_sample make_sample(const std::chrono::nanoseconds callback_time)
+{
+    uxx::app::frame_sample sample {};
+    sample.phases[static_cast<std::size_t>(frame_phase::update)] = 1ms;
+    sample.phases[static_cast<std::size_t>(frame_phase::callback)] = callback_time;
+    return sample;
+}
+
+TEST_CASE("Empty frame stats summarize to zero", "[frame_stats]")
+{
+    const frame_stats stats {};
+    REQUIRE(stats.get_sample_count() == 0);
+    REQUIRE(stats.get_frame_summary().p99 == 0ns);
+}
+
+TEST_CASE("Summarizes min, average and percentiles per phase", "[frame_stats]")
+{
+    frame_stats stats {};
+
+    for (int ms = 100; ms > 0; --ms) {
+        stats.add(make_sample(std::chrono::milliseconds { ms }));
+    }
+    const auto callback = stats.get_summary(frame_phase::callback);
+    REQUIRE(callback.min == 1ms);
+    REQUIRE(callback.avg == 50500us);
+    REQUIRE(callback.p95 == 95ms);
+    REQUIRE(callback.p99 == 99ms);
+
+    const auto display = stats.get_summary(frame_phase::display);
+    REQUIRE(display.min == 0ns);
+    REQUIRE(display.p99 == 0ns);
+
+    const auto frame = stats.get_frame_summary();
+    REQUIRE(frame.min == 2ms);
+    REQUIRE(frame.p99 == 100ms);
+}
+
+TEST_CASE("Keeps only the most recent frames", "[frame_stats]")
+{
+    frame_stats stats {};
+
+    for (std::size_t n = 0; n < frame_stats::CAPACITY + 10; ++n) {
+        stats.add(make_sample(std::chrono::microseconds { n }));
+    }
+    REQUIRE(stats.get_sample_count() == frame_stats::CAPACITY);
+    REQUIRE(stats.get_sample(0).get(frame_phase::callback) == std::chrono::microseconds { frame_stats::CAPACITY + 9 });
+    REQUIRE(stats.get_sample(frame_stats::CAPACITY - 1).get(frame_phase::callback) == 10us);
+    REQUIRE(stats.get_summary(frame_phase::callback).min == 10us);
+
+    stats.clear();
+    REQUIRE(stats.get_sample_count() == 0);
+}
+
+TEST_CASE("Counts the skipped frames among the recorded frames", "[frame_stats]")
+{
+    frame_stats stats {};
+
+    for (std::size_t n = 0; n < frame_stats::CAPACITY + 10; ++n) {
+        auto sample = make_sample(1ms);
+        // The ten oldest skipped frames fall out of the ring buffer
+        sample.skipped = n < 20;
+        stats.add(sample);
+    }
+    REQUIRE(stats.get_skipped_count() == 10);
+
+    stats.clear();
+    REQUIRE(stats.get_skipped_count() == 0);
+}
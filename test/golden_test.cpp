@@ -0,0 +1,150 @@
+#include "test.hpp"
+#include "common.hpp"
+#include "graphics_demo_tabs.hpp"
+
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr unsigned int WIDTH { 1024 };
+constexpr unsigned int HEIGHT { 600 };
+
+// Frames rendered per scene, the first ones settle the window layout
+constexpr std::uint64_t FRAME_COUNT { 120 };
+
+// Largest difference of a color channel that still counts as equal, absorbs rounding differences between compilers
+constexpr int CHANNEL_TOLERANCE { 16 };
+
+// Fraction of the pixels that may differ by more than CHANNEL_TOLERANCE, e.g. along antialiased edges
+constexpr double MAX_DIFFERING_PIXELS { 0.002 };
+
+const std::filesystem::path GOLDEN_DIRECTORY { UXX_GOLDEN_DIRECTORY };
+const std::filesystem::path OUTPUT_DIRECTORY { "golden_output" };
+const std::filesystem::path REPORT_FILE { "golden_report.csv" };
+
+struct scene_report {
+    std::string name;
+    uxx::app::frame_stats::summary frame;
+    uxx::app::frame_stats::summary render;
+    uxx::app::frame_counters counters;
+};
+
+/// \return File name of a tab's images, e.g. "background_foreground" for "Background/Foreground".
+[[nodiscard]] std::string get_scene_name(const std::string& label)
+{
+    std::string name {};
+
+    for (const char c : label) {
+        name += std::isalnum(static_cast<unsigned char>(c)) ? static_cast<char>(std::tolower(static_cast<unsigned char>(c))) : '_';
+    }
+    return name;
+}
+
+/// Render a tab of the demo window on its own with the software renderer, and save the last frame.
+[[nodiscard]] scene_report render_scene(const graphics_demo_tab& tab, const std::filesystem::path& image)
+{
+    uxx::app app { uxx::app::renderer::software };
+    app.set_width(WIDTH);
+    app.set_height(HEIGHT);
+    app.set_font_cache_directory({});
+    // Every frame is timed, even when it looks like the previous one
+    app.set_skip_unchanged_frames(false);
+
+    const auto mode = uxx::app::headless::frames(FRAME_COUNT).set_output_image(image);
+    const auto exit_code = app.run_headless(mode, [&tab](uxx::screen& screen) {
+        screen.window("Draw primitives", [&tab](uxx::pane& window) {
+            window.tab_bar(uxx::id("##TabBar"), [&tab](uxx::tab_bar& tab_bar) {
+                tab_bar.item(tab.label, tab.show);
+            });
+        });
+    });
+    REQUIRE(exit_code == 0);
+
+    const auto& stats = app.get_frame_stats();
+    return { get_scene_name(tab.label), stats.get_frame_summary(), stats.get_summary(uxx::app::frame_phase::render), app.get_last_frame_report().counters };
+}
+
+/// \return Number of pixels where any channel differs by more than CHANNEL_TOLERANCE.
+[[nodiscard]] std::size_t count_differing_pixels(const sf::Image& a, const sf::Image& b)
+{
+    const auto size = a.getSize();
+    const auto* pa = a.getPixelsPtr();
+    const auto* pb = b.getPixelsPtr();
+    std::size_t differing = 0;
+
+    for (std::size_t i = 0; i < std::size_t { size.x } * size.y; ++i) {
+        for (std::size_t c = 0; c < 4; ++c) {
+            if (std::abs(int { pa[i * 4 + c] } - int { pb[i * 4 + c] }) > CHANNEL_TOLERANCE) {
+                ++differing;
+                break;
+            }
+        }
+    }
+    return differing;
+}
+
+[[nodiscard]] double to_milliseconds(const std::chrono::nanoseconds duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+void write_report(const std::vector<scene_report>& reports)
+{
+    std::ofstream file { REPORT_FILE };
+    file << "scene,frame_avg_ms,frame_p99_ms,render_avg_ms,render_p99_ms,vertices,indices,draw_commands\n";
+
+    for (const auto& report : reports) {
+        file << report.name << ',' << to_milliseconds(report.frame.avg) << ',' << to_milliseconds(report.frame.p99) << ','
+             << to_milliseconds(report.render.avg) << ',' << to_milliseconds(report.render.p99) << ','
+             << report.counters.vertices << ',' << report.counters.indices << ',' << report.counters.draw_commands << '\n';
+        std::printf("%-24s frame avg %.3f ms, p99 %.3f ms | render avg %.3f ms, p99 %.3f ms | %zu vertices, %zu draw commands\n",
+            report.name.c_str(),
+            to_milliseconds(report.frame.avg), to_milliseconds(report.frame.p99),
+            to_milliseconds(report.render.avg), to_milliseconds(report.render.p99),
+            report.counters.vertices, report.counters.draw_commands);
+    }
+}
+
+}
+
+// Set UXX_UPDATE_GOLDEN=1 to replace the golden images with the rendered ones after an intended change.
+// Frame times and vertex counts of every scene are written to golden_report.csv.
+TEST_CASE("Demo tabs match their golden images", "[golden]")
+{
+    const bool update = nullptr != std::getenv("UXX_UPDATE_GOLDEN");
+    std::vector<scene_report> reports {};
+    std::filesystem::create_directories(OUTPUT_DIRECTORY);
+
+    for (const auto& tab : get_graphics_demo_tabs()) {
+        if (tab.uses_textures) {
+            continue;
+        }
+        const auto name = get_scene_name(tab.label);
+        const auto output = OUTPUT_DIRECTORY / (name + ".png");
+        const auto golden = GOLDEN_DIRECTORY / (name + ".png");
+        INFO("Scene " << name << ", rendered to " << output.string());
+
+        reports.push_back(render_scene(tab, output));
+
+        if (update) {
+            std::filesystem::copy_file(output, golden, std::filesystem::copy_options::overwrite_existing);
+            continue;
+        }
+        sf::Image expected {};
+        sf::Image actual {};
+        REQUIRE(expected.loadFromFile(golden.string()));
+        REQUIRE(actual.loadFromFile(output.string()));
+        REQUIRE(actual.getSize() == expected.getSize());
+
+        const auto differing = count_differing_pixels(actual, expected);
+        CHECK(static_cast<double>(differing) <= MAX_DIFFERING_PIXELS * WIDTH * HEIGHT);
+    }
+    write_report(reports);
+}
@@ -0,0 +1,41 @@
+#include "test.hpp"
+#include "uxx/uxx.hpp"
+
+using namespace std::chrono_literals;
+using headless = uxx::app::headless;
+
+TEST_CASE("Headless run stops after a fixed number of frames", "[headless]")
+{
+    const auto mode = headless::frames(3);
+    REQUIRE_FALSE(mode.is_done(0));
+    REQUIRE_FALSE(mode.is_done(2));
+    REQUIRE(mode.is_done(3));
+    REQUIRE(mode.get_delta_time() == headless::DEFAULT_DELTA_TIME);
+}
+
+TEST_CASE("Headless run stops when predicate is met", "[headless]")
+{
+    bool finished = false;
+    const auto mode = headless::until([&finished](std::uint64_t) { return finished; });
+    REQUIRE_FALSE(mode.is_done(100));
+    finished = true;
+    REQUIRE(mode.is_done(0));
+}
+
+TEST_CASE("Headless delta time is configurable", "[headless]")
+{
+    const auto mode = headless::frames(1).set_delta_time(1ms);
+    REQUIRE(mode.get_delta_time() == 1ms);
+}
+
+TEST_CASE("Headless run replays no input by default", "[headless]")
+{
+    REQUIRE(headless::frames(1).get_input_replay().empty());
+    REQUIRE(headless::frames(1).set_input_replay("pan.uxxin").get_input_replay() == "pan.uxxin");
+}
+
+TEST_CASE("Headless run saves no image by default", "[headless]")
+{
+    REQUIRE(headless::frames(1).get_output_image().empty());
+    REQUIRE(headless::frames(1).set_output_image("frame.png").get_output_image() == "frame.png");
+}
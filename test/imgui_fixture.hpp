@@ -0,0 +1,119 @@
+#ifndef _UXX_IMGUI_FIXTURE_HPP
+#define _UXX_IMGUI_FIXTURE_HPP
+
+#include "common.hpp"
+
+#include <cmath>
+#include <functional>
+
+namespace uxx::test {
+
+/// Minimal ImGui context that builds frames without a window or a renderer. The font atlas is built as RGBA pixels
+/// and is its own texture id.
+class imgui_context {
+public:
+    explicit imgui_context(const ImVec2& display_size = ImVec2 { 800.0f, 600.0f }, const ImGuiBackendFlags backend_flags = ImGuiBackendFlags_None)
+        : _context { ImGui::CreateContext() }
+    {
+        auto& io = ImGui::GetIO();
+        io.IniFilename = nullptr;
+        io.DisplaySize = display_size;
+        io.DeltaTime = 1.0f / 60.0f;
+        io.BackendFlags |= backend_flags;
+
+        unsigned char* pixels = nullptr;
+        int width = 0;
+        int height = 0;
+        io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+        io.Fonts->TexID = io.Fonts;
+    }
+
+    ~imgui_context()
+    {
+        ImGui::DestroyContext(_context);
+    }
+
+    imgui_context(const imgui_context&) = delete;
+    imgui_context(imgui_context&&) = delete;
+    imgui_context& operator=(const imgui_context&) = delete;
+    imgui_context& operator=(imgui_context&&) = delete;
+
+    /// Build a frame that draws on the foreground draw list.
+    /// \return The draw data of the frame, valid until the next one is built.
+    ImDrawData& build(const std::function<void(ImDrawList&)>& draw) const
+    {
+        ImGui::NewFrame();
+        draw(*ImGui::GetForegroundDrawList());
+        ImGui::Render();
+        return *ImGui::GetDrawData();
+    }
+
+    /// Hand the font atlas to a renderer that takes textures as RGBA pixels, like the software renderer.
+    template <typename R>
+    void register_font_atlas(R& renderer) const
+    {
+        auto& io = ImGui::GetIO();
+        unsigned char* pixels = nullptr;
+        int width = 0;
+        int height = 0;
+        io.Fonts->GetTexDataAsRGBA32(&pixels, &width, &height);
+        renderer.set_texture(io.Fonts->TexID, static_cast<unsigned int>(width), static_cast<unsigned int>(height), pixels);
+    }
+
+private:
+    ImGuiContext* _context;
+};
+
+/// ImGui context in the middle of a frame, for tests that draw on its draw lists directly.
+class imgui_frame : public imgui_context {
+public:
+    explicit imgui_frame(const ImGuiBackendFlags backend_flags = ImGuiBackendFlags_None)
+        : imgui_context { ImVec2 { 1920.0f, 1080.0f }, backend_flags }
+    {
+        ImGui::NewFrame();
+    }
+};
+
+/// \return True if every index of every command addresses a vertex of the draw list, and the commands use every index.
+[[nodiscard]] inline bool has_valid_indices(const ImDrawList& draw_list)
+{
+    unsigned int index_count = 0;
+
+    for (const auto& command : draw_list.CmdBuffer) {
+        for (unsigned int i = 0; i < command.ElemCount; ++i) {
+            const auto vertex = command.VtxOffset + draw_list.IdxBuffer[static_cast<int>(command.IdxOffset + i)];
+
+            if (vertex >= static_cast<unsigned int>(draw_list.VtxBuffer.Size)) {
+                return false;
+            }
+        }
+        index_count += command.ElemCount;
+    }
+    return index_count == static_cast<unsigned int>(draw_list.IdxBuffer.Size);
+}
+
+/// \return True if both draw lists have the same vertices and indices, with positions apart by at most the tolerance.
+[[nodiscard]] inline bool has_same_geometry(const ImDrawList& a, const ImDrawList& b, const float tolerance = 0.0f)
+{
+    if (a.VtxBuffer.Size != b.VtxBuffer.Size || a.IdxBuffer.Size != b.IdxBuffer.Size) {
+        return false;
+    }
+    for (int i = 0; i < a.VtxBuffer.Size; ++i) {
+        const auto& u = a.VtxBuffer[i];
+        const auto& v = b.VtxBuffer[i];
+
+        if (std::abs(u.pos.x - v.pos.x) > tolerance || std::abs(u.pos.y - v.pos.y) > tolerance || u.uv.x != v.uv.x || u.uv.y != v.uv.y || u.col != v.col) {
+            return false;
+        }
+    }
+    for (int i = 0; i < a.IdxBuffer.Size; ++i) {
+        if (a.IdxBuffer[i] != b.IdxBuffer[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+#endif
@@ -0,0 +1,75 @@
+#include "test.hpp"
+#include "input_recording.hpp"
+
+#include <sstream>
+
+using uxx::detail::recorded_event;
+
+namespace {
+
+recorded_event round_trip(const recorded_event& e)
+{
+    std::stringstream stream {};
+    REQUIRE(uxx::detail::write_event(stream, e));
+    recorded_event result {};
+    REQUIRE(uxx::detail::read_event(stream, result));
+    REQUIRE(result.frame_index == e.frame_index);
+    REQUIRE(result.timestamp == e.timestamp);
+    REQUIRE(result.event.type == e.event.type);
+    return result;
+}
+
+}
+
+TEST_CASE("Mouse events survive a recording round trip", "[input_recording]")
+{
+    recorded_event e { 42, std::chrono::microseconds { 1234 }, {} };
+    e.event.type = sf::Event::MouseButtonPressed;
+    e.event.mouseButton = { sf::Mouse::Right, 10, -20 };
+
+    const auto button = round_trip(e).event.mouseButton;
+    REQUIRE(button.button == sf::Mouse::Right);
+    REQUIRE(button.x == 10);
+    REQUIRE(button.y == -20);
+
+    e.event.type = sf::Event::MouseWheelScrolled;
+    e.event.mouseWheelScroll = { sf::Mouse::VerticalWheel, 0.1f, 3, 4 };
+
+    const auto wheel = round_trip(e).event.mouseWheelScroll;
+    REQUIRE(wheel.wheel == sf::Mouse::VerticalWheel);
+    REQUIRE(wheel.delta == 0.1f);
+    REQUIRE(wheel.x == 3);
+    REQUIRE(wheel.y == 4);
+}
+
+TEST_CASE("Keyboard events survive a recording round trip", "[input_recording]")
+{
+    recorded_event e { 7, std::chrono::microseconds { 99 }, {} };
+    e.event.type = sf::Event::KeyPressed;
+    e.event.key = { sf::Keyboard::Z, false, true, false, false };
+
+    const auto key = round_trip(e).event.key;
+    REQUIRE(key.code == sf::Keyboard::Z);
+    REQUIRE(key.control);
+    REQUIRE_FALSE(key.shift);
+
+    e.event.type = sf::Event::TextEntered;
+    e.event.text.unicode = 0x263A;
+    REQUIRE(round_trip(e).event.text.unicode == 0x263A);
+}
+
+TEST_CASE("Joystick events are not recorded", "[input_recording]")
+{
+    recorded_event e { 0, std::chrono::microseconds { 0 }, {} };
+    e.event.type = sf::Event::JoystickConnected;
+    std::stringstream stream {};
+    REQUIRE_FALSE(uxx::detail::write_event(stream, e));
+    REQUIRE(stream.str().empty());
+}
+
+TEST_CASE("Malformed recording lines are rejected", "[input_recording]")
+{
+    std::stringstream stream { "3 100 9 1\n" };
+    recorded_event e {};
+    REQUIRE_THROWS_AS(uxx::detail::read_event(stream, e), std::runtime_error);
+}
@@ -0,0 +1,109 @@
+#include "test.hpp"
+#include "uxx/uxx.hpp"
+
+#include <functional>
+#include <vector>
+
+namespace {
+
+/// Run a single headless frame that draws on the foreground with a pencil.
+/// \return The report of the frame.
+[[nodiscard]] uxx::app::frame_report draw_frame(const std::function<void(uxx::pencil&)>& draw)
+{
+    uxx::app app { uxx::app::renderer::software };
+    app.set_width(1024);
+    app.set_height(600);
+    app.set_font_cache_directory({});
+
+    const auto exit_code = app.run_headless(uxx::app::headless::frames(1), [&draw](uxx::screen& screen) {
+        screen.window("Pencil", [&draw](uxx::pane& pane) {
+            auto pencil = pane.create_pencil_foreground();
+            draw(pencil);
+        });
+    });
+    REQUIRE(exit_code == 0);
+    return app.get_last_frame_report();
+}
+
+/// \return True if the draw commands of the frame are split so that none of them addresses more than 64k vertices.
+[[nodiscard]] bool is_split_for_16bit_indices(const uxx::app::frame_report& report)
+{
+    return report.counters.vertices > 0xFFFF && report.counters.draw_commands > report.counters.vertices / 0x10000;
+}
+
+}
+
+TEST_CASE("A 1M point polyline drawn with a pencil is split into commands of 64k vertices with 16-bit indices", "[pencil]")
+{
+    std::vector<uxx::vec2d> points(1'000'000);
+
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        points[i] = { 10.0f + static_cast<float>(i % 1000), i % 2 == 0 ? 100.0f : 150.0f };
+    }
+    const auto report = draw_frame([&points](uxx::pencil& pencil) { pencil.draw_polyline(points, false); });
+
+    if constexpr (sizeof(ImDrawIdx) == 2) {
+        REQUIRE(is_split_for_16bit_indices(report));
+    } else {
+        REQUIRE(report.counters.vertices > 0xFFFF);
+    }
+}
+
+TEST_CASE("Bulk primitives drawn with a pencil are split into commands of 64k vertices with 16-bit indices", "[pencil]")
+{
+    const auto primitive = GENERATE(0, 1, 2);
+    std::vector<uxx::segment> segments(100'000);
+
+    for (std::size_t i = 0; i < segments.size(); ++i) {
+        const auto x = 10.0f + static_cast<float>(i % 1000);
+        const auto y = 10.0f + static_cast<float>(i % 500);
+        segments[i] = { { x, y }, { x + 5.0f, y + 7.0f } };
+    }
+    const auto report = draw_frame([&](uxx::pencil& pencil) {
+        if (primitive == 0) {
+            pencil.draw_lines(segments);
+        } else if (primitive == 1) {
+            std::vector<uxx::rect> rects {};
+
+            for (const auto& s : segments) {
+                rects.push_back({ s.from, s.to });
+            }
+            pencil.draw_rects_filled(rects);
+        } else {
+            std::vector<uxx::triangle> triangles {};
+
+            for (const auto& s : segments) {
+                triangles.push_back({ s.from, s.to, { s.from.x, s.to.y } });
+            }
+            pencil.draw_triangles_filled(triangles);
+        }
+    });
+
+    if constexpr (sizeof(ImDrawIdx) == 2) {
+        REQUIRE(is_split_for_16bit_indices(report));
+    } else {
+        REQUIRE(report.counters.vertices > 0xFFFF);
+    }
+}
+
+TEST_CASE("A drawing of more than 64k vertices replayed with a pencil is split into commands with 16-bit indices", "[pencil]")
+{
+    std::vector<uxx::vec2d> points(40'000);
+
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        points[i] = { 10.0f + static_cast<float>(i % 1000), i % 2 == 0 ? 100.0f : 150.0f };
+    }
+    uxx::drawing drawing {};
+    // Replayed twice into a list that already holds the first copy
+    const auto report = draw_frame([&](uxx::pencil& pencil) {
+        drawing.record([&points](uxx::pencil& recording) { recording.draw_polyline(points, false); });
+        pencil.draw(drawing);
+        pencil.draw(drawing);
+    });
+
+    if constexpr (sizeof(ImDrawIdx) == 2) {
+        REQUIRE(is_split_for_16bit_indices(report));
+    } else {
+        REQUIRE(report.counters.vertices > 0xFFFF);
+    }
+}
@@ -0,0 +1,108 @@
+#include "test.hpp"
+#include "common.hpp"
+#include "polyline_lod.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Timestamps in seconds, far enough from zero that a float can't tell them apart
+constexpr double START_TIME { 1.7e9 };
+
+// Noisy samples across 1000 seconds
+[[nodiscard]] std::vector<uxx::plot_sample> create_samples(const std::size_t count)
+{
+    std::vector<uxx::plot_sample> samples(count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto t = static_cast<float>(i) / static_cast<float>(count);
+        samples[i] = { START_TIME + static_cast<double>(i) * 1000.0 / static_cast<double>(count), 300.0f + 200.0f * std::sin(t * 500.0f) + static_cast<float>(i * 7919 % 101) };
+    }
+    return samples;
+}
+
+// One pixel per unit, y from 0 to 1000 upwards
+[[nodiscard]] uxx::plot_view create_view(const double min_x, const double max_x, const float left)
+{
+    const auto width = static_cast<float>(max_x - min_x);
+    return { min_x, max_x, 0.0f, 1000.0f, { { left, 0.0f }, { left + width, 1000.0f } } };
+}
+
+}
+
+TEST_CASE("Samples are reduced to at most four per pixel column", "[polyline_lod]")
+{
+    const auto samples = create_samples(1'000'000);
+    const auto view = create_view(START_TIME, START_TIME + 1000.0, 100.0f);
+    ImVector<ImVec2> reduced {};
+    uxx::detail::reduce_to_columns(samples, view, reduced);
+
+    REQUIRE(reduced.Size <= 4 * 1000);
+    REQUIRE(reduced.Size >= 2 * 1000);
+    REQUIRE(reduced.front().x == 100.0f);
+    REQUIRE(reduced.back().x == Approx(1100.0f));
+    REQUIRE(std::is_sorted(reduced.begin(), reduced.end(), [](const ImVec2& a, const ImVec2& b) { return a.x < b.x; }));
+
+    // Every column keeps its extremes, mapped to the screen
+    const auto column = [](const uxx::plot_sample& p) { return std::floor(p.x - START_TIME); };
+    bool extremes_kept = true;
+
+    for (auto first = samples.begin(); first != samples.end();) {
+        const auto end = std::find_if(first, samples.end(), [&](const uxx::plot_sample& p) { return column(p) != column(*first); });
+        const auto [lowest, highest] = std::minmax_element(first, end, [](const uxx::plot_sample& a, const uxx::plot_sample& b) { return a.y < b.y; });
+        const auto kept = [&](const uxx::plot_sample& p) {
+            const auto x = 100.0f + static_cast<float>(p.x - START_TIME);
+            return std::find_if(reduced.begin(), reduced.end(), [&](const ImVec2& r) { return std::abs(r.x - x) < 0.01f && r.y == 1000.0f - p.y; }) != reduced.end();
+        };
+        extremes_kept = extremes_kept && kept(*lowest) && kept(*highest);
+        first = end;
+    }
+    REQUIRE(extremes_kept);
+}
+
+TEST_CASE("Samples outside the x-range are dropped but for the nearest ones", "[polyline_lod]")
+{
+    const std::vector<uxx::plot_sample> samples { { 0.0, 0.0f }, { 1.0, 1.0f }, { 5.0, 5.0f }, { 5.5, 2.0f }, { 9.0, 9.0f }, { 12.0, 12.0f } };
+    ImVector<ImVec2> reduced {};
+    uxx::detail::reduce_to_columns(samples, create_view(4.0, 8.0, 0.0f), reduced);
+
+    REQUIRE(reduced.Size == 4);
+    REQUIRE(reduced[0].x == -3.0f);
+    REQUIRE(reduced[1].x == 1.0f);
+    REQUIRE(reduced[2].x == 1.5f);
+    REQUIRE(reduced[3].x == 5.0f);
+    REQUIRE(reduced[3].y == 991.0f);
+}
+
+TEST_CASE("Samples of timestamps far from zero keep their columns", "[polyline_lod]")
+{
+    // A millisecond per pixel
+    std::vector<uxx::plot_sample> samples(2000);
+
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = { START_TIME + static_cast<double>(i) * 0.001, static_cast<float>(i % 2) };
+    }
+    const uxx::plot_view view { START_TIME, START_TIME + 2.0, 0.0f, 1.0f, { { 0.0f, 0.0f }, { 2000.0f, 100.0f } } };
+    ImVector<ImVec2> reduced {};
+    uxx::detail::reduce_to_columns(samples, view, reduced);
+
+    REQUIRE(reduced.Size == 2000);
+    REQUIRE(std::adjacent_find(reduced.begin(), reduced.end(), [](const ImVec2& a, const ImVec2& b) { return !(a.x < b.x); }) == reduced.end());
+}
+
+TEST_CASE("Sparse samples are kept as they are", "[polyline_lod]")
+{
+    const std::vector<uxx::plot_sample> samples { { 0.0, 0.0f }, { 10.0, 1.0f }, { 20.0, 5.0f } };
+    ImVector<ImVec2> reduced {};
+    uxx::detail::reduce_to_columns(samples, create_view(0.0, 20.0, 0.0f), reduced);
+
+    REQUIRE(reduced.Size == 3);
+
+    uxx::detail::reduce_to_columns({}, create_view(0.0, 20.0, 0.0f), reduced);
+    REQUIRE(reduced.Size == 0);
+
+    uxx::detail::reduce_to_columns(samples, create_view(5.0, 5.0, 0.0f), reduced);
+    REQUIRE(reduced.Size == 0);
+}
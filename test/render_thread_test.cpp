@@ -0,0 +1,132 @@
+#include "test.hpp"
+#include "render_thread.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// A draw list with one triangle, its vertices numbered from 'first'
+void fill_list(ImDrawList& list, const float first)
+{
+    list.CmdBuffer.clear();
+    list.IdxBuffer.clear();
+    list.VtxBuffer.clear();
+
+    for (int i = 0; i < 3; ++i) {
+        ImDrawVert vertex {};
+        vertex.pos = ImVec2 { first + static_cast<float>(i), 0.0f };
+        list.VtxBuffer.push_back(vertex);
+        list.IdxBuffer.push_back(static_cast<ImDrawIdx>(i));
+    }
+    ImDrawCmd command {};
+    command.ElemCount = 3;
+    command.ClipRect = ImVec4 { 0.0f, 0.0f, 100.0f, 100.0f };
+    list.CmdBuffer.push_back(command);
+}
+
+class test_frame {
+public:
+    explicit test_frame(const float first)
+        : _list { nullptr }
+    {
+        fill_list(_list, first);
+        _draw_data.Valid = true;
+        _draw_data.CmdLists = _lists.data();
+        _draw_data.CmdListsCount = 1;
+        _draw_data.TotalVtxCount = 3;
+        _draw_data.TotalIdxCount = 3;
+        _draw_data.DisplaySize = ImVec2 { 100.0f, 100.0f };
+    }
+
+    [[nodiscard]] const ImDrawData& get() const noexcept
+    {
+        return _draw_data;
+    }
+
+    ImDrawList& get_list() noexcept
+    {
+        return _list;
+    }
+
+private:
+    ImDrawList _list;
+    std::vector<ImDrawList*> _lists { &_list };
+    ImDrawData _draw_data {};
+};
+
+}
+
+TEST_CASE("A draw data copy outlives the draw lists it was copied from", "[render_thread]")
+{
+    uxx::detail::draw_data_copy copy {};
+    {
+        test_frame frame { 10.0f };
+        copy.assign(frame.get());
+        fill_list(frame.get_list(), 20.0f);
+    }
+    const auto& draw_data = copy.get();
+
+    REQUIRE(draw_data.CmdListsCount == 1);
+    REQUIRE(draw_data.TotalVtxCount == 3);
+    REQUIRE(draw_data.DisplaySize.x == 100.0f);
+    REQUIRE(draw_data.CmdLists[0]->VtxBuffer.Size == 3);
+    REQUIRE(draw_data.CmdLists[0]->VtxBuffer[2].pos.x == 12.0f);
+    REQUIRE(draw_data.CmdLists[0]->CmdBuffer[0].ElemCount == 3);
+}
+
+TEST_CASE("Copying a smaller frame reuses the draw lists", "[render_thread]")
+{
+    uxx::detail::draw_data_copy copy {};
+    test_frame frame { 0.0f };
+    copy.assign(frame.get());
+    const auto* list = copy.get().CmdLists[0];
+
+    ImDrawData empty {};
+    copy.assign(empty);
+    REQUIRE(copy.get().CmdListsCount == 0);
+
+    copy.assign(frame.get());
+    REQUIRE(copy.get().CmdLists[0] == list);
+}
+
+TEST_CASE("The render thread renders every submitted frame in order", "[render_thread]")
+{
+    std::vector<float> rendered {};
+    int activations = 0;
+    {
+        uxx::detail::render_thread thread {
+            [&rendered](ImDrawData& draw_data, bool) {
+                rendered.push_back(draw_data.CmdLists[0]->VtxBuffer[0].pos.x);
+                return rendered.size();
+            },
+            [&activations](const bool active) { activations += active ? 1 : -1; }
+        };
+
+        for (int i = 0; i < 10; ++i) {
+            const test_frame frame { static_cast<float>(i) };
+            // The previous frame is done when the next one is submitted
+            REQUIRE(thread.submit(frame.get(), false) == static_cast<std::size_t>(i));
+        }
+        thread.finish();
+        REQUIRE(rendered.size() == 10);
+    }
+    REQUIRE(activations == 0);
+
+    for (std::size_t i = 0; i < rendered.size(); ++i) {
+        REQUIRE(rendered[i] == static_cast<float>(i));
+    }
+}
+
+TEST_CASE("Errors of the render thread are rethrown on the submitting thread", "[render_thread]")
+{
+    uxx::detail::render_thread thread {
+        [](ImDrawData&, bool) -> std::size_t { throw std::runtime_error("lost context"); },
+        [](bool) {}
+    };
+    const test_frame frame { 0.0f };
+    thread.submit(frame.get(), false);
+
+    REQUIRE_THROWS_AS(thread.finish(), std::runtime_error);
+    REQUIRE_NOTHROW(thread.finish());
+}
@@ -0,0 +1,113 @@
+#include "test.hpp"
+#include "common.hpp"
+#include "imgui_fixture.hpp"
+#include "retained_geometry.hpp"
+
+#include <vector>
+
+namespace {
+
+// A draw list to record into, like uxx::drawing uses, with the flags ImGui chose for the frame
+class recording {
+public:
+    recording()
+    {
+        list._ResetForNewFrame();
+        list.PushTextureID(ImGui::GetIO().Fonts->TexID);
+        list.PushClipRectFullScreen();
+    }
+
+    ImDrawList list { ImGui::GetDrawListSharedData() };
+};
+
+}
+
+TEST_CASE("Retained geometry is appended scaled and translated", "[retained_geometry]")
+{
+    const uxx::test::imgui_frame frame { ImGuiBackendFlags_RendererHasVtxOffset };
+    recording r {};
+    r.list.AddTriangleFilled({ 10.0f, 10.0f }, { 20.0f, 10.0f }, { 10.0f, 20.0f }, IM_COL32_WHITE);
+    uxx::detail::retained_geometry geometry {};
+    geometry.assign(r.list);
+
+    auto& draw_list = *ImGui::GetForegroundDrawList();
+    draw_list.AddRectFilled({ 0.0f, 0.0f }, { 5.0f, 5.0f }, IM_COL32_WHITE);
+    const auto existing = draw_list.VtxBuffer.Size;
+    geometry.append_to(draw_list, { 100.0f, 50.0f }, 2.0f);
+
+    REQUIRE(draw_list.VtxBuffer.Size == existing + r.list.VtxBuffer.Size);
+    REQUIRE(draw_list.IdxBuffer.Size == 6 + r.list.IdxBuffer.Size);
+
+    for (int i = 0; i < r.list.VtxBuffer.Size; ++i) {
+        const auto& source = r.list.VtxBuffer[i];
+        const auto& appended = draw_list.VtxBuffer[existing + i];
+        REQUIRE(appended.pos.x == source.pos.x * 2.0f + 100.0f);
+        REQUIRE(appended.pos.y == source.pos.y * 2.0f + 50.0f);
+        REQUIRE(appended.col == source.col);
+    }
+    // The indices count from the first appended vertex
+    for (int i = 0; i < r.list.IdxBuffer.Size; ++i) {
+        REQUIRE(static_cast<int>(draw_list.IdxBuffer[6 + i]) == static_cast<int>(r.list.IdxBuffer[i]) + existing);
+    }
+}
+
+TEST_CASE("Retained geometry of more than 64k vertices keeps its indices valid", "[retained_geometry]")
+{
+    const uxx::test::imgui_frame frame { ImGuiBackendFlags_RendererHasVtxOffset };
+    recording r {};
+    std::vector<ImVec2> points(40'000);
+
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        points[i] = ImVec2 { static_cast<float>(i % 1900), static_cast<float>(i % 1000) };
+    }
+    // Every point takes two vertices of a textured line, over several vertex offsets with 16-bit indices
+    for (std::size_t first = 0; first < points.size(); first += 10'000) {
+        r.list.AddPolyline(points.data() + first, 10'000, IM_COL32_WHITE, false, 2.0f);
+    }
+    uxx::detail::retained_geometry geometry {};
+    geometry.assign(r.list);
+
+    auto& draw_list = *ImGui::GetForegroundDrawList();
+    geometry.append_to(draw_list, { 0.0f, 0.0f }, 1.0f);
+    geometry.append_to(draw_list, { 0.0f, 0.0f }, 1.0f);
+    ImGui::Render();
+
+    REQUIRE(geometry.get_vertex_count() == 80'000);
+    REQUIRE(static_cast<std::size_t>(draw_list.VtxBuffer.Size) == 2 * geometry.get_vertex_count());
+    REQUIRE(uxx::test::has_valid_indices(draw_list));
+}
+
+TEST_CASE("Cleared geometry appends nothing", "[retained_geometry]")
+{
+    const uxx::test::imgui_frame frame { ImGuiBackendFlags_RendererHasVtxOffset };
+    recording r {};
+    r.list.AddRectFilled({ 0.0f, 0.0f }, { 5.0f, 5.0f }, IM_COL32_WHITE);
+    uxx::detail::retained_geometry geometry {};
+    geometry.assign(r.list);
+    REQUIRE_FALSE(geometry.is_empty());
+
+    geometry.clear();
+    auto& draw_list = *ImGui::GetForegroundDrawList();
+    geometry.append_to(draw_list, { 0.0f, 0.0f }, 1.0f);
+
+    REQUIRE(geometry.is_empty());
+    REQUIRE(draw_list.VtxBuffer.Size == 0);
+}
+
+TEST_CASE("Retained geometry outside the clip rectangle is left out", "[retained_geometry]")
+{
+    const uxx::test::imgui_frame frame { ImGuiBackendFlags_RendererHasVtxOffset };
+    recording r {};
+    r.list.AddRectFilled({ 0.0f, 0.0f }, { 50.0f, 50.0f }, IM_COL32_WHITE);
+    uxx::detail::retained_geometry geometry {};
+    geometry.assign(r.list);
+
+    auto& draw_list = *ImGui::GetForegroundDrawList();
+    draw_list.PushClipRect({ 100.0f, 100.0f }, { 200.0f, 200.0f });
+
+    REQUIRE(geometry.append_to(draw_list, { 0.0f, 0.0f }, 1.0f) == 1);
+    REQUIRE(draw_list.VtxBuffer.Size == 0);
+    // Translated and scaled into view
+    REQUIRE(geometry.append_to(draw_list, { 190.0f, 190.0f }, -1.0f) == 0);
+    REQUIRE(draw_list.VtxBuffer.Size == r.list.VtxBuffer.Size);
+}
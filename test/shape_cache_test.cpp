@@ -0,0 +1,128 @@
+#include "test.hpp"
+#include "common.hpp"
+#include "draw_list.hpp"
+#include "imgui_fixture.hpp"
+#include "shape_cache.hpp"
+
+#include <array>
+#include <cmath>
+
+TEST_CASE("Polygons are computed once per number of corners", "[shape_cache]")
+{
+    uxx::detail::shape_cache cache {};
+    const auto& hexagon = cache.get_polygon(6);
+
+    REQUIRE(&hexagon == &cache.get_polygon(6));
+    REQUIRE(hexagon.corners.size() == 6);
+    REQUIRE(hexagon.corners[0].x == Approx(1.0f));
+    REQUIRE(hexagon.corners[3].x == Approx(-1.0f));
+
+    for (const auto& corner : hexagon.corners) {
+        REQUIRE(std::hypot(corner.x, corner.y) == Approx(1.0f));
+    }
+    // An offset of one along the miter normal is one away from the edges, which meet at 120 degrees
+    const auto& n = hexagon.corner_normals[0];
+    REQUIRE(std::hypot(n.x, n.y) == Approx(1.0f / std::cos(3.14159265f / 6.0f)));
+}
+
+TEST_CASE("Circle segments grow with the radius", "[shape_cache]")
+{
+    uxx::detail::shape_cache cache {};
+
+    REQUIRE(cache.get_circle_segments(0.5f, 1.6f) == uxx::detail::shape_cache::MIN_CIRCLE_SEGMENTS);
+    REQUIRE(cache.get_circle_segments(100.0f, 1.6f) == 35);
+    REQUIRE(cache.get_circle_segments(100.7f, 1.6f) == 35);
+    REQUIRE(cache.get_circle_segments(100'000.0f, 1.6f) == uxx::detail::shape_cache::MAX_CIRCLE_SEGMENTS);
+    // A smaller error takes more segments, the cached counts of the previous error don't apply
+    REQUIRE(cache.get_circle_segments(100.0f, 0.5f) > 35);
+}
+
+TEST_CASE("Bezier curves take more segments the more they bend", "[shape_cache]")
+{
+    uxx::detail::shape_cache cache {};
+    const ImVec2 start { 0.0f, 0.0f };
+    const ImVec2 end { 300.0f, 0.0f };
+
+    REQUIRE(uxx::detail::shape_cache::get_bezier_segments(start, { 100.0f, 0.0f }, { 200.0f, 0.0f }, end, 1.25f) == 1);
+    REQUIRE(uxx::detail::shape_cache::get_bezier_segments(start, { 100.0f, 50.0f }, { 200.0f, -50.0f }, end, 1.25f)
+        < uxx::detail::shape_cache::get_bezier_segments(start, { 100.0f, 500.0f }, { 200.0f, -500.0f }, end, 1.25f));
+
+    const auto weights = cache.get_bezier_weights(10);
+    REQUIRE(weights.size() == 10);
+    REQUIRE(weights.back()[3] == 1.0f);
+
+    for (const auto& w : weights) {
+        REQUIRE(w[0] + w[1] + w[2] + w[3] == Approx(1.0f));
+    }
+}
+
+TEST_CASE("Cached circles have the geometry of ImGui's circles", "[shape_cache]")
+{
+    const uxx::test::imgui_frame frame { ImGuiBackendFlags_None };
+    const auto flags = GENERATE(ImDrawListFlags_None, ImDrawListFlags_AntiAliasedLines | ImDrawListFlags_AntiAliasedFill);
+    const auto thickness = GENERATE(1.0f, 3.0f);
+    // ImGui draws circles of 12 segments from a table of its own
+    constexpr int SEGMENTS { 20 };
+    auto& imgui = *ImGui::GetBackgroundDrawList();
+    auto& cached = *ImGui::GetForegroundDrawList();
+    imgui.Flags = flags;
+    cached.Flags = flags;
+
+    imgui.AddCircle({ 300.0f, 200.0f }, 50.0f, IM_COL32_WHITE, SEGMENTS, thickness);
+    imgui.AddCircleFilled({ 300.0f, 200.0f }, 50.0f, IM_COL32_WHITE, SEGMENTS);
+    imgui.AddNgon({ 100.0f, 100.0f }, 30.0f, IM_COL32_WHITE, 5, thickness);
+
+    uxx::detail::shape_cache cache {};
+    const auto& circle = cache.get_polygon(SEGMENTS);
+    uxx::detail::add_polygon(cached, circle, { 300.0f, 200.0f }, 49.5f, IM_COL32_WHITE, thickness);
+    uxx::detail::add_polygon_filled(cached, circle, { 300.0f, 200.0f }, 50.0f, IM_COL32_WHITE);
+    uxx::detail::add_polygon(cached, cache.get_polygon(5), { 100.0f, 100.0f }, 29.5f, IM_COL32_WHITE, thickness);
+
+    REQUIRE(uxx::test::has_same_geometry(imgui, cached, 0.001f));
+}
+
+TEST_CASE("Cached circles have the geometry of ImGui's circles with the flags of a new frame", "[shape_cache]")
+{
+    const uxx::test::imgui_frame frame { ImGuiBackendFlags_None };
+    const auto thickness = GENERATE(1.0f, 2.5f, 3.0f);
+    constexpr int SEGMENTS { 20 };
+    auto& imgui = *ImGui::GetBackgroundDrawList();
+    auto& cached = *ImGui::GetForegroundDrawList();
+
+    REQUIRE((cached.Flags & ImDrawListFlags_AntiAliasedLinesUseTex) != 0);
+    REQUIRE(imgui.Flags == cached.Flags);
+
+    imgui.AddCircle({ 300.0f, 200.0f }, 50.0f, IM_COL32_WHITE, SEGMENTS, thickness);
+    imgui.AddNgon({ 100.0f, 100.0f }, 30.0f, IM_COL32_WHITE, 5, thickness);
+
+    uxx::detail::shape_cache cache {};
+    uxx::detail::add_polygon(cached, cache.get_polygon(SEGMENTS), { 300.0f, 200.0f }, 49.5f, IM_COL32_WHITE, thickness);
+    uxx::detail::add_polygon(cached, cache.get_polygon(5), { 100.0f, 100.0f }, 29.5f, IM_COL32_WHITE, thickness);
+
+    REQUIRE(uxx::test::has_same_geometry(imgui, cached, 0.001f));
+}
+
+TEST_CASE("Cached bezier curves follow ImGui's curves", "[shape_cache]")
+{
+    const uxx::test::imgui_frame frame { ImGuiBackendFlags_None };
+    const std::array<ImVec2, 4> points { ImVec2 { 10.0f, 10.0f }, ImVec2 { 400.0f, 100.0f }, ImVec2 { -100.0f, 300.0f }, ImVec2 { 300.0f, 300.0f } };
+    auto& imgui = *ImGui::GetBackgroundDrawList();
+    auto& cached = *ImGui::GetForegroundDrawList();
+    imgui.Flags = ImDrawListFlags_AntiAliasedLines;
+    cached.Flags = ImDrawListFlags_AntiAliasedLines;
+
+    imgui.AddBezierCurve(points[0], points[1], points[2], points[3], IM_COL32_WHITE, 1.0f, 30);
+    uxx::detail::shape_cache cache {};
+    uxx::detail::add_bezier_curve(cached, cache, points, IM_COL32_WHITE, 1.0f, 30);
+
+    REQUIRE(uxx::test::has_same_geometry(imgui, cached, 0.001f));
+
+    // Chosen by the size of the curve, without a recursion per point
+    cached.Flags = ImDrawListFlags_None;
+    const auto before = cached.VtxBuffer.Size;
+    uxx::detail::add_bezier_curve(cached, cache, points, IM_COL32_WHITE, 1.0f, 0);
+    const auto segments = (cached.VtxBuffer.Size - before) / 4;
+
+    REQUIRE(segments > 10);
+    REQUIRE(segments < 60);
+}
@@ -0,0 +1,126 @@
+#include "test.hpp"
+#include "common.hpp"
+#include "imgui_fixture.hpp"
+#include "software_renderer.hpp"
+
+#include <array>
+
+namespace {
+
+constexpr unsigned int WIDTH { 300 };
+constexpr unsigned int HEIGHT { 200 };
+
+using rgba = std::array<std::uint8_t, 4>;
+
+const ImVec2 DISPLAY_SIZE { static_cast<float>(WIDTH), static_cast<float>(HEIGHT) };
+
+[[nodiscard]] rgba get_pixel(const uxx::detail::software_renderer& renderer, const unsigned int x, const unsigned int y)
+{
+    const auto pixels = renderer.get_pixels();
+    const auto offset = (std::size_t { y } * renderer.get_width() + x) * 4;
+    return { pixels[offset], pixels[offset + 1], pixels[offset + 2], pixels[offset + 3] };
+}
+
+void draw_shapes(ImDrawList& draw_list)
+{
+    draw_list.AddRectFilled(ImVec2 { 10.0f, 10.0f }, ImVec2 { 290.0f, 190.0f }, IM_COL32(30, 60, 90, 255), 12.0f);
+    draw_list.AddCircleFilled(ImVec2 { 150.0f, 100.0f }, 70.0f, IM_COL32(255, 128, 0, 160), 48);
+    draw_list.AddLine(ImVec2 { 0.0f, 0.0f }, ImVec2 { 300.0f, 200.0f }, IM_COL32_WHITE, 3.0f);
+    draw_list.AddText(ImVec2 { 20.0f, 20.0f }, IM_COL32_WHITE, "Software rasterizer");
+}
+
+}
+
+TEST_CASE("Rasterizes filled shapes and clears the rest to opaque black", "[software_renderer]")
+{
+    uxx::detail::software_renderer renderer { 2 };
+    const uxx::test::imgui_context context { DISPLAY_SIZE };
+    context.register_font_atlas(renderer);
+    renderer.render(context.build([](ImDrawList& draw_list) {
+        draw_list.AddRectFilled(ImVec2 { 100.0f, 50.0f }, ImVec2 { 200.0f, 150.0f }, IM_COL32(255, 0, 0, 255));
+    }));
+
+    REQUIRE(renderer.get_width() == WIDTH);
+    REQUIRE(renderer.get_height() == HEIGHT);
+    REQUIRE(get_pixel(renderer, 100, 50) == rgba { 255, 0, 0, 255 });
+    REQUIRE(get_pixel(renderer, 199, 149) == rgba { 255, 0, 0, 255 });
+    REQUIRE(get_pixel(renderer, 99, 100) == rgba { 0, 0, 0, 255 });
+    REQUIRE(get_pixel(renderer, 200, 100) == rgba { 0, 0, 0, 255 });
+    REQUIRE(get_pixel(renderer, 150, 150) == rgba { 0, 0, 0, 255 });
+}
+
+TEST_CASE("Triangles that share an edge blend every pixel once", "[software_renderer]")
+{
+    uxx::detail::software_renderer renderer { 1 };
+    const uxx::test::imgui_context context { DISPLAY_SIZE };
+    context.register_font_atlas(renderer);
+    // A rectangle is two triangles that share a diagonal, double blending would show along it
+    renderer.render(context.build([](ImDrawList& draw_list) {
+        draw_list.AddRectFilled(ImVec2 { 0.0f, 0.0f }, ImVec2 { 300.0f, 200.0f }, IM_COL32(255, 255, 255, 128));
+    }));
+
+    for (unsigned int y = 0; y < HEIGHT; ++y) {
+        for (unsigned int x = 0; x < WIDTH; ++x) {
+            REQUIRE(get_pixel(renderer, x, y) == rgba { 128, 128, 128, 255 });
+        }
+    }
+}
+
+TEST_CASE("Clip rectangles limit the drawn pixels", "[software_renderer]")
+{
+    uxx::detail::software_renderer renderer { 1 };
+    const uxx::test::imgui_context context { DISPLAY_SIZE };
+    context.register_font_atlas(renderer);
+    renderer.render(context.build([](ImDrawList& draw_list) {
+        draw_list.PushClipRect(ImVec2 { 50.0f, 50.0f }, ImVec2 { 60.0f, 70.0f });
+        draw_list.AddRectFilled(ImVec2 { 0.0f, 0.0f }, ImVec2 { 300.0f, 200.0f }, IM_COL32(0, 255, 0, 255));
+        draw_list.PopClipRect();
+    }));
+
+    REQUIRE(get_pixel(renderer, 50, 50) == rgba { 0, 255, 0, 255 });
+    REQUIRE(get_pixel(renderer, 59, 69) == rgba { 0, 255, 0, 255 });
+    REQUIRE(get_pixel(renderer, 49, 50) == rgba { 0, 0, 0, 255 });
+    REQUIRE(get_pixel(renderer, 60, 60) == rgba { 0, 0, 0, 255 });
+    REQUIRE(get_pixel(renderer, 55, 70) == rgba { 0, 0, 0, 255 });
+}
+
+TEST_CASE("Text samples the font atlas texture", "[software_renderer]")
+{
+    uxx::detail::software_renderer renderer { 1 };
+    const uxx::test::imgui_context context { DISPLAY_SIZE };
+    context.register_font_atlas(renderer);
+    renderer.render(context.build([](ImDrawList& draw_list) {
+        draw_list.AddText(ImVec2 { 10.0f, 10.0f }, IM_COL32_WHITE, "ImGui");
+    }));
+    std::size_t lit = 0;
+    std::size_t unlit = 0;
+
+    for (unsigned int y = 10; y < 30; ++y) {
+        for (unsigned int x = 10; x < 60; ++x) {
+            (get_pixel(renderer, x, y)[0] > 128 ? lit : unlit) += 1;
+        }
+    }
+    REQUIRE(lit > 50);
+    REQUIRE(unlit > 50);
+}
+
+TEST_CASE("The image doesn't depend on the number of threads", "[software_renderer]")
+{
+    uxx::detail::software_renderer single_thread { 1 };
+    uxx::detail::software_renderer many_threads { 4 };
+    {
+        const uxx::test::imgui_context context { DISPLAY_SIZE };
+        context.register_font_atlas(single_thread);
+        single_thread.render(context.build(draw_shapes));
+    }
+    {
+        const uxx::test::imgui_context context { DISPLAY_SIZE };
+        context.register_font_atlas(many_threads);
+        many_threads.render(context.build(draw_shapes));
+    }
+    const auto a = single_thread.get_pixels();
+    const auto b = many_threads.get_pixels();
+
+    REQUIRE(a.size() == std::size_t { WIDTH } * HEIGHT * 4);
+    REQUIRE(std::equal(a.begin(), a.end(), b.begin(), b.end()));
+}
@@ -0,0 +1,29 @@
+#include "test.hpp"
+#include "common.hpp"
+#include "draw_list.hpp"
+#include "imgui_fixture.hpp"
+
+#include <vector>
+
+TEST_CASE("Strided points are gathered into the path of the draw list", "[strided_points]")
+{
+    struct sample {
+        double time;
+        float x;
+        float y;
+    };
+    const uxx::test::imgui_frame frame { ImGuiBackendFlags_None };
+    auto& draw_list = *ImGui::GetForegroundDrawList();
+    const std::vector<sample> samples { { 0.0, 1.0f, 2.0f }, { 0.5, 3.0f, 4.0f }, { 1.0, 5.0f, 6.0f } };
+    const uxx::strided_points points { &samples[0].x, &samples[0].y, samples.size(), sizeof(sample) };
+
+    const auto first = uxx::detail::gather_path(draw_list, points);
+    draw_list.PathClear();
+    const auto second = uxx::detail::gather_path(draw_list, points);
+
+    REQUIRE(second.size() == 3);
+    REQUIRE(second[2].x == 5.0f);
+    REQUIRE(second[2].y == 6.0f);
+    // The buffer is reused
+    REQUIRE(first.data() == second.data());
+}
@@ -0,0 +1,83 @@
+#include "test.hpp"
+#include "common.hpp"
+#include "uxx/uxx.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <regex>
+#include <string>
+
+namespace {
+
+std::string read_file(const std::filesystem::path& path)
+{
+    std::ifstream in { path };
+    return { std::istreambuf_iterator<char> { in }, std::istreambuf_iterator<char> {} };
+}
+
+}
+
+TEST_CASE("Trace scopes are written as Chrome trace events", "[trace]")
+{
+    const auto path = std::filesystem::temp_directory_path() / "uxx_trace_test.json";
+
+    uxx::trace_scope::start(path);
+    REQUIRE(uxx::trace_scope::is_enabled());
+    {
+        const uxx::trace_scope outer { "outer" };
+        const uxx::trace_scope inner { "inner \"quoted\"" };
+    }
+    uxx::trace_scope::stop();
+    REQUIRE_FALSE(uxx::trace_scope::is_enabled());
+
+    const auto json = read_file(path);
+    REQUIRE(json.find("\"traceEvents\"") != std::string::npos);
+    REQUIRE(json.find("\"name\":\"outer\"") != std::string::npos);
+    REQUIRE(json.find("\"name\":\"inner \\\"quoted\\\"\"") != std::string::npos);
+    REQUIRE(json.find("\"ph\":\"X\"") != std::string::npos);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Trace timestamps are written with sub-microsecond resolution and without an exponent", "[trace]")
+{
+    const auto path = std::filesystem::temp_directory_path() / "uxx_trace_resolution_test.json";
+
+    uxx::trace_scope::start(path);
+    {
+        const uxx::trace_scope scope { "short" };
+    }
+    uxx::trace_scope::stop();
+
+    const auto json = read_file(path);
+    const std::regex time_field { R"re("(ts|dur)":([^,}]*))re" };
+    const std::regex fixed_microseconds { R"re(\d+\.\d{3})re" };
+    int field_count = 0;
+
+    for (auto it = std::sregex_iterator { json.begin(), json.end(), time_field }; it != std::sregex_iterator {}; ++it) {
+        INFO((*it)[0].str());
+        REQUIRE(std::regex_match((*it)[2].str(), fixed_microseconds));
+        ++field_count;
+    }
+    REQUIRE(field_count == 2);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Trace scopes are not recorded when tracing is disabled", "[trace]")
+{
+    const auto path = std::filesystem::temp_directory_path() / "uxx_trace_disabled_test.json";
+    {
+        const uxx::trace_scope before { "before" };
+    }
+    uxx::trace_scope::start(path);
+    uxx::trace_scope::stop();
+
+    const auto json = read_file(path);
+    REQUIRE(json.find("before") == std::string::npos);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Stopping without a running trace does nothing", "[trace]")
+{
+    REQUIRE_FALSE(uxx::trace_scope::is_enabled());
+    REQUIRE_NOTHROW(uxx::trace_scope::stop());
+}